@@ -0,0 +1,151 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nodi.h"
+
+/* Compares polled and interrupt driven completion of short SPIM transfers.
+ * Results are kept in cycles_polled and cycles_irq arrays. Inspect them with debugger.
+ * Connect MOSI with MISO to get loopback.
+ */
+
+#define BENCH_SIZES_COUNT   8
+#define BENCH_REPEATS       16
+
+static const uint32_t bench_sizes[BENCH_SIZES_COUNT] = {1, 2, 4, 8, 16, 32, 64, 128};
+
+volatile uint32_t cycles_polled[BENCH_SIZES_COUNT];
+volatile uint32_t cycles_irq[BENCH_SIZES_COUNT];
+
+volatile static bool is_started = false;
+volatile static bool data_sent = false;
+
+static uint8_t tx_buf[128];
+static uint8_t rx_buf[128];
+
+void hfclk_handler(nodi_pwr_clk_drv_t *p_pwr_clk_drv)
+{
+    (void)(p_pwr_clk_drv);
+    is_started = true;
+}
+
+void irq_routine(nodi_spim_drv_t *p_spim_drv)
+{
+    (void)(p_spim_drv);
+    data_sent = true;
+}
+
+nodi_spim_config_s cfg = {
+    .bit_order = NODI_SPIM_BIT_ORDER_MSB_FIRST,
+    .end_cb = irq_routine,
+    .frequency = NODI_SPIM_FREQ_8M,
+    .mode = NODI_SPIM_MODE_0,
+    .orc = 0x00,
+    .cs_pin = NODI_GPIO_PIN(NODI_GPIO_P0, 3),
+    .miso_pin = NODI_GPIO_PIN(NODI_GPIO_P0, 4),
+    .mosi_pin = NODI_GPIO_PIN(NODI_GPIO_P0, 28),
+    .sck_pin = NODI_GPIO_PIN(NODI_GPIO_P0, 29),
+};
+
+void pin_config(void)
+{
+    nodi_gpio_clr(NODI_GPIO_P0, cfg.sck_pin.pin);
+    nodi_gpio_config(cfg.sck_pin.p_port, cfg.sck_pin.pin, NODI_GPIO_CFG_SPI_SCK);
+    nodi_gpio_config(cfg.mosi_pin.p_port, cfg.mosi_pin.pin, NODI_GPIO_CFG_SPI_MOSI);
+    nodi_gpio_config(cfg.miso_pin.p_port, cfg.miso_pin.pin, NODI_GPIO_CFG_SPI_MISO);
+
+    nodi_gpio_set(cfg.cs_pin.p_port, cfg.cs_pin.pin);
+    nodi_gpio_config(cfg.cs_pin.p_port, cfg.cs_pin.pin, NODI_GPIO_CFG_SPI_CS);
+}
+
+void cycle_counter_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+uint32_t bench_polled(uint32_t n)
+{
+    uint32_t start = DWT->CYCCNT;
+    nodi_spim_exchange_polled(&NODI_SPIM0, n, tx_buf, n, rx_buf);
+    return DWT->CYCCNT - start;
+}
+
+uint32_t bench_irq(uint32_t n)
+{
+    uint32_t start = DWT->CYCCNT;
+    data_sent = false;
+    nodi_spim_exchange(&NODI_SPIM0, n, tx_buf, n, rx_buf);
+    while (!data_sent);
+    return DWT->CYCCNT - start;
+}
+
+int main(void)
+{
+    uint32_t i, j;
+
+    for (i = 0; i < sizeof(tx_buf); ++i)
+    {
+        tx_buf[i] = (uint8_t)i;
+    }
+
+    /* Configure nodi subsystem */
+    nodi_init();
+
+    /* HFXO gives stable clock for both CPU and SPIM. */
+    NODI_PWR_CLK.hfclk_cb = hfclk_handler;
+    nodi_pwr_clk_init(&NODI_PWR_CLK);
+    nodi_clk_hfclk_start(&NODI_PWR_CLK);
+    while (!is_started);
+
+    NODI_SPIM0.config = &cfg;
+
+    pin_config();
+    cycle_counter_init();
+
+    nodi_spim_init(&NODI_SPIM0);
+    nodi_spim_select(&NODI_SPIM0);
+
+    for (i = 0; i < BENCH_SIZES_COUNT; ++i)
+    {
+        uint32_t sum_polled = 0;
+        uint32_t sum_irq = 0;
+        for (j = 0; j < BENCH_REPEATS; ++j)
+        {
+            sum_polled += bench_polled(bench_sizes[i]);
+            sum_irq += bench_irq(bench_sizes[i]);
+        }
+        cycles_polled[i] = sum_polled / BENCH_REPEATS;
+        cycles_irq[i] = sum_irq / BENCH_REPEATS;
+    }
+
+    nodi_spim_unselect(&NODI_SPIM0);
+    nodi_spim_deinit(&NODI_SPIM0);
+
+    while (1)
+    {
+    }
+}
@@ -61,3 +61,69 @@ uint32_t nodi_gpio_translate_periph(nodi_gpio_pin_t const *p_pin)
     /* In case of troubles set pin as unused. */
     return 0xFFFFFFFF;
 }
+
+void nodi_gpio_sense_set(nodi_gpio_pin_t const *p_pin, uint32_t sense)
+{
+    NODI_DRV_CHECK(p_pin != NULL, "GPIO port is NULL!");
+    NODI_DRV_CHECK(p_pin->pin < 32, "GPIO pin > 32!");
+
+    uint32_t config = p_pin->p_port->PIN_CNF[p_pin->pin] & ~GPIO_PIN_CNF_SENSE_Msk;
+
+    p_pin->p_port->PIN_CNF[p_pin->pin] = config |
+            ((sense << GPIO_PIN_CNF_SENSE_Pos) & GPIO_PIN_CNF_SENSE_Msk);
+}
+
+#define NODI_GPIOTE_CH_COUNT (sizeof(NRF_GPIOTE->CONFIG) / sizeof(NRF_GPIOTE->CONFIG[0]))
+
+void nodi_gpiote_task_config(uint32_t ch, nodi_gpio_pin_t const *p_pin, uint32_t init_high)
+{
+    NODI_DRV_CHECK(ch < NODI_GPIOTE_CH_COUNT, "GPIOTE channel does not exist!");
+    /* PSEL and PORT fields are placed like in peripherals' PSEL registers. */
+    NRF_GPIOTE->CONFIG[ch] =
+            (GPIOTE_CONFIG_MODE_Task << GPIOTE_CONFIG_MODE_Pos) |
+            ((nodi_gpio_translate_periph(p_pin) << GPIOTE_CONFIG_PSEL_Pos) &
+             (GPIOTE_CONFIG_PSEL_Msk | GPIOTE_CONFIG_PORT_Msk)) |
+            (GPIOTE_CONFIG_POLARITY_Toggle << GPIOTE_CONFIG_POLARITY_Pos) |
+            ((init_high ? GPIOTE_CONFIG_OUTINIT_High : GPIOTE_CONFIG_OUTINIT_Low)
+                    << GPIOTE_CONFIG_OUTINIT_Pos);
+}
+
+void nodi_gpiote_event_config(uint32_t ch, nodi_gpio_pin_t const *p_pin, uint32_t polarity)
+{
+    NODI_DRV_CHECK(ch < NODI_GPIOTE_CH_COUNT, "GPIOTE channel does not exist!");
+    NRF_GPIOTE->EVENTS_IN[ch] = 0;
+    NRF_GPIOTE->CONFIG[ch] =
+            (GPIOTE_CONFIG_MODE_Event << GPIOTE_CONFIG_MODE_Pos) |
+            ((nodi_gpio_translate_periph(p_pin) << GPIOTE_CONFIG_PSEL_Pos) &
+             (GPIOTE_CONFIG_PSEL_Msk | GPIOTE_CONFIG_PORT_Msk)) |
+            ((polarity << GPIOTE_CONFIG_POLARITY_Pos) & GPIOTE_CONFIG_POLARITY_Msk);
+}
+
+void nodi_gpiote_channel_disable(uint32_t ch)
+{
+    NODI_DRV_CHECK(ch < NODI_GPIOTE_CH_COUNT, "GPIOTE channel does not exist!");
+    NRF_GPIOTE->CONFIG[ch] = GPIOTE_CONFIG_MODE_Disabled << GPIOTE_CONFIG_MODE_Pos;
+}
+
+uint32_t nodi_gpiote_set_task_addr_get(uint32_t ch)
+{
+    NODI_DRV_CHECK(ch < NODI_GPIOTE_CH_COUNT, "GPIOTE channel does not exist!");
+    return (uint32_t)&NRF_GPIOTE->TASKS_SET[ch];
+}
+
+uint32_t nodi_gpiote_clr_task_addr_get(uint32_t ch)
+{
+    NODI_DRV_CHECK(ch < NODI_GPIOTE_CH_COUNT, "GPIOTE channel does not exist!");
+    return (uint32_t)&NRF_GPIOTE->TASKS_CLR[ch];
+}
+
+uint32_t nodi_gpiote_event_addr_get(uint32_t ch)
+{
+    NODI_DRV_CHECK(ch < NODI_GPIOTE_CH_COUNT, "GPIOTE channel does not exist!");
+    return (uint32_t)&NRF_GPIOTE->EVENTS_IN[ch];
+}
+
+uint32_t nodi_gpiote_port_event_addr_get(void)
+{
+    return (uint32_t)&NRF_GPIOTE->EVENTS_PORT;
+}
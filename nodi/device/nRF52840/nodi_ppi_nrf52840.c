@@ -0,0 +1,73 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "nodi_common.h"
+#include "nodi_ppi.h"
+
+#define NODI_PPI_CH_COUNT     (sizeof(NRF_PPI->CH) / sizeof(NRF_PPI->CH[0]))
+#define NODI_PPI_FORK_COUNT   (sizeof(NRF_PPI->FORK) / sizeof(NRF_PPI->FORK[0]))
+#define NODI_PPI_GROUP_COUNT  (sizeof(NRF_PPI->CHG) / sizeof(NRF_PPI->CHG[0]))
+
+void nodi_ppi_channel_assign(uint32_t ch, uint32_t evt_addr, uint32_t task_addr)
+{
+    NODI_DRV_CHECK(ch < NODI_PPI_CH_COUNT, "PPI channel is not configurable!");
+    NRF_PPI->CH[ch].EEP = evt_addr;
+    NRF_PPI->CH[ch].TEP = task_addr;
+    /* Channel can keep fork from previous user. */
+    NRF_PPI->FORK[ch].TEP = 0;
+}
+
+void nodi_ppi_channel_fork_assign(uint32_t ch, uint32_t task_addr)
+{
+    NODI_DRV_CHECK(ch < NODI_PPI_FORK_COUNT, "PPI channel has no fork!");
+    NRF_PPI->FORK[ch].TEP = task_addr;
+}
+
+void nodi_ppi_channels_enable(uint32_t ch_mask)
+{
+    NRF_PPI->CHENSET = ch_mask;
+}
+
+void nodi_ppi_channels_disable(uint32_t ch_mask)
+{
+    NRF_PPI->CHENCLR = ch_mask;
+}
+
+void nodi_ppi_group_assign(uint32_t group, uint32_t ch_mask)
+{
+    NODI_DRV_CHECK(group < NODI_PPI_GROUP_COUNT, "PPI group does not exist!");
+    NRF_PPI->CHG[group] = ch_mask;
+}
+
+uint32_t nodi_ppi_group_enable_task_addr_get(uint32_t group)
+{
+    NODI_DRV_CHECK(group < NODI_PPI_GROUP_COUNT, "PPI group does not exist!");
+    return (uint32_t)&NRF_PPI->TASKS_CHG[group].EN;
+}
+
+uint32_t nodi_ppi_group_disable_task_addr_get(uint32_t group)
+{
+    NODI_DRV_CHECK(group < NODI_PPI_GROUP_COUNT, "PPI group does not exist!");
+    return (uint32_t)&NRF_PPI->TASKS_CHG[group].DIS;
+}
@@ -965,7 +965,10 @@ typedef struct {                                    /*!< SPIM Structure
   __IO uint32_t  CONFIG;                            /*!< Configuration register                                                */
   __I  uint32_t  RESERVED14[2];
   SPIM_IFTIMING_Type IFTIMING;                      /*!< Unspecified                                                           */
-  __I  uint32_t  RESERVED15[22];
+  __IO uint32_t  CSNPOL;                            /*!< Polarity of CSN output                                                */
+  __IO uint32_t  PSELDCX;                           /*!< Pin select for DCX signal                                             */
+  __IO uint32_t  DCXCNT;                            /*!< DCX configuration                                                     */
+  __I  uint32_t  RESERVED15[19];
   __IO uint32_t  ORC;                               /*!< Byte transmitted after TXD.MAXCNT bytes have been transmitted
                                                          in the case when RXD.MAXCNT is greater than TXD.MAXCNT                */
 } NRF_SPIM_Type;
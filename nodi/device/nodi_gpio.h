@@ -42,4 +42,26 @@ void nodi_gpio_clr(nodi_gpio_t *p_nodi_gpio, uint32_t pin);
 
 uint32_t nodi_gpio_translate_periph(nodi_gpio_pin_t const *p_pin);
 
+/* Changes only SENSE field of pin configuration, sense is one of NODI_GPIO_SENSE_* values. */
+void nodi_gpio_sense_set(nodi_gpio_pin_t const *p_pin, uint32_t sense);
+
+/* GPIOTE - pins driven by tasks and generating events, used together with PPI. */
+
+void nodi_gpiote_task_config(uint32_t ch, nodi_gpio_pin_t const *p_pin, uint32_t init_high);
+
+void nodi_gpiote_channel_disable(uint32_t ch);
+
+uint32_t nodi_gpiote_set_task_addr_get(uint32_t ch);
+
+uint32_t nodi_gpiote_clr_task_addr_get(uint32_t ch);
+
+/* Polarity is one of GPIOTE_CONFIG_POLARITY_* values. */
+void nodi_gpiote_event_config(uint32_t ch, nodi_gpio_pin_t const *p_pin, uint32_t polarity);
+
+uint32_t nodi_gpiote_event_addr_get(uint32_t ch);
+
+/* PORT event is generated by DETECT signal shared by all pins with SENSE enabled. It works
+ * without high frequency clock, unlike IN channels. */
+uint32_t nodi_gpiote_port_event_addr_get(void);
+
 #endif // NODI_GPIO_H
@@ -3,9 +3,18 @@ NODI_SRC_FILES += \
   $(NODI_ROOT)/device/nRF52840/gcc/gcc_startup_nrf52840.S\
   $(NODI_ROOT)/device/nRF52840/nodi_gpio_nrf52840.c \
   $(NODI_ROOT)/device/nRF52840/nodi_mnd_nrf52840.c \
+  $(NODI_ROOT)/device/nRF52840/nodi_ppi_nrf52840.c \
   $(NODI_ROOT)/device/nRF52840/system_nrf52840.c \
+  $(NODI_ROOT)/drivers/at/nodi_at.c \
+  $(NODI_ROOT)/drivers/bridge/nodi_bridge.c \
+  $(NODI_ROOT)/drivers/display/nodi_display.c \
+  $(NODI_ROOT)/drivers/display/nodi_display_tiles.c \
+  $(NODI_ROOT)/drivers/frame/nodi_frame.c \
+  $(NODI_ROOT)/drivers/log/nodi_log.c \
   $(NODI_ROOT)/drivers/pwr_clk/nodi_pwr_clk.c \
+  $(NODI_ROOT)/drivers/regmap/nodi_regmap.c \
   $(NODI_ROOT)/drivers/rtc/nodi_rtc.c \
+  $(NODI_ROOT)/drivers/spi_nor/nodi_spi_nor.c \
   $(NODI_ROOT)/drivers/spim/nodi_spim.c \
   $(NODI_ROOT)/drivers/uarte/nodi_uarte.c
 
@@ -13,8 +22,15 @@ NODI_SRC_FILES += \
 # Include folders common to nrf52840
 NODI_INC_FOLDERS += \
   $(NODI_ROOT)/device/nRF52840 \
+  $(NODI_ROOT)/drivers/at \
+  $(NODI_ROOT)/drivers/bridge \
+  $(NODI_ROOT)/drivers/display \
+  $(NODI_ROOT)/drivers/frame \
+  $(NODI_ROOT)/drivers/log \
   $(NODI_ROOT)/drivers/pwr_clk \
+  $(NODI_ROOT)/drivers/regmap \
   $(NODI_ROOT)/drivers/rtc \
+  $(NODI_ROOT)/drivers/spi_nor \
   $(NODI_ROOT)/drivers/spim \
   $(NODI_ROOT)/drivers/uarte
 
@@ -0,0 +1,48 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NODI_PPI_H
+#define NODI_PPI_H
+
+#include "nodi_device.h"
+
+/* Programmable Peripheral Interconnect - API */
+
+#define NODI_PPI_CH_MSK(ch) (1UL << (ch))
+
+void nodi_ppi_channel_assign(uint32_t ch, uint32_t evt_addr, uint32_t task_addr);
+
+void nodi_ppi_channel_fork_assign(uint32_t ch, uint32_t task_addr);
+
+void nodi_ppi_channels_enable(uint32_t ch_mask);
+
+void nodi_ppi_channels_disable(uint32_t ch_mask);
+
+void nodi_ppi_group_assign(uint32_t group, uint32_t ch_mask);
+
+uint32_t nodi_ppi_group_enable_task_addr_get(uint32_t group);
+
+uint32_t nodi_ppi_group_disable_task_addr_get(uint32_t group);
+
+#endif // NODI_PPI_H
@@ -0,0 +1,355 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include "nodi_common.h"
+#include "nodi_at.h"
+
+#if ((NODI_AT_ENABLED == 1) && (NODI_UARTE_ENABLED == 1)) || defined(__DOXYGEN__)
+
+static inline nodi_uarte_rx_ring_s *nodi_at_ring(nodi_at_t *p_at)
+{
+    return p_at->config->p_uarte_drv->p_rx_ring;
+}
+
+static uint8_t nodi_at_slice_byte(const nodi_at_slice_s *p_slice, uint32_t pos)
+{
+    uint32_t i = 0;
+
+    while (pos >= p_slice->part_len[i])
+    {
+        pos -= p_slice->part_len[i];
+        i++;
+    }
+    return p_slice->p_part[i][pos];
+}
+
+/* Gives back ring blocks preceding the oldest line still in use. Process and release
+ * can run at different priorities, so the same block cannot be released twice. */
+static void nodi_at_ring_trim(nodi_at_t *p_at)
+{
+    nodi_uarte_rx_ring_s *p_ring = nodi_at_ring(p_at);
+    uint32_t primask = nodi_common_critical_enter();
+    uint32_t limit;
+
+    if (p_at->line_count != 0)
+    {
+        limit = p_at->lines[p_at->line_head].blk;
+    }
+    else if (p_at->in_line && !p_at->drop)
+    {
+        limit = p_at->cur.blk;
+    }
+    else
+    {
+        limit = p_at->scan_blk;
+    }
+
+    while ((int32_t)(limit - p_ring->rd) > 0)
+    {
+        nodi_uarte_rx_ring_release(p_at->config->p_uarte_drv);
+    }
+
+    nodi_common_critical_exit(primask);
+}
+
+static void nodi_at_line_end(nodi_at_t *p_at)
+{
+    nodi_at_line_s *p_cur = &p_at->cur;
+    nodi_at_slice_s *p_text = &p_cur->text;
+    int32_t best = NODI_AT_ID_NONE;
+    uint32_t i;
+
+    p_at->in_line = false;
+
+    if (p_at->drop)
+    {
+        p_at->dropped++;
+        return;
+    }
+
+    /* Parts added at block boundary can be empty. CR of CRLF is not a part of line. */
+    while ((p_text->part_count > 1) && (p_text->part_len[p_text->part_count - 1] == 0))
+    {
+        p_text->part_count--;
+    }
+    if ((p_text->len != 0) && (nodi_at_slice_byte(p_text, p_text->len - 1) == '\r'))
+    {
+        p_text->len--;
+        p_text->part_len[p_text->part_count - 1]--;
+    }
+
+    if (p_text->len == 0)
+    {
+        return;
+    }
+
+    for (i = 0; i < p_at->config->prefix_count; i++)
+    {
+        if ((p_at->cand & (1UL << i)) && (p_at->prefix_len[i] <= p_text->len) &&
+            ((best == NODI_AT_ID_NONE) || (p_at->prefix_len[i] > p_at->prefix_len[best])))
+        {
+            best = i;
+        }
+    }
+    p_cur->id = (int8_t)best;
+    p_cur->prefix_len = (best == NODI_AT_ID_NONE) ? 0 : p_at->prefix_len[best];
+
+    uint32_t primask = nodi_common_critical_enter();
+    nodi_at_line_s *p_line = &p_at->lines[(p_at->line_head + p_at->line_count) % NODI_AT_PENDING_MAX];
+    *p_line = *p_cur;
+    p_at->line_count++;
+    nodi_common_critical_exit(primask);
+
+    if (p_at->config->line_cb)
+    {
+        p_at->config->line_cb(p_at, p_line);
+    }
+}
+
+void nodi_at_init(nodi_at_t *p_at, const nodi_at_config_s *p_config)
+{
+    NODI_DRV_CHECK(p_at != NULL, "Parser pointer is NULL!");
+    NODI_DRV_CHECK(p_config != NULL, "Config pointer is NULL!");
+    NODI_DRV_CHECK(p_config->p_uarte_drv->p_rx_ring != NULL, "Continuous receive not started!");
+    NODI_DRV_CHECK(p_config->prefix_count <= NODI_AT_PREFIX_MAX, "Too many prefixes!");
+    NODI_DRV_CHECK(p_config->p_uarte_drv->p_rx_ring->block_count >= NODI_AT_PARTS_MAX + 2,
+                  "Ring too short for the longest line!");
+
+    uint32_t i;
+
+    p_at->config = p_config;
+    for (i = 0; i < p_config->prefix_count; i++)
+    {
+        p_at->prefix_len[i] = (uint8_t)strlen(p_config->pp_prefixes[i]);
+    }
+
+    p_at->line_head = 0;
+    p_at->line_count = 0;
+    p_at->in_line = false;
+    p_at->drop = false;
+    p_at->scan_blk = p_config->p_uarte_drv->p_rx_ring->rd;
+    p_at->scan_off = 0;
+    p_at->dropped = 0;
+}
+
+void nodi_at_process(nodi_at_t *p_at)
+{
+    NODI_DRV_CHECK(p_at != NULL, "Parser pointer is NULL!");
+
+    nodi_uarte_rx_ring_s *p_ring = nodi_at_ring(p_at);
+    nodi_at_slice_s *p_text = &p_at->cur.text;
+    uint32_t all = (p_at->config->prefix_count == 32) ? 0xFFFFFFFF :
+                   ((1UL << p_at->config->prefix_count) - 1);
+    const uint8_t *p_blk;
+    uint32_t amount;
+
+    while ((p_at->line_count < NODI_AT_PENDING_MAX) &&
+           nodi_uarte_rx_ring_peek(p_ring, p_at->scan_blk, &p_blk, &amount))
+    {
+        while ((p_at->scan_off < amount) && (p_at->line_count < NODI_AT_PENDING_MAX))
+        {
+            uint8_t byte = p_blk[p_at->scan_off++];
+
+            if (byte == '\n')
+            {
+                if (p_at->in_line)
+                {
+                    nodi_at_line_end(p_at);
+                }
+                continue;
+            }
+
+            if (!p_at->in_line)
+            {
+                if (byte == '\r')
+                {
+                    continue;
+                }
+                p_at->in_line = true;
+                p_at->drop = false;
+                p_at->cand = all;
+                p_at->cur.blk = p_at->scan_blk;
+                p_text->p_part[0] = &p_blk[p_at->scan_off - 1];
+                p_text->part_len[0] = 0;
+                p_text->part_count = 1;
+                p_text->len = 0;
+            }
+
+            if (p_at->drop)
+            {
+                continue;
+            }
+
+            /* Prefixes are matched while bytes are scanned. */
+            uint32_t pos = p_text->len;
+            uint32_t mask = p_at->cand;
+            uint32_t i;
+            for (i = 0; mask != 0; i++, mask >>= 1)
+            {
+                if ((mask & 1) && (pos < p_at->prefix_len[i]) &&
+                    ((uint8_t)p_at->config->pp_prefixes[i][pos] != byte))
+                {
+                    p_at->cand &= ~(1UL << i);
+                }
+            }
+
+            p_text->part_len[p_text->part_count - 1]++;
+            p_text->len++;
+        }
+
+        if (p_at->scan_off < amount)
+        {
+            break;
+        }
+
+        /* Line continues in the next block. Ring stops committing blocks when it is full,
+         * so a line holding it would never see its terminator. */
+        p_at->scan_blk++;
+        p_at->scan_off = 0;
+        if (p_at->in_line && !p_at->drop)
+        {
+            if ((p_text->part_count == NODI_AT_PARTS_MAX) ||
+                (nodi_uarte_rx_ring_space(p_ring, p_at->scan_blk) <= 1))
+            {
+                p_at->drop = true;
+            }
+            else
+            {
+                p_text->p_part[p_text->part_count] = nodi_uarte_rx_ring_block(p_ring, p_at->scan_blk);
+                p_text->part_len[p_text->part_count] = 0;
+                p_text->part_count++;
+            }
+        }
+
+        nodi_at_ring_trim(p_at);
+    }
+}
+
+void nodi_at_release(nodi_at_t *p_at)
+{
+    NODI_DRV_CHECK(p_at != NULL, "Parser pointer is NULL!");
+    NODI_DRV_CHECK(p_at->line_count != 0, "No line to release!");
+
+    uint32_t primask = nodi_common_critical_enter();
+    p_at->line_head = (p_at->line_head + 1) % NODI_AT_PENDING_MAX;
+    p_at->line_count--;
+    nodi_at_ring_trim(p_at);
+    nodi_common_critical_exit(primask);
+}
+
+/* Fills p_sub with n bytes of p_slice starting at pos. */
+static void nodi_at_slice_sub(const nodi_at_slice_s *p_slice, uint32_t pos, uint32_t n,
+                              nodi_at_slice_s *p_sub)
+{
+    uint32_t i = 0;
+
+    while ((i < p_slice->part_count) && (pos >= p_slice->part_len[i]))
+    {
+        pos -= p_slice->part_len[i];
+        i++;
+    }
+
+    p_sub->part_count = 0;
+    p_sub->len = n;
+    while (n != 0)
+    {
+        uint32_t take = p_slice->part_len[i] - pos;
+        take = take < n ? take : n;
+        p_sub->p_part[p_sub->part_count] = p_slice->p_part[i] + pos;
+        p_sub->part_len[p_sub->part_count] = take;
+        p_sub->part_count++;
+        n -= take;
+        pos = 0;
+        i++;
+    }
+}
+
+bool nodi_at_token_next(const nodi_at_line_s *p_line, uint32_t *p_pos, nodi_at_slice_s *p_tok)
+{
+    NODI_DRV_CHECK(p_line != NULL, "Line pointer is NULL!");
+    NODI_DRV_CHECK((p_pos != NULL) && (p_tok != NULL), "Output pointer is NULL!");
+
+    const nodi_at_slice_s *p_text = &p_line->text;
+    uint32_t pos = *p_pos;
+    uint32_t start;
+    uint32_t end;
+    bool quoted = false;
+
+    if (pos > p_text->len)
+    {
+        return false;
+    }
+
+    while ((pos < p_text->len) && (nodi_at_slice_byte(p_text, pos) == ' '))
+    {
+        pos++;
+    }
+
+    /* Commas inside quoted strings do not split tokens. */
+    start = pos;
+    while (pos < p_text->len)
+    {
+        uint8_t byte = nodi_at_slice_byte(p_text, pos);
+        if ((byte == ',') && !quoted)
+        {
+            break;
+        }
+        quoted ^= (byte == '"');
+        pos++;
+    }
+    end = pos;
+
+    if ((end - start >= 2) && (nodi_at_slice_byte(p_text, start) == '"') &&
+        (nodi_at_slice_byte(p_text, end - 1) == '"'))
+    {
+        start++;
+        end--;
+    }
+
+    nodi_at_slice_sub(p_text, start, end - start, p_tok);
+    *p_pos = pos + 1;
+    return true;
+}
+
+uint32_t nodi_at_slice_u32(const nodi_at_slice_s *p_tok)
+{
+    NODI_DRV_CHECK(p_tok != NULL, "Token pointer is NULL!");
+
+    uint32_t val = 0;
+    uint32_t i;
+
+    for (i = 0; i < p_tok->len; i++)
+    {
+        uint8_t byte = nodi_at_slice_byte(p_tok, i);
+        if ((byte < '0') || (byte > '9'))
+        {
+            break;
+        }
+        val = val * 10 + (byte - '0');
+    }
+    return val;
+}
+
+#endif /* NODI_AT_ENABLED */
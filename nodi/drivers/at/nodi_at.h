@@ -0,0 +1,180 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NODI_AT_H
+#define NODI_AT_H
+
+#include "nodi_common.h"
+#include "nodi_uarte.h"
+
+#if ((NODI_AT_ENABLED == 1) && (NODI_UARTE_ENABLED == 1)) || defined(__DOXYGEN__)
+
+/**
+ * @brief Maximum number of receive ring blocks single line can span.
+ */
+#if !defined(NODI_AT_PARTS_MAX) || defined(__DOXYGEN__)
+#define NODI_AT_PARTS_MAX       4
+#endif
+
+/**
+ * @brief Maximum number of lines delivered and not released by application.
+ */
+#if !defined(NODI_AT_PENDING_MAX) || defined(__DOXYGEN__)
+#define NODI_AT_PENDING_MAX     4
+#endif
+
+/**
+ * @brief Maximum number of prefixes in prefix table.
+ */
+#define NODI_AT_PREFIX_MAX      32
+
+/**
+ * @brief Line ID of line not matching any prefix.
+ */
+#define NODI_AT_ID_NONE         (-1)
+
+/**
+ * @brief   Part of received data. Points directly to receive ring blocks.
+ */
+typedef struct {
+    const uint8_t            *p_part[NODI_AT_PARTS_MAX]; ///< Data parts, one per ring block.
+    uint16_t                  part_len[NODI_AT_PARTS_MAX]; ///< Length of every part.
+    uint8_t                   part_count; ///< Number of parts.
+    uint16_t                  len;        ///< Total length.
+} nodi_at_slice_s;
+
+/**
+ * @brief   Received line, CR and LF excluded.
+ */
+typedef struct {
+    nodi_at_slice_s           text;       ///< Line text.
+    int8_t                    id;         ///< Index of the longest matching prefix or NODI_AT_ID_NONE.
+    uint8_t                   prefix_len; ///< Length of matching prefix, first token starts here.
+    uint32_t                  blk;        ///< First ring block of line. Managed by parser.
+} nodi_at_line_s;
+
+typedef struct nodi_at nodi_at_t;
+
+/**
+ * @brief   Received line callback type.
+ *
+ * @param[in] p_at            pointer to the parser which received the line
+ * @param[in] p_line          received line, valid until released by nodi_at_release
+ */
+typedef void (*nodi_at_line_callback_t)(nodi_at_t *p_at, const nodi_at_line_s *p_line);
+
+/**
+ * @brief   Parser configuration.
+ */
+typedef struct {
+    nodi_uarte_drv_t         *p_uarte_drv; ///< UARTE driver running continuous receive.
+    const char * const       *pp_prefixes; ///< Response prefixes, e.g. "OK", "+CREG:".
+    uint8_t                   prefix_count; ///< Number of prefixes.
+    nodi_at_line_callback_t   line_cb;     ///< Received line callback.
+} nodi_at_config_s;
+
+/**
+ * @brief   Command line parser object, owned by application.
+ *
+ * @details Parser owns the read side of UARTE receive ring. Ring blocks are given
+ *          back to the driver when all lines pointing to them are released.
+ */
+struct nodi_at {
+    const nodi_at_config_s   *config;      ///< Parser configuration.
+    uint8_t                   prefix_len[NODI_AT_PREFIX_MAX]; ///< Prefix lengths, cached at init.
+    nodi_at_line_s            lines[NODI_AT_PENDING_MAX]; ///< Delivered lines.
+    uint8_t                   line_head;   ///< Oldest delivered line.
+    uint8_t                   line_count;  ///< Number of delivered lines.
+    nodi_at_line_s            cur;         ///< Line being received.
+    bool                      in_line;     ///< Line start was found.
+    bool                      drop;        ///< Line is too long, dropped at its end.
+    uint32_t                  cand;        ///< Prefixes still matching line being received.
+    uint32_t                  scan_blk;    ///< Ring block being scanned.
+    uint32_t                  scan_off;    ///< Scanned bytes of the block.
+    uint32_t                  dropped;     ///< Lines dropped because of their length.
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initializes parser. Continuous receive of the UARTE driver must be started.
+ *
+ * Ring needs at least NODI_AT_PARTS_MAX + 2 blocks: the longest line plus the blocks
+ * armed in UARTE.
+ *
+ * @param[in] p_at              Parser object.
+ * @param[in] p_config          Parser configuration.
+ */
+void nodi_at_init(nodi_at_t *p_at, const nodi_at_config_s *p_config);
+
+/**
+ * @brief Scans completed receive blocks and calls line callback for every complete line.
+ *
+ * Bytes are not copied. Prefix matching is done during scanning, so line is
+ * classified when its terminator is found. Call it from rx_end_cb or main loop, but
+ * from one context only. Line longer than NODI_AT_PARTS_MAX blocks, or one that would
+ * fill the ring, is dropped and counted.
+ *
+ * @param[in] p_at              Parser object.
+ */
+void nodi_at_process(nodi_at_t *p_at);
+
+/**
+ * @brief Releases the oldest delivered line and ring blocks used only by it.
+ *
+ * Can be called from other priority than nodi_at_process.
+ *
+ * @param[in] p_at              Parser object.
+ */
+void nodi_at_release(nodi_at_t *p_at);
+
+/**
+ * @brief Returns the next comma separated token of line, leading spaces and quotes stripped.
+ *
+ * @param[in]     p_line        Received line.
+ * @param[in,out] p_pos         Position in line, set to prefix_len before the first call.
+ * @param[out]    p_tok         Token, points to ring blocks like line.
+ *
+ * @return true if token was found, false at the end of line.
+ */
+bool nodi_at_token_next(const nodi_at_line_s *p_line, uint32_t *p_pos, nodi_at_slice_s *p_tok);
+
+/**
+ * @brief Converts decimal token to number.
+ *
+ * @param[in] p_tok             Token.
+ *
+ * @return Token value. Conversion stops at the first non-digit.
+ */
+uint32_t nodi_at_slice_u32(const nodi_at_slice_s *p_tok);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NODI_AT_ENABLED */
+
+#endif /* NODI_AT_H */
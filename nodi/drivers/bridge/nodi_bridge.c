@@ -0,0 +1,100 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "nodi_common.h"
+#include "nodi_bridge.h"
+
+#if ((NODI_BRIDGE_ENABLED == 1) && (NODI_UARTE_ENABLED == 1)) || defined(__DOXYGEN__)
+
+/* Transmission queue completes in order, so the finished block is the oldest one. */
+static void nodi_bridge_tx_done(nodi_uarte_drv_t *p_uarte_drv, nodi_uarte_tx_desc_t *p_desc)
+{
+    nodi_bridge_t *p_bridge = p_desc->p_context;
+
+    nodi_uarte_rx_ring_release(p_bridge->config->p_rx_drv);
+}
+
+void nodi_bridge_start(nodi_bridge_t *p_bridge, const nodi_bridge_config_s *p_config)
+{
+    NODI_DRV_CHECK(p_bridge != NULL, "Bridge pointer is NULL!");
+    NODI_DRV_CHECK(p_config != NULL, "Config pointer is NULL!");
+    NODI_DRV_CHECK(p_config->p_rx_drv != p_config->p_tx_drv, "Bridge to the same driver!");
+    NODI_DRV_CHECK((p_config->p_descs != NULL) && (p_config->p_segs != NULL),
+                  "Descriptor pointer is NULL!");
+
+    uint32_t i;
+
+    p_bridge->config = p_config;
+    p_bridge->fwd = 0;
+    p_bridge->stats.blocks = 0;
+    p_bridge->stats.bytes = 0;
+
+    for (i = 0; i < p_config->p_ring->block_count; i++)
+    {
+        p_config->p_descs[i].p_segs = &p_config->p_segs[i];
+        p_config->p_descs[i].seg_count = 1;
+        p_config->p_descs[i].tx_cb = nodi_bridge_tx_done;
+        p_config->p_descs[i].p_context = p_bridge;
+        p_config->p_segs[i].p_buf = nodi_uarte_rx_ring_block(p_config->p_ring, i);
+    }
+
+    nodi_uarte_rx_ring_start(p_config->p_rx_drv, p_config->p_ring);
+}
+
+void nodi_bridge_forward(nodi_bridge_t *p_bridge)
+{
+    NODI_DRV_CHECK(p_bridge != NULL, "Bridge pointer is NULL!");
+
+    nodi_uarte_rx_ring_s *p_ring = p_bridge->config->p_ring;
+    const uint8_t *p_data;
+    uint32_t amount;
+
+    /* Empty block after stop is queued too, it keeps release order. Segment already
+     * points to block memory. */
+    while (nodi_uarte_rx_ring_peek(p_ring, p_bridge->fwd, &p_data, &amount))
+    {
+        uint32_t idx = nodi_uarte_rx_ring_idx(p_ring, p_bridge->fwd);
+
+        p_bridge->config->p_segs[idx].len = amount;
+        p_bridge->fwd++;
+        p_bridge->stats.blocks++;
+        p_bridge->stats.bytes += amount;
+        nodi_uarte_tx_queue_push(p_bridge->config->p_tx_drv, &p_bridge->config->p_descs[idx]);
+    }
+}
+
+void nodi_bridge_stop(nodi_bridge_t *p_bridge)
+{
+    NODI_DRV_CHECK(p_bridge != NULL, "Bridge pointer is NULL!");
+
+    nodi_uarte_rx_ring_stop(p_bridge->config->p_rx_drv);
+}
+
+const nodi_bridge_stats_s *nodi_bridge_stats_get(nodi_bridge_t *p_bridge)
+{
+    NODI_DRV_CHECK(p_bridge != NULL, "Bridge pointer is NULL!");
+    return &p_bridge->stats;
+}
+
+#endif /* NODI_BRIDGE_ENABLED */
@@ -0,0 +1,110 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NODI_BRIDGE_H
+#define NODI_BRIDGE_H
+
+#include "nodi_common.h"
+#include "nodi_uarte.h"
+
+#if ((NODI_BRIDGE_ENABLED == 1) && (NODI_UARTE_ENABLED == 1)) || defined(__DOXYGEN__)
+
+/**
+ * @brief   Bridge direction configuration.
+ *
+ * @details Descriptor and gather list arrays have one entry per ring block. Receiving
+ *          driver's rx_end_cb must call nodi_bridge_forward().
+ */
+typedef struct {
+    nodi_uarte_drv_t         *p_rx_drv;    ///< Receiving UARTE driver.
+    nodi_uarte_drv_t         *p_tx_drv;    ///< Transmitting UARTE driver.
+    nodi_uarte_rx_ring_s     *p_ring;      ///< Receive ring of p_rx_drv.
+    nodi_uarte_tx_desc_t     *p_descs;     ///< Transmission descriptors, block_count entries.
+    nodi_uarte_seg_s         *p_segs;      ///< Gather list elements, block_count entries.
+} nodi_bridge_config_s;
+
+/**
+ * @brief   Bridge statistics.
+ */
+typedef struct {
+    uint32_t                  blocks;      ///< Blocks passed to transmitting driver.
+    uint32_t                  bytes;       ///< Bytes passed to transmitting driver.
+} nodi_bridge_stats_s;
+
+/**
+ * @brief   Bridge direction object, owned by application.
+ *
+ * @details Completed receive block is queued for transmission as it is and given
+ *          back to the ring after ENDTX. Two objects make bidirectional bridge.
+ */
+typedef struct {
+    const nodi_bridge_config_s *config;    ///< Bridge configuration.
+    uint32_t                  fwd;         ///< Ring blocks queued for transmission.
+    nodi_bridge_stats_s       stats;       ///< Bridge statistics.
+} nodi_bridge_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Starts continuous receive of p_rx_drv and forwarding to p_tx_drv.
+ *
+ * @param[in] p_bridge          Bridge object.
+ * @param[in] p_config          Bridge configuration.
+ */
+void nodi_bridge_start(nodi_bridge_t *p_bridge, const nodi_bridge_config_s *p_config);
+
+/**
+ * @brief Queues completed receive blocks for transmission. Call it from rx_end_cb.
+ *
+ * Data is not copied, every block costs one descriptor push.
+ *
+ * @param[in] p_bridge          Bridge object.
+ */
+void nodi_bridge_forward(nodi_bridge_t *p_bridge);
+
+/**
+ * @brief Stops receive. Blocks already received are still forwarded.
+ *
+ * @param[in] p_bridge          Bridge object.
+ */
+void nodi_bridge_stop(nodi_bridge_t *p_bridge);
+
+/**
+ * @brief Returns bridge statistics.
+ *
+ * @param[in] p_bridge          Bridge object.
+ *
+ * @return Pointer to statistics.
+ */
+const nodi_bridge_stats_s *nodi_bridge_stats_get(nodi_bridge_t *p_bridge);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NODI_BRIDGE_ENABLED */
+
+#endif /* NODI_BRIDGE_H */
@@ -30,6 +30,7 @@
 #include "nodi_conf.h"
 #include "nodi_device.h"
 #include "nodi_gpio.h"
+#include "nodi_ppi.h"
 
 #ifdef NODI_DEBUG
 #define NODI_DRV_CHECK(statement, fail_text)   nodi_common_assert(statement)
@@ -59,4 +60,17 @@ static inline void nodi_common_irq_disable(IRQn_Type IRQn)
     NVIC_DisableIRQ(IRQn);
 }
 
+/* Masks all maskable interrupts. Used to guard data shared between several priorities. */
+static inline uint32_t nodi_common_critical_enter(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    return primask;
+}
+
+static inline void nodi_common_critical_exit(uint32_t primask)
+{
+    __set_PRIMASK(primask);
+}
+
 #endif
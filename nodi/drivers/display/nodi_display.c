@@ -0,0 +1,217 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include "nodi_common.h"
+#include "nodi_display.h"
+
+#if ((NODI_DISPLAY_ENABLED == 1) && (NODI_SPIM_ENABLED == 1)) || defined(__DOXYGEN__)
+
+static void nodi_display_pix_cb(nodi_spim_drv_t *p_spim_drv, nodi_spim_xfer_desc_t *p_desc);
+
+static void nodi_display_desc_set(nodi_spim_xfer_desc_t *p_desc,
+                                  const void *p_txbuf,
+                                  uint32_t n_tx,
+                                  const nodi_gpio_pin_t *p_dc_pin,
+                                  bool cs_hold,
+                                  nodi_spim_xfer_callback_t xfer_cb)
+{
+    p_desc->p_txbuf = p_txbuf;
+    p_desc->n_tx = n_tx;
+    p_desc->p_rxbuf = NULL;
+    p_desc->n_rx = 0;
+    p_desc->tx_row = 0;
+    p_desc->cs_hold = cs_hold;
+    p_desc->preemptible = false;
+    p_desc->p_dc_pin = p_dc_pin;
+    p_desc->lane = NODI_SPIM_LANE_NORMAL;
+    p_desc->xfer_cb = xfer_cb;
+}
+
+static bool nodi_display_region_start(nodi_display_t *p_disp)
+{
+    const nodi_display_config_s *p_cfg = p_disp->config;
+    nodi_display_rect_s rect;
+    uint32_t primask;
+    uint32_t x_end, y_end;
+    bool found;
+
+    /* Application can invalidate from other priority. */
+    primask = nodi_common_critical_enter();
+    found = nodi_display_region_take(p_disp->tiles, p_disp->tile_cols, p_disp->tile_rows, &rect);
+    nodi_common_critical_exit(primask);
+
+    if (!found)
+    {
+        return false;
+    }
+
+    p_disp->reg_x = rect.x0 * NODI_DISPLAY_TILE_SIZE;
+    p_disp->reg_y = rect.y0 * NODI_DISPLAY_TILE_SIZE;
+    x_end = (rect.x1 + 1) * NODI_DISPLAY_TILE_SIZE;
+    y_end = (rect.y1 + 1) * NODI_DISPLAY_TILE_SIZE;
+    x_end = x_end > p_cfg->width ? p_cfg->width : x_end;
+    y_end = y_end > p_cfg->height ? p_cfg->height : y_end;
+    p_disp->reg_w = x_end - p_disp->reg_x;
+    p_disp->reg_h = y_end - p_disp->reg_y;
+    p_disp->stats.regions++;
+
+    p_disp->caset_buf[0] = (uint8_t)(p_disp->reg_x >> 8);
+    p_disp->caset_buf[1] = (uint8_t)(p_disp->reg_x);
+    p_disp->caset_buf[2] = (uint8_t)((x_end - 1) >> 8);
+    p_disp->caset_buf[3] = (uint8_t)(x_end - 1);
+    p_disp->raset_buf[0] = (uint8_t)(p_disp->reg_y >> 8);
+    p_disp->raset_buf[1] = (uint8_t)(p_disp->reg_y);
+    p_disp->raset_buf[2] = (uint8_t)((y_end - 1) >> 8);
+    p_disp->raset_buf[3] = (uint8_t)(y_end - 1);
+
+    /* Whole region is one transaction. Rows of full width region follow each other in
+     * framebuffer, rows of narrower one are width apart. */
+    uint32_t n = p_disp->reg_w * p_disp->reg_h * 2;
+    nodi_display_desc_set(&p_disp->desc_pix,
+                          (const uint8_t *)p_cfg->p_framebuf +
+                          (p_disp->reg_y * p_cfg->width + p_disp->reg_x) * 2,
+                          n, NULL, false, nodi_display_pix_cb);
+    if (p_disp->reg_w != p_cfg->width)
+    {
+        p_disp->desc_pix.tx_row = p_disp->reg_w * 2;
+        p_disp->desc_pix.tx_stride = p_cfg->width * 2;
+    }
+    p_disp->stats.bytes_sent += n;
+    p_disp->stats.last_flush_bytes += n;
+
+    /* Header holds CS, region is pushed at once, so window set and pixels are one frame
+     * other devices cannot break in. */
+    primask = nodi_common_critical_enter();
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        nodi_spim_bus_push(p_cfg->p_spim_drv, p_cfg->p_dev, &p_disp->desc_hdr[i]);
+    }
+    nodi_spim_bus_push(p_cfg->p_spim_drv, p_cfg->p_dev, &p_disp->desc_pix);
+    nodi_common_critical_exit(primask);
+    return true;
+}
+
+static void nodi_display_flush_finish(nodi_display_t *p_disp)
+{
+    p_disp->state = NODI_DISPLAY_STATE_READY;
+
+    /* Callback can start next flush. */
+    if (p_disp->config->flush_cb)
+    {
+        p_disp->config->flush_cb(p_disp);
+    }
+}
+
+static void nodi_display_pix_cb(nodi_spim_drv_t *p_spim_drv, nodi_spim_xfer_desc_t *p_desc)
+{
+    nodi_display_t *p_disp = (nodi_display_t *)p_desc->p_context;
+
+    if (!nodi_display_region_start(p_disp))
+    {
+        nodi_display_flush_finish(p_disp);
+    }
+}
+
+void nodi_display_init(nodi_display_t *p_disp, const nodi_display_config_s *p_config)
+{
+    NODI_DRV_CHECK(p_disp != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(p_config != NULL, "Config pointer is NULL!");
+    NODI_DRV_CHECK(p_config->p_spim_drv != NULL, "SPIM driver pointer is NULL!");
+    NODI_DRV_CHECK(p_config->p_dev != NULL, "Device pointer is NULL!");
+    NODI_DRV_CHECK(p_config->p_framebuf != NULL, "Framebuffer pointer is NULL!");
+    NODI_DRV_CHECK((p_config->width + NODI_DISPLAY_TILE_SIZE - 1) / NODI_DISPLAY_TILE_SIZE <= 32,
+                  "Panel too wide for tile bitmap!");
+    NODI_DRV_CHECK((p_config->height + NODI_DISPLAY_TILE_SIZE - 1) / NODI_DISPLAY_TILE_SIZE <=
+                   NODI_DISPLAY_TILE_ROWS_MAX, "Panel too high for tile bitmap!");
+
+    p_disp->config = p_config;
+    p_disp->tile_cols = (p_config->width + NODI_DISPLAY_TILE_SIZE - 1) / NODI_DISPLAY_TILE_SIZE;
+    p_disp->tile_rows = (p_config->height + NODI_DISPLAY_TILE_SIZE - 1) / NODI_DISPLAY_TILE_SIZE;
+    memset(&p_disp->stats, 0, sizeof(p_disp->stats));
+
+    p_disp->cmd_buf[0] = NODI_DISPLAY_CMD_CASET;
+    p_disp->cmd_buf[1] = NODI_DISPLAY_CMD_RASET;
+    p_disp->cmd_buf[2] = NODI_DISPLAY_CMD_RAMWR;
+
+    nodi_display_desc_set(&p_disp->desc_hdr[0], &p_disp->cmd_buf[0], 1, &p_config->dc_pin, true, NULL);
+    nodi_display_desc_set(&p_disp->desc_hdr[1], p_disp->caset_buf, 4, NULL, true, NULL);
+    nodi_display_desc_set(&p_disp->desc_hdr[2], &p_disp->cmd_buf[1], 1, &p_config->dc_pin, true, NULL);
+    nodi_display_desc_set(&p_disp->desc_hdr[3], p_disp->raset_buf, 4, NULL, true, NULL);
+    nodi_display_desc_set(&p_disp->desc_hdr[4], &p_disp->cmd_buf[2], 1, &p_config->dc_pin, true, NULL);
+
+    p_disp->desc_pix.p_context = p_disp;
+
+    /* Queue drives DC low for commands only, it idles at data level. */
+    nodi_gpio_set(p_config->dc_pin.p_port, p_config->dc_pin.pin);
+
+    /* Panel content is unknown. */
+    for (uint32_t y = 0; y < p_disp->tile_rows; y++)
+    {
+        p_disp->tiles[y] = NODI_DISPLAY_BITS(0, p_disp->tile_cols - 1);
+    }
+
+    p_disp->state = NODI_DISPLAY_STATE_READY;
+}
+
+void nodi_display_invalidate(nodi_display_t *p_disp, uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+    NODI_DRV_CHECK(p_disp != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK((w != 0) && (h != 0), "Empty area!");
+    NODI_DRV_CHECK((x + w <= p_disp->config->width) && (y + h <= p_disp->config->height),
+                  "Area out of panel!");
+
+    nodi_display_rect_s rect = {
+        .x0 = x / NODI_DISPLAY_TILE_SIZE,
+        .y0 = y / NODI_DISPLAY_TILE_SIZE,
+        .x1 = (x + w - 1) / NODI_DISPLAY_TILE_SIZE,
+        .y1 = (y + h - 1) / NODI_DISPLAY_TILE_SIZE,
+    };
+    uint32_t primask = nodi_common_critical_enter();
+    nodi_display_tiles_mark(p_disp->tiles, &rect);
+    nodi_common_critical_exit(primask);
+}
+
+void nodi_display_flush(nodi_display_t *p_disp)
+{
+    NODI_DRV_CHECK(p_disp != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(p_disp->state == NODI_DISPLAY_STATE_READY, "Pipeline is busy!");
+
+    p_disp->state = NODI_DISPLAY_STATE_BUSY;
+    p_disp->stats.flushes++;
+    p_disp->stats.last_flush_bytes = 0;
+
+    if (!nodi_display_region_start(p_disp))
+    {
+        nodi_display_flush_finish(p_disp);
+    }
+}
+
+const nodi_display_stats_s *nodi_display_stats_get(nodi_display_t *p_disp)
+{
+    NODI_DRV_CHECK(p_disp != NULL, "Driver pointer is NULL!");
+    return &p_disp->stats;
+}
+
+#endif
@@ -0,0 +1,154 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NODI_DISPLAY_H
+#define NODI_DISPLAY_H
+
+#include "nodi_common.h"
+#include "nodi_spim.h"
+#include "nodi_display_tiles.h"
+
+#if ((NODI_DISPLAY_ENABLED == 1) && (NODI_SPIM_ENABLED == 1)) || defined(__DOXYGEN__)
+
+/**
+ * @brief Panel commands (MIPI DCS).
+ */
+#define NODI_DISPLAY_CMD_CASET 0x2A
+#define NODI_DISPLAY_CMD_RASET 0x2B
+#define NODI_DISPLAY_CMD_RAMWR 0x2C
+
+typedef struct nodi_display nodi_display_t;
+
+/**
+ * @brief   Display flush complete callback type.
+ *
+ * @param[in] p_disp          Pointer to the nodi_display_t object triggering the callback.
+ */
+typedef void (*nodi_display_callback_t)(nodi_display_t *p_disp);
+
+typedef struct {
+    nodi_spim_drv_t          *p_spim_drv; ///< SPIM driver of the bus panel is connected to.
+    const nodi_spim_dev_s    *p_dev;      ///< Panel bus settings and CS pin.
+    nodi_gpio_pin_t           dc_pin;     ///< Data/command pin config structure, high is data.
+    const void               *p_framebuf; ///< RGB565 framebuffer in panel byte order.
+    uint16_t                  width;      ///< Panel width in pixels.
+    uint16_t                  height;     ///< Panel height in pixels.
+    nodi_display_callback_t   flush_cb;   ///< Flush complete callback or NULL.
+} nodi_display_config_s;
+
+/**
+ * @brief   Display pipeline possible states.
+ */
+typedef enum {
+    NODI_DISPLAY_STATE_UNINIT, ///< Pipeline is uninitialized.
+    NODI_DISPLAY_STATE_READY,  ///< Pipeline is ready to flush.
+    NODI_DISPLAY_STATE_BUSY,   ///< Pipeline is sending dirty regions.
+} nodi_display_state_t;
+
+/**
+ * @brief   Display pipeline counters.
+ */
+typedef struct {
+    uint32_t                  flushes;          ///< Started flushes.
+    uint32_t                  regions;          ///< Regions sent.
+    uint32_t                  bytes_sent;       ///< Pixel bytes sent.
+    uint32_t                  last_flush_bytes; ///< Pixel bytes sent by the last flush.
+} nodi_display_stats_s;
+
+/**
+ * @brief   Structure representing a display pipeline.
+ */
+struct nodi_display {
+    const nodi_display_config_s *config;    ///< Current configuration data.
+    volatile nodi_display_state_t state;    ///< Pipeline current state.
+    uint32_t                  tiles[NODI_DISPLAY_TILE_ROWS_MAX]; ///< Dirty tiles bitmap, row per word.
+    uint16_t                  tile_cols;    ///< Number of tile columns.
+    uint16_t                  tile_rows;    ///< Number of tile rows.
+    uint16_t                  reg_x;        ///< Region in progress, first column in pixels.
+    uint16_t                  reg_y;        ///< Region in progress, first row in pixels.
+    uint16_t                  reg_w;        ///< Region in progress, width in pixels.
+    uint16_t                  reg_h;        ///< Region in progress, height in pixels.
+    nodi_spim_xfer_desc_t     desc_hdr[5];  ///< Window set and memory write commands.
+    nodi_spim_xfer_desc_t     desc_pix;     ///< Pixel data of region, framebuffer rows strided.
+    uint8_t                   cmd_buf[3];   ///< CASET, RASET and RAMWR commands.
+    uint8_t                   caset_buf[4]; ///< Column window.
+    uint8_t                   raset_buf[4]; ///< Row window.
+    nodi_display_stats_s      stats;        ///< Pipeline counters.
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initializes display pipeline.
+ *
+ * SPIM driver has to be initialized and panel configured before. Whole panel is dirty.
+ *
+ * @param[in] p_disp            Pointer to structure representing display pipeline.
+ * @param[in] p_config          Pipeline configuration.
+ */
+void nodi_display_init(nodi_display_t *p_disp, const nodi_display_config_s *p_config);
+
+/**
+ * @brief Marks framebuffer area as changed.
+ *
+ * Can be called during flush, area is sent by the next flush if its region was taken.
+ *
+ * @param[in] p_disp            Pointer to structure representing display pipeline.
+ * @param[in] x                 First column in pixels.
+ * @param[in] y                 First row in pixels.
+ * @param[in] w                 Width in pixels.
+ * @param[in] h                 Height in pixels.
+ */
+void nodi_display_invalidate(nodi_display_t *p_disp, uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+
+/**
+ * @brief Sends dirty regions of framebuffer to panel.
+ *
+ * Every region is sent as one CS frame: window set commands and a single pixel data
+ * transaction queued in SPIM driver. Region of full panel width is contiguous in framebuffer,
+ * narrower one is sent as strided rows. Next region is pushed from interrupt routine.
+ * flush_cb is called at the end, before function returns if nothing is dirty.
+ *
+ * @param[in] p_disp            Pointer to structure representing display pipeline.
+ */
+void nodi_display_flush(nodi_display_t *p_disp);
+
+/**
+ * @brief Returns pipeline counters.
+ *
+ * @param[in] p_disp            Pointer to structure representing display pipeline.
+ *
+ * @return Pointer to counters.
+ */
+const nodi_display_stats_s *nodi_display_stats_get(nodi_display_t *p_disp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NODI_DISPLAY_ENABLED */
+
+#endif /* NODI_DISPLAY_H */
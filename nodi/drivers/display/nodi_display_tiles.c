@@ -0,0 +1,114 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "nodi_display_tiles.h"
+
+#if (NODI_DISPLAY_ENABLED == 1) || defined(__DOXYGEN__)
+
+void nodi_display_tiles_mark(uint32_t *p_tiles, const nodi_display_rect_s *p_rect)
+{
+    uint32_t mask = NODI_DISPLAY_BITS(p_rect->x0, p_rect->x1);
+
+    for (uint32_t y = p_rect->y0; y <= p_rect->y1; y++)
+    {
+        p_tiles[y] |= mask;
+    }
+}
+
+/* Finds the first dirty tile not before column from and extends it over gaps not
+ * longer than NODI_DISPLAY_MERGE_GAP. Returns false if row is clean there. */
+static bool nodi_display_span_get(uint32_t row, uint32_t from, uint32_t tile_cols,
+                                  uint32_t *p_x0, uint32_t *p_x1)
+{
+    uint32_t x = from;
+
+    while ((x < tile_cols) && !(row & (1UL << x)))
+    {
+        x++;
+    }
+    if (x == tile_cols)
+    {
+        return false;
+    }
+
+    *p_x0 = x;
+    *p_x1 = x;
+    for (x = x + 1; x < tile_cols; x++)
+    {
+        if (row & (1UL << x))
+        {
+            *p_x1 = x;
+        }
+        else if (x - *p_x1 > NODI_DISPLAY_MERGE_GAP)
+        {
+            break;
+        }
+    }
+    return true;
+}
+
+bool nodi_display_region_take(uint32_t *p_tiles,
+                              uint32_t tile_cols,
+                              uint32_t tile_rows,
+                              nodi_display_rect_s *p_rect)
+{
+    uint32_t x0, x1, a, b, mask;
+    uint32_t y0 = 0;
+    uint32_t y1;
+
+    while ((y0 < tile_rows) && (p_tiles[y0] == 0))
+    {
+        y0++;
+    }
+    if (y0 == tile_rows)
+    {
+        return false;
+    }
+
+    nodi_display_span_get(p_tiles[y0], 0, tile_cols, &x0, &x1);
+
+    /* Next row joins region if its span covers the same columns. */
+    for (y1 = y0; y1 + 1 < tile_rows; y1++)
+    {
+        if (!nodi_display_span_get(p_tiles[y1 + 1], x0, tile_cols, &a, &b) ||
+            (a != x0) || (b < x1))
+        {
+            break;
+        }
+    }
+
+    mask = NODI_DISPLAY_BITS(x0, x1);
+    for (uint32_t y = y0; y <= y1; y++)
+    {
+        p_tiles[y] &= ~mask;
+    }
+
+    p_rect->x0 = x0;
+    p_rect->y0 = y0;
+    p_rect->x1 = x1;
+    p_rect->y1 = y1;
+    return true;
+}
+
+#endif
@@ -0,0 +1,107 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NODI_DISPLAY_TILES_H
+#define NODI_DISPLAY_TILES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "nodi_conf.h"
+
+#if (NODI_DISPLAY_ENABLED == 1) || defined(__DOXYGEN__)
+
+/**
+ * @brief Dirty tile edge length in pixels.
+ */
+#if !defined(NODI_DISPLAY_TILE_SIZE) || defined(__DOXYGEN__)
+#define NODI_DISPLAY_TILE_SIZE 16
+#endif
+
+/**
+ * @brief Maximum number of tile rows. Number of tile columns is limited to 32.
+ */
+#if !defined(NODI_DISPLAY_TILE_ROWS_MAX) || defined(__DOXYGEN__)
+#define NODI_DISPLAY_TILE_ROWS_MAX 16
+#endif
+
+/**
+ * @brief Clean tiles between dirty ones merged into one region if gap is not longer.
+ */
+#if !defined(NODI_DISPLAY_MERGE_GAP) || defined(__DOXYGEN__)
+#define NODI_DISPLAY_MERGE_GAP 1
+#endif
+
+/**
+ * @brief Bitmap row mask of tile columns x0 to x1, inclusive.
+ */
+#define NODI_DISPLAY_BITS(x0, x1)   ((0xFFFFFFFFUL >> (31 - (x1))) & (0xFFFFFFFFUL << (x0)))
+
+/**
+ * @brief   Rectangle in tile coordinates, inclusive.
+ */
+typedef struct {
+    uint16_t                  x0; ///< First tile column.
+    uint16_t                  y0; ///< First tile row.
+    uint16_t                  x1; ///< Last tile column.
+    uint16_t                  y1; ///< Last tile row.
+} nodi_display_rect_s;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Marks tiles of rectangle as dirty.
+ *
+ * @param[in,out] p_tiles       Dirty tiles bitmap, row per word.
+ * @param[in]     p_rect        Rectangle in tile coordinates.
+ */
+void nodi_display_tiles_mark(uint32_t *p_tiles, const nodi_display_rect_s *p_rect);
+
+/**
+ * @brief Takes next region to send from dirty tiles bitmap.
+ *
+ * Region starts at the first dirty tile. It is extended to the right over dirty tiles
+ * and gaps not longer than NODI_DISPLAY_MERGE_GAP, then down while the next row covers
+ * the same columns the same way. Tiles of region are cleared.
+ *
+ * @param[in,out] p_tiles       Dirty tiles bitmap, row per word.
+ * @param[in]     tile_cols     Number of tile columns.
+ * @param[in]     tile_rows     Number of tile rows.
+ * @param[out]    p_rect        Region in tile coordinates.
+ *
+ * @return true if region was found, false if bitmap is clean.
+ */
+bool nodi_display_region_take(uint32_t *p_tiles,
+                              uint32_t tile_cols,
+                              uint32_t tile_rows,
+                              nodi_display_rect_s *p_rect);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NODI_DISPLAY_ENABLED */
+
+#endif /* NODI_DISPLAY_TILES_H */
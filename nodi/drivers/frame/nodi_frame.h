@@ -0,0 +1,160 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NODI_FRAME_H
+#define NODI_FRAME_H
+
+#include "nodi_common.h"
+#include "nodi_uarte.h"
+
+#if ((NODI_FRAME_ENABLED == 1) && (NODI_UARTE_ENABLED == 1)) || defined(__DOXYGEN__)
+
+/**
+ * @brief Frame delimiter. COBS encoded data never contains it.
+ */
+#define NODI_FRAME_DELIMITER    0x00
+
+/**
+ * @brief Worst case encoded length of n bytes payload: COBS overhead, CRC and delimiter.
+ */
+#define NODI_FRAME_ENC_MAX(n)   ((n) + 2 + ((n) + 2) / 254 + 1 + 1)
+
+typedef struct nodi_frame_dec nodi_frame_dec_t;
+
+/**
+ * @brief   Received frame callback type.
+ *
+ * @param[in] p_dec           pointer to the decoder which received the frame
+ * @param[in] p_data          decoded payload, valid until callback returns
+ * @param[in] len             payload length, CRC excluded
+ */
+typedef void (*nodi_frame_callback_t)(nodi_frame_dec_t *p_dec, const uint8_t *p_data, uint32_t len);
+
+/**
+ * @brief   Streaming COBS encoder.
+ *
+ * @details Payload is encoded directly to the buffer passed to UARTE and CRC-16/CCITT
+ *          of payload is calculated in the same pass.
+ */
+typedef struct {
+    uint8_t                  *p_out;     ///< Output buffer, transmitted by UARTE.
+    uint32_t                  out_len;   ///< Output buffer length.
+    uint32_t                  pos;       ///< Encoded bytes.
+    uint32_t                  code_pos;  ///< Position of code byte of current block.
+    uint8_t                   code;      ///< Code of current block.
+    uint16_t                  crc;       ///< CRC of payload.
+} nodi_frame_enc_s;
+
+/**
+ * @brief   Streaming COBS decoder.
+ *
+ * @details Received blocks are decoded as they complete, CRC is checked in the same pass.
+ */
+struct nodi_frame_dec {
+    uint8_t                  *p_buf;     ///< Decoded frame buffer.
+    uint32_t                  buf_len;   ///< Decoded frame buffer length, CRC included.
+    uint32_t                  len;       ///< Decoded bytes of current frame.
+    uint8_t                   code;      ///< Code of current block.
+    uint8_t                   left;      ///< Bytes left in current block.
+    bool                      overflow;  ///< Current frame does not fit to the buffer.
+    uint16_t                  crc;       ///< CRC of current frame.
+    nodi_frame_callback_t     frame_cb;  ///< Received frame callback.
+    void                     *p_context; ///< Application context, not used by decoder.
+    uint32_t                  frames;    ///< Received valid frames.
+    uint32_t                  errors;    ///< Dropped frames: bad CRC, overflow or broken block.
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Calculates CRC-16/CCITT (polynomial 0x1021, MSB first).
+ *
+ * @param[in] crc               Initial value, 0xFFFF for new calculation.
+ * @param[in] p_data            Data.
+ * @param[in] n                 Data length.
+ *
+ * @return Updated CRC.
+ */
+uint16_t nodi_frame_crc16(uint16_t crc, const uint8_t *p_data, uint32_t n);
+
+/**
+ * @brief Starts encoding of a new frame.
+ *
+ * @param[in] p_enc             Encoder.
+ * @param[in] p_out             Output buffer, at least NODI_FRAME_ENC_MAX(payload) bytes.
+ * @param[in] out_len           Output buffer length.
+ */
+void nodi_frame_enc_begin(nodi_frame_enc_s *p_enc, uint8_t *p_out, uint32_t out_len);
+
+/**
+ * @brief Encodes part of payload. Can be called several times, e.g. for header and data.
+ *
+ * @param[in] p_enc             Encoder.
+ * @param[in] p_data            Payload part.
+ * @param[in] n                 Payload part length.
+ */
+void nodi_frame_enc_put(nodi_frame_enc_s *p_enc, const void *p_data, uint32_t n);
+
+/**
+ * @brief Appends CRC and delimiter.
+ *
+ * @param[in] p_enc             Encoder.
+ *
+ * @return Encoded frame length, ready to be sent from p_out.
+ */
+uint32_t nodi_frame_enc_end(nodi_frame_enc_s *p_enc);
+
+/**
+ * @brief Initializes decoder.
+ *
+ * @param[in] p_dec             Decoder.
+ * @param[in] p_buf             Decoded frame buffer, owned by application.
+ * @param[in] buf_len           Decoded frame buffer length. Maximum payload plus 2 bytes of CRC.
+ * @param[in] frame_cb          Received frame callback.
+ */
+void nodi_frame_dec_init(nodi_frame_dec_t *p_dec,
+                         uint8_t *p_buf,
+                         uint32_t buf_len,
+                         nodi_frame_callback_t frame_cb);
+
+/**
+ * @brief Decodes received data, e.g. block completed in rx_end_cb.
+ *
+ * Frame callback is called from this function for every complete frame with valid CRC.
+ *
+ * @param[in] p_dec             Decoder.
+ * @param[in] p_data            Received data.
+ * @param[in] n                 Received data length.
+ */
+void nodi_frame_dec_feed(nodi_frame_dec_t *p_dec, const uint8_t *p_data, uint32_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NODI_FRAME_ENABLED */
+
+#endif /* NODI_FRAME_H */
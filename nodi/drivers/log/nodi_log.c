@@ -0,0 +1,179 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "nodi_common.h"
+#include "nodi_log.h"
+
+#if ((NODI_LOG_ENABLED == 1) && (NODI_UARTE_ENABLED == 1)) || defined(__DOXYGEN__)
+
+/* Records are reserved in reserve, written and published to commit when the outermost
+ * writer finishes. Writers of higher priority always finish before preempted ones resume,
+ * so everything below reserve is written when nesting drops to zero. */
+static struct {
+    nodi_uarte_drv_t         *p_uarte_drv;
+    uint8_t                  *p_buf;
+    uint32_t                  size;
+    volatile uint32_t         reserve;
+    volatile uint32_t         commit;
+    volatile uint32_t         rd;
+    volatile uint32_t         nest;
+    bool                      sending;
+    nodi_uarte_seg_s          seg;
+    nodi_uarte_tx_desc_t      desc;
+    nodi_log_stats_s          stats;
+} nodi_log;
+
+static inline void nodi_log_atomic_add(volatile uint32_t *p_val, uint32_t add)
+{
+    uint32_t val;
+    do {
+        val = __LDREXW(p_val);
+    } while (__STREXW(val + add, p_val));
+}
+
+static inline void nodi_log_byte_put(uint32_t pos, uint8_t byte)
+{
+    nodi_log.p_buf[pos & (nodi_log.size - 1)] = byte;
+}
+
+static inline void nodi_log_word_put(uint32_t pos, uint32_t word)
+{
+    nodi_log_byte_put(pos,     (uint8_t)word);
+    nodi_log_byte_put(pos + 1, (uint8_t)(word >> 8));
+    nodi_log_byte_put(pos + 2, (uint8_t)(word >> 16));
+    nodi_log_byte_put(pos + 3, (uint8_t)(word >> 24));
+}
+
+static void nodi_log_sent_cb(nodi_uarte_drv_t *p_uarte_drv, nodi_uarte_tx_desc_t *p_desc)
+{
+    nodi_log.rd += nodi_log.seg.len;
+    nodi_log.stats.bytes_sent += nodi_log.seg.len;
+    nodi_log.sending = false;
+    nodi_log_flush();
+}
+
+void nodi_log_init(nodi_uarte_drv_t *p_uarte_drv, uint8_t *p_buf, uint32_t size)
+{
+    NODI_DRV_CHECK(p_uarte_drv != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(p_buf != NULL, "Buffer pointer is NULL!");
+    NODI_DRV_CHECK((size >= NODI_LOG_RECORD_LEN(NODI_LOG_ARGS_MAX)) && ((size & (size - 1)) == 0),
+                  "Buffer size must be power of two!");
+
+    nodi_log.p_uarte_drv = p_uarte_drv;
+    nodi_log.p_buf = p_buf;
+    nodi_log.size = size;
+    nodi_log.reserve = 0;
+    nodi_log.commit = 0;
+    nodi_log.rd = 0;
+    nodi_log.nest = 0;
+    nodi_log.sending = false;
+    nodi_log.stats.records = 0;
+    nodi_log.stats.dropped = 0;
+    nodi_log.stats.bytes_sent = 0;
+
+    nodi_log.desc.p_segs = &nodi_log.seg;
+    nodi_log.desc.seg_count = 1;
+    nodi_log.desc.tx_cb = nodi_log_sent_cb;
+    nodi_log.desc.p_context = NULL;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+void nodi_log_write(uint32_t id, uint32_t n, const uint32_t *p_args)
+{
+    NODI_DRV_CHECK(n <= NODI_LOG_ARGS_MAX, "Too many arguments!");
+    NODI_DRV_CHECK(id <= 0xFFFF, "Format section too large!");
+
+    uint32_t timestamp = DWT->CYCCNT;
+    uint32_t len = NODI_LOG_RECORD_LEN(n);
+    uint32_t pos;
+    uint32_t i;
+
+    nodi_log_atomic_add(&nodi_log.nest, 1);
+
+    /* Reserve space. Record is dropped as a whole if buffer is full. */
+    do {
+        pos = __LDREXW(&nodi_log.reserve);
+        if (pos + len - nodi_log.rd > nodi_log.size)
+        {
+            __CLREX();
+            nodi_log_atomic_add(&nodi_log.stats.dropped, 1);
+            len = 0;
+            break;
+        }
+    } while (__STREXW(pos + len, &nodi_log.reserve));
+
+    if (len != 0)
+    {
+        nodi_log_byte_put(pos, NODI_LOG_SYNC | n);
+        nodi_log_byte_put(pos + 1, (uint8_t)id);
+        nodi_log_byte_put(pos + 2, (uint8_t)(id >> 8));
+        nodi_log_word_put(pos + 3, timestamp);
+        for (i = 0; i < n; i++)
+        {
+            nodi_log_word_put(pos + 7 + 4 * i, p_args[i]);
+        }
+        nodi_log_atomic_add(&nodi_log.stats.records, 1);
+    }
+
+    nodi_log_atomic_add(&nodi_log.nest, (uint32_t)-1);
+
+    /* Exception entry clears exclusive monitor, so commit never moves back. */
+    do {
+        (void)__LDREXW(&nodi_log.commit);
+        if (nodi_log.nest != 0)
+        {
+            __CLREX();
+            break;
+        }
+    } while (__STREXW(nodi_log.reserve, &nodi_log.commit));
+}
+
+void nodi_log_flush(void)
+{
+    uint32_t primask = nodi_common_critical_enter();
+    uint32_t avail = nodi_log.commit - nodi_log.rd;
+
+    if (!nodi_log.sending && (avail != 0))
+    {
+        /* Contiguous part only, the rest is sent from callback. */
+        uint32_t offset = nodi_log.rd & (nodi_log.size - 1);
+        uint32_t len = nodi_log.size - offset;
+
+        nodi_log.seg.p_buf = nodi_log.p_buf + offset;
+        nodi_log.seg.len = avail < len ? avail : len;
+        nodi_log.sending = true;
+        nodi_uarte_tx_queue_push(nodi_log.p_uarte_drv, &nodi_log.desc);
+    }
+
+    nodi_common_critical_exit(primask);
+}
+
+const nodi_log_stats_s *nodi_log_stats_get(void)
+{
+    return &nodi_log.stats;
+}
+
+#endif /* NODI_LOG_ENABLED */
@@ -0,0 +1,124 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NODI_LOG_H
+#define NODI_LOG_H
+
+#include "nodi_common.h"
+#include "nodi_uarte.h"
+
+#if ((NODI_LOG_ENABLED == 1) && (NODI_UARTE_ENABLED == 1)) || defined(__DOXYGEN__)
+
+/**
+ * @brief Maximum number of arguments of single log message.
+ */
+#define NODI_LOG_ARGS_MAX       6
+
+/**
+ * @brief First byte of every record. Lower nibble holds number of arguments.
+ */
+#define NODI_LOG_SYNC           0xA0
+
+/**
+ * @brief Record length: sync, 16-bit ID, 32-bit timestamp and 32-bit arguments.
+ */
+#define NODI_LOG_RECORD_LEN(n)  (1 + 2 + 4 + 4 * (n))
+
+/**
+ * @brief   Logs message with up to NODI_LOG_ARGS_MAX integer arguments.
+ *
+ * @details Format string is placed in .nodi_log_fmt section, which is not loaded to
+ *          target. Its address is the message ID. Only ID, timestamp and raw arguments
+ *          are recorded, text is rebuilt by scripts/nodi_log_decode.py from the ELF file.
+ *          Arguments are converted to uint32_t, strings are not supported.
+ */
+#define NODI_LOG(fmt, ...)                                                           \
+    do {                                                                             \
+        static const char nodi_log_fmt[]                                             \
+            __attribute__((section(".nodi_log_fmt"), used)) = fmt;                   \
+        nodi_log_write((uint32_t)nodi_log_fmt, NODI_LOG_NARGS(__VA_ARGS__),          \
+                       (const uint32_t[]){0, ##__VA_ARGS__} + 1);                    \
+    } while (0)
+
+#define NODI_LOG_NARGS(...)     NODI_LOG_NARGS_(0, ##__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define NODI_LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, n, ...) n
+
+/**
+ * @brief   Log statistics.
+ */
+typedef struct {
+    uint32_t                  records;     ///< Recorded messages.
+    uint32_t                  dropped;     ///< Messages dropped because buffer was full.
+    uint32_t                  bytes_sent;  ///< Bytes passed to UARTE.
+} nodi_log_stats_s;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initializes log backend.
+ *
+ * @details DWT cycle counter is enabled and used as timestamp.
+ *
+ * @param[in] p_uarte_drv       UARTE driver used to drain log. Must be initialized.
+ * @param[in] p_buf             Log buffer, owned by application.
+ * @param[in] size              Log buffer size, power of two.
+ */
+void nodi_log_init(nodi_uarte_drv_t *p_uarte_drv, uint8_t *p_buf, uint32_t size);
+
+/**
+ * @brief Records message. Used by NODI_LOG macro.
+ *
+ * Function is lock-free and can be called from any interrupt priority. Record is
+ * reserved with exclusive access and published when the outermost writer finishes.
+ *
+ * @param[in] id                Message ID.
+ * @param[in] n                 Number of arguments.
+ * @param[in] p_args            Arguments.
+ */
+void nodi_log_write(uint32_t id, uint32_t n, const uint32_t *p_args);
+
+/**
+ * @brief Starts sending recorded messages if UARTE is not sending log already.
+ *
+ * Sending continues from transmission callback until buffer is empty, so function
+ * has to be called again only after new messages are recorded, e.g. from idle loop.
+ */
+void nodi_log_flush(void);
+
+/**
+ * @brief Returns log statistics.
+ *
+ * @return Pointer to statistics.
+ */
+const nodi_log_stats_s *nodi_log_stats_get(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NODI_LOG_ENABLED */
+
+#endif /* NODI_LOG_H */
@@ -0,0 +1,216 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include "nodi_common.h"
+#include "nodi_regmap.h"
+
+#if ((NODI_REGMAP_ENABLED == 1) && (NODI_SPIM_ENABLED == 1)) || defined(__DOXYGEN__)
+
+static inline bool nodi_regmap_bit_get(const uint32_t *p_bits, uint32_t reg)
+{
+    return (p_bits[NODI_REGMAP_WORD(reg)] & NODI_REGMAP_BIT(reg)) != 0;
+}
+
+static inline void nodi_regmap_bit_set(uint32_t *p_bits, uint32_t reg)
+{
+    p_bits[NODI_REGMAP_WORD(reg)] |= NODI_REGMAP_BIT(reg);
+}
+
+static inline void nodi_regmap_bit_clr(uint32_t *p_bits, uint32_t reg)
+{
+    p_bits[NODI_REGMAP_WORD(reg)] &= ~NODI_REGMAP_BIT(reg);
+}
+
+static void nodi_regmap_xfer_cb(nodi_spim_drv_t *p_spim_drv, nodi_spim_xfer_desc_t *p_desc)
+{
+    ((nodi_regmap_t *)p_desc->p_context)->xfer_done = true;
+}
+
+/* Bus can be in use by other devices, so access goes through queue. Urgent lane takes
+ * the bus at the nearest transaction or chunk boundary. */
+static void nodi_regmap_xfer(nodi_regmap_t *p_map, uint32_t n_tx, uint32_t n_rx)
+{
+    nodi_spim_xfer_desc_t *p_desc = &p_map->desc;
+
+    p_desc->p_txbuf = p_map->tx_buf;
+    p_desc->n_tx = n_tx;
+    p_desc->p_rxbuf = n_rx ? p_map->rx_buf : NULL;
+    p_desc->n_rx = n_rx;
+    p_desc->tx_row = 0;
+    p_desc->cs_hold = false;
+    p_desc->preemptible = false;
+    p_desc->p_dc_pin = NULL;
+    p_desc->lane = NODI_SPIM_LANE_URGENT;
+    p_desc->xfer_cb = nodi_regmap_xfer_cb;
+    p_desc->p_context = p_map;
+
+    p_map->xfer_done = false;
+    nodi_spim_bus_push(p_map->config->p_spim_drv, p_map->config->p_dev, p_desc);
+    while (!p_map->xfer_done)
+    {
+    }
+}
+
+void nodi_regmap_init(nodi_regmap_t *p_map, const nodi_regmap_config_s *p_config)
+{
+    NODI_DRV_CHECK(p_map != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(p_config != NULL, "Config pointer is NULL!");
+    NODI_DRV_CHECK(p_config->p_spim_drv != NULL, "SPIM driver pointer is NULL!");
+    NODI_DRV_CHECK(p_config->p_dev != NULL, "Device pointer is NULL!");
+    NODI_DRV_CHECK(p_config->reg_count <= NODI_REGMAP_REGS_MAX, "Too many registers!");
+
+    p_map->config = p_config;
+    nodi_regmap_invalidate(p_map);
+    memset(&p_map->stats, 0, sizeof(p_map->stats));
+}
+
+uint8_t nodi_regmap_read(nodi_regmap_t *p_map, uint8_t reg)
+{
+    NODI_DRV_CHECK(p_map != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(reg < p_map->config->reg_count, "Register out of band!");
+
+    bool is_volatile = nodi_regmap_bit_get(p_map->config->volatile_map, reg);
+
+    if (!is_volatile && nodi_regmap_bit_get(p_map->valid, reg))
+    {
+        /* Address and data byte are not sent. */
+        p_map->stats.hits++;
+        p_map->stats.bytes_saved += 2;
+        return p_map->cache[reg];
+    }
+
+    p_map->stats.misses++;
+    p_map->tx_buf[0] = reg | p_map->config->read_flag;
+    nodi_regmap_xfer(p_map, 1, 2);
+
+    if (!is_volatile)
+    {
+        p_map->cache[reg] = p_map->rx_buf[1];
+        nodi_regmap_bit_set(p_map->valid, reg);
+    }
+    return p_map->rx_buf[1];
+}
+
+void nodi_regmap_write(nodi_regmap_t *p_map, uint8_t reg, uint8_t val)
+{
+    NODI_DRV_CHECK(p_map != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(reg < p_map->config->reg_count, "Register out of band!");
+    NODI_DRV_CHECK(nodi_regmap_bit_get(p_map->config->writable_map, reg), "Register is read only!");
+
+    bool is_volatile = nodi_regmap_bit_get(p_map->config->volatile_map, reg);
+
+    /* Device has this value already. */
+    if (!is_volatile && nodi_regmap_bit_get(p_map->valid, reg) &&
+        !nodi_regmap_bit_get(p_map->dirty, reg) && (p_map->cache[reg] == val))
+    {
+        p_map->stats.bytes_saved += 2;
+        return;
+    }
+
+    p_map->cache[reg] = val;
+    nodi_regmap_bit_set(p_map->dirty, reg);
+    if (!is_volatile)
+    {
+        nodi_regmap_bit_set(p_map->valid, reg);
+    }
+}
+
+void nodi_regmap_update_bits(nodi_regmap_t *p_map, uint8_t reg, uint8_t mask, uint8_t val)
+{
+    uint8_t old = nodi_regmap_read(p_map, reg);
+    nodi_regmap_write(p_map, reg, (old & ~mask) | (val & mask));
+}
+
+/* Clean register can fill a gap in burst if its cached value is what device has. */
+static bool nodi_regmap_gap_check(nodi_regmap_t *p_map, uint32_t reg)
+{
+    return nodi_regmap_bit_get(p_map->valid, reg) &&
+           nodi_regmap_bit_get(p_map->config->writable_map, reg) &&
+           !nodi_regmap_bit_get(p_map->config->volatile_map, reg);
+}
+
+void nodi_regmap_sync(nodi_regmap_t *p_map)
+{
+    NODI_DRV_CHECK(p_map != NULL, "Driver pointer is NULL!");
+
+    uint32_t count = p_map->config->reg_count;
+    uint32_t reg = 0;
+
+    while (reg < count)
+    {
+        uint32_t first = reg;
+        uint32_t last = reg;
+        uint32_t n_dirty = 1;
+
+        if (!nodi_regmap_bit_get(p_map->dirty, reg))
+        {
+            reg++;
+            continue;
+        }
+
+        for (reg = reg + 1; reg < count; reg++)
+        {
+            if (nodi_regmap_bit_get(p_map->dirty, reg))
+            {
+                last = reg;
+                n_dirty++;
+            }
+            else if ((reg + 1 >= count) || !nodi_regmap_bit_get(p_map->dirty, reg + 1) ||
+                     !nodi_regmap_gap_check(p_map, reg))
+            {
+                break;
+            }
+        }
+
+        p_map->tx_buf[0] = first | p_map->config->write_flag;
+        memcpy(&p_map->tx_buf[1], &p_map->cache[first], last - first + 1);
+        nodi_regmap_xfer(p_map, last - first + 2, 0);
+
+        /* Every dirty register written alone costs address and data byte. */
+        p_map->stats.bytes_saved += 2 * n_dirty - (last - first + 2);
+
+        for (uint32_t i = first; i <= last; i++)
+        {
+            nodi_regmap_bit_clr(p_map->dirty, i);
+        }
+        reg = last + 1;
+    }
+}
+
+void nodi_regmap_invalidate(nodi_regmap_t *p_map)
+{
+    NODI_DRV_CHECK(p_map != NULL, "Driver pointer is NULL!");
+
+    memset(p_map->valid, 0, sizeof(p_map->valid));
+    memset(p_map->dirty, 0, sizeof(p_map->dirty));
+}
+
+const nodi_regmap_stats_s *nodi_regmap_stats_get(nodi_regmap_t *p_map)
+{
+    NODI_DRV_CHECK(p_map != NULL, "Driver pointer is NULL!");
+    return &p_map->stats;
+}
+
+#endif
@@ -0,0 +1,165 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NODI_REGMAP_H
+#define NODI_REGMAP_H
+
+#include "nodi_common.h"
+#include "nodi_spim.h"
+
+#if ((NODI_REGMAP_ENABLED == 1) && (NODI_SPIM_ENABLED == 1)) || defined(__DOXYGEN__)
+
+/**
+ * @brief Maximum number of device registers shadowed by register map.
+ */
+#if !defined(NODI_REGMAP_REGS_MAX) || defined(__DOXYGEN__)
+#define NODI_REGMAP_REGS_MAX 64
+#endif
+
+#define NODI_REGMAP_WORDS       ((NODI_REGMAP_REGS_MAX + 31) / 32)
+#define NODI_REGMAP_BIT(reg)    (1UL << ((reg) % 32))
+#define NODI_REGMAP_WORD(reg)   ((reg) / 32)
+
+/**
+ * @brief   Register map configuration.
+ *
+ * @details Registers are 8-bit wide with 8-bit addresses. Device increments address
+ *          during burst access.
+ */
+typedef struct {
+    nodi_spim_drv_t          *p_spim_drv;  ///< SPIM driver of the bus device is connected to.
+    const nodi_spim_dev_s    *p_dev;       ///< Device bus settings and CS pin.
+    uint8_t                   reg_count;   ///< Number of registers, starting from address 0.
+    uint8_t                   read_flag;   ///< Bits set in address byte of read access.
+    uint8_t                   write_flag;  ///< Bits set in address byte of write access.
+    uint32_t                  writable_map[NODI_REGMAP_WORDS]; ///< Writable registers bitmap.
+    uint32_t                  volatile_map[NODI_REGMAP_WORDS]; ///< Registers changed by device, never cached.
+} nodi_regmap_config_s;
+
+/**
+ * @brief   Register map counters.
+ */
+typedef struct {
+    uint32_t                  hits;        ///< Reads served by cache.
+    uint32_t                  misses;      ///< Reads done on the bus.
+    uint32_t                  bytes_saved; ///< Bus bytes avoided by cache, skipped and burst writes.
+} nodi_regmap_stats_s;
+
+/**
+ * @brief   Structure representing a device register map.
+ */
+typedef struct {
+    const nodi_regmap_config_s *config;    ///< Current configuration data.
+    uint8_t                   cache[NODI_REGMAP_REGS_MAX]; ///< Register values.
+    uint32_t                  valid[NODI_REGMAP_WORDS];    ///< Registers with valid cache.
+    uint32_t                  dirty[NODI_REGMAP_WORDS];    ///< Registers waiting for sync.
+    uint8_t                   tx_buf[NODI_REGMAP_REGS_MAX + 1]; ///< Burst write buffer.
+    uint8_t                   rx_buf[2];   ///< Single register read buffer.
+    nodi_spim_xfer_desc_t     desc;        ///< Bus access transaction.
+    volatile bool             xfer_done;   ///< Bus access transaction is finished.
+    nodi_regmap_stats_s       stats;       ///< Register map counters.
+} nodi_regmap_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initializes register map. Cache is empty.
+ *
+ * @param[in] p_map             Pointer to structure representing register map.
+ * @param[in] p_config          Register map configuration.
+ */
+void nodi_regmap_init(nodi_regmap_t *p_map, const nodi_regmap_config_s *p_config);
+
+/**
+ * @brief Reads register.
+ *
+ * Valid non-volatile registers are served from cache, others are read on the bus.
+ * Bus accesses are pushed to urgent lane of SPIM queue and waited for, so the bus can
+ * be shared with other queue users. Must not be called from SPIM interrupt priority or
+ * higher, nor with interrupts disabled.
+ *
+ * @param[in] p_map             Pointer to structure representing register map.
+ * @param[in] reg               Register address.
+ *
+ * @return Register value.
+ */
+uint8_t nodi_regmap_read(nodi_regmap_t *p_map, uint8_t reg);
+
+/**
+ * @brief Writes register in cache. Value is sent by nodi_regmap_sync.
+ *
+ * Writing the value register already has is skipped.
+ *
+ * @param[in] p_map             Pointer to structure representing register map.
+ * @param[in] reg               Register address.
+ * @param[in] val               Register value.
+ */
+void nodi_regmap_write(nodi_regmap_t *p_map, uint8_t reg, uint8_t val);
+
+/**
+ * @brief Modifies bits of register in cache. Value is sent by nodi_regmap_sync.
+ *
+ * @param[in] p_map             Pointer to structure representing register map.
+ * @param[in] reg               Register address.
+ * @param[in] mask              Bits to modify.
+ * @param[in] val               New value of modified bits.
+ */
+void nodi_regmap_update_bits(nodi_regmap_t *p_map, uint8_t reg, uint8_t mask, uint8_t val);
+
+/**
+ * @brief Writes dirty registers to device.
+ *
+ * Consecutive dirty registers are written in one burst. Single clean, valid register
+ * between dirty ones is rewritten with its cached value, because it is cheaper than
+ * a new burst. Waits for bus accesses like nodi_regmap_read.
+ *
+ * @param[in] p_map             Pointer to structure representing register map.
+ */
+void nodi_regmap_sync(nodi_regmap_t *p_map);
+
+/**
+ * @brief Drops whole cache, e.g. after device reset.
+ *
+ * @param[in] p_map             Pointer to structure representing register map.
+ */
+void nodi_regmap_invalidate(nodi_regmap_t *p_map);
+
+/**
+ * @brief Returns register map counters.
+ *
+ * @param[in] p_map             Pointer to structure representing register map.
+ *
+ * @return Pointer to counters.
+ */
+const nodi_regmap_stats_s *nodi_regmap_stats_get(nodi_regmap_t *p_map);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NODI_REGMAP_ENABLED */
+
+#endif /* NODI_REGMAP_H */
@@ -0,0 +1,333 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include "nodi_common.h"
+#include "nodi_spi_nor.h"
+
+#if ((NODI_SPI_NOR_ENABLED == 1) && (NODI_SPIM_ENABLED == 1) && (NODI_RTC_ENABLED == 1)) || \
+    defined(__DOXYGEN__)
+
+#define NODI_SPI_NOR_CMD_WREN        0x06
+#define NODI_SPI_NOR_CMD_RDSR        0x05
+#define NODI_SPI_NOR_CMD_READ        0x03
+#define NODI_SPI_NOR_CMD_PP          0x02
+#define NODI_SPI_NOR_CMD_SE          0x20
+
+#define NODI_SPI_NOR_SR_WIP_Msk      0x01
+
+static void nodi_spi_nor_frame_cb(nodi_spim_drv_t *p_spim_drv, nodi_spim_xfer_desc_t *p_desc);
+static void nodi_spi_nor_status_cb(nodi_spim_drv_t *p_spim_drv, nodi_spim_xfer_desc_t *p_desc);
+
+static void nodi_spi_nor_desc_set(nodi_spim_xfer_desc_t *p_desc,
+                                  const void *p_txbuf,
+                                  uint32_t n_tx,
+                                  void *p_rxbuf,
+                                  uint32_t n_rx,
+                                  bool cs_hold,
+                                  nodi_spim_xfer_callback_t xfer_cb)
+{
+    p_desc->p_txbuf = p_txbuf;
+    p_desc->n_tx = n_tx;
+    p_desc->p_rxbuf = p_rxbuf;
+    p_desc->n_rx = n_rx;
+    p_desc->tx_row = 0;
+    p_desc->cs_hold = cs_hold;
+    p_desc->preemptible = false;
+    p_desc->p_dc_pin = NULL;
+    p_desc->lane = NODI_SPIM_LANE_NORMAL;
+    p_desc->xfer_cb = xfer_cb;
+}
+
+/* Pushes single CS frame: optional write enable, command with address and up to two
+ * data parts. Frame is pushed at once, so other devices cannot break in while CS is held. */
+static void nodi_spi_nor_frame_push(nodi_spi_nor_t *p_nor, uint8_t cmd, bool wren, bool rx, uint32_t n)
+{
+    nodi_spim_drv_t *p_spim_drv = p_nor->config->p_spim_drv;
+    const nodi_spim_dev_s *p_dev = p_nor->config->p_dev;
+    uint32_t n0 = n > NODI_SPIM_MAXCNT ? NODI_SPIM_MAXCNT : n;
+    uint32_t n1 = n - n0;
+    uint32_t primask;
+
+    p_nor->frame_len = n;
+    p_nor->cmd_buf[0] = cmd;
+    p_nor->cmd_buf[1] = (uint8_t)(p_nor->addr >> 16);
+    p_nor->cmd_buf[2] = (uint8_t)(p_nor->addr >> 8);
+    p_nor->cmd_buf[3] = (uint8_t)(p_nor->addr);
+
+    nodi_spi_nor_desc_set(&p_nor->desc_cmd, p_nor->cmd_buf, sizeof(p_nor->cmd_buf), NULL, 0,
+                          n0 != 0, n0 != 0 ? NULL : nodi_spi_nor_frame_cb);
+    nodi_spi_nor_desc_set(&p_nor->desc_data[0],
+                          rx ? NULL : p_nor->p_buf, rx ? 0 : n0,
+                          rx ? p_nor->p_buf : NULL, rx ? n0 : 0,
+                          n1 != 0, n1 != 0 ? NULL : nodi_spi_nor_frame_cb);
+    nodi_spi_nor_desc_set(&p_nor->desc_data[1],
+                          rx ? NULL : p_nor->p_buf + n0, rx ? 0 : n1,
+                          rx ? p_nor->p_buf + n0 : NULL, rx ? n1 : 0,
+                          false, nodi_spi_nor_frame_cb);
+
+    primask = nodi_common_critical_enter();
+    if (wren)
+    {
+        nodi_spim_bus_push(p_spim_drv, p_dev, &p_nor->desc_wren);
+    }
+    nodi_spim_bus_push(p_spim_drv, p_dev, &p_nor->desc_cmd);
+    if (n0 != 0)
+    {
+        nodi_spim_bus_push(p_spim_drv, p_dev, &p_nor->desc_data[0]);
+    }
+    if (n1 != 0)
+    {
+        nodi_spim_bus_push(p_spim_drv, p_dev, &p_nor->desc_data[1]);
+    }
+    nodi_common_critical_exit(primask);
+}
+
+static void nodi_spi_nor_read_frame_push(nodi_spi_nor_t *p_nor)
+{
+    uint32_t n = p_nor->rem > NODI_SPI_NOR_FRAME_MAX ? NODI_SPI_NOR_FRAME_MAX : p_nor->rem;
+    nodi_spi_nor_frame_push(p_nor, NODI_SPI_NOR_CMD_READ, false, true, n);
+}
+
+static void nodi_spi_nor_program_frame_push(nodi_spi_nor_t *p_nor)
+{
+    uint32_t n = NODI_SPI_NOR_PAGE_SIZE - (p_nor->addr % NODI_SPI_NOR_PAGE_SIZE);
+    n = p_nor->rem > n ? n : p_nor->rem;
+    nodi_spi_nor_frame_push(p_nor, NODI_SPI_NOR_CMD_PP, true, false, n);
+}
+
+/* Status is read after RTC delay. Back to back polling would load the bus for whole
+ * program or erase time. */
+static void nodi_spi_nor_poll_schedule(nodi_spi_nor_t *p_nor, uint32_t us)
+{
+    nodi_rtc_drv_t *p_rtc_drv = p_nor->config->p_rtc_drv;
+    NRF_RTC_Type * p_reg = p_rtc_drv->p_rtc_reg;
+    uint32_t ticks = (uint32_t)(((uint64_t)us * 32768) /
+                                ((p_rtc_drv->config->prescaler + 1) * 1000000ULL));
+
+    /* COMPARE is not generated for CC less than 2 ticks ahead of COUNTER. */
+    if (ticks < 2)
+    {
+        ticks = 2;
+    }
+
+    p_reg->CC[p_nor->config->rtc_cc] = (p_reg->COUNTER + ticks) & RTC_COUNTER_COUNTER_Msk;
+    nodi_rtc_evt_enable(p_rtc_drv,
+                        (nodi_rtc_cb_evt_t)(NODI_RTC_DRV_CB_EVT_COMP0 + p_nor->config->rtc_cc));
+}
+
+static inline uint32_t nodi_spi_nor_busy_us(nodi_spi_nor_t *p_nor)
+{
+    return p_nor->op == NODI_SPI_NOR_OP_PROGRAM ? p_nor->config->program_us :
+                                                  p_nor->config->erase_us;
+}
+
+static void nodi_spi_nor_op_finish(nodi_spi_nor_t *p_nor)
+{
+    p_nor->op = NODI_SPI_NOR_OP_NONE;
+    p_nor->state = NODI_SPI_NOR_STATE_READY;
+
+    /* Callback can start next operation. */
+    if (p_nor->config->op_cb)
+    {
+        p_nor->config->op_cb(p_nor);
+    }
+}
+
+static void nodi_spi_nor_frame_cb(nodi_spim_drv_t *p_spim_drv, nodi_spim_xfer_desc_t *p_desc)
+{
+    nodi_spi_nor_t *p_nor = (nodi_spi_nor_t *)p_desc->p_context;
+
+    p_nor->addr += p_nor->frame_len;
+    p_nor->p_buf += p_nor->frame_len;
+    p_nor->rem -= p_nor->frame_len;
+
+    if (p_nor->op != NODI_SPI_NOR_OP_READ)
+    {
+        /* Flash is busy now, first status read is expected to find it ready. */
+        nodi_spi_nor_poll_schedule(p_nor, nodi_spi_nor_busy_us(p_nor));
+        return;
+    }
+
+    p_nor->stats.bytes_read += p_nor->frame_len;
+    if (p_nor->rem != 0)
+    {
+        nodi_spi_nor_read_frame_push(p_nor);
+        return;
+    }
+
+    if (p_nor->p_user_buf != NULL)
+    {
+        memcpy(p_nor->p_user_buf, p_nor->cache, p_nor->user_len);
+        p_nor->cache_valid = true;
+    }
+    nodi_spi_nor_op_finish(p_nor);
+}
+
+static void nodi_spi_nor_status_cb(nodi_spim_drv_t *p_spim_drv, nodi_spim_xfer_desc_t *p_desc)
+{
+    nodi_spi_nor_t *p_nor = (nodi_spi_nor_t *)p_desc->p_context;
+
+    if (p_nor->status_rx[1] & NODI_SPI_NOR_SR_WIP_Msk)
+    {
+        p_nor->stats.status_polls++;
+        nodi_spi_nor_poll_schedule(p_nor, nodi_spi_nor_busy_us(p_nor) / 4);
+        return;
+    }
+
+    if (p_nor->op == NODI_SPI_NOR_OP_PROGRAM)
+    {
+        p_nor->stats.pages_programmed++;
+        if (p_nor->rem != 0)
+        {
+            nodi_spi_nor_program_frame_push(p_nor);
+            return;
+        }
+    }
+
+    nodi_spi_nor_op_finish(p_nor);
+}
+
+void nodi_spi_nor_init(nodi_spi_nor_t *p_nor, const nodi_spi_nor_config_s *p_config)
+{
+    NODI_DRV_CHECK(p_nor != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(p_config != NULL, "Config pointer is NULL!");
+    NODI_DRV_CHECK(p_config->p_spim_drv != NULL, "SPIM driver pointer is NULL!");
+    NODI_DRV_CHECK(p_config->p_dev != NULL, "Device pointer is NULL!");
+    NODI_DRV_CHECK(p_config->p_spim_drv->spim_state != NODI_SPIM_DRV_STATE_UNINIT,
+                  "SPIM driver is not initialized!");
+    NODI_DRV_CHECK(p_config->p_rtc_drv != NULL, "RTC driver pointer is NULL!");
+    NODI_DRV_CHECK(p_config->rtc_cc < 4, "RTC compare channel out of band!");
+
+    p_nor->config = p_config;
+    p_nor->op = NODI_SPI_NOR_OP_NONE;
+    p_nor->cache_valid = false;
+    memset(&p_nor->stats, 0, sizeof(p_nor->stats));
+
+    p_nor->wren_buf[0] = NODI_SPI_NOR_CMD_WREN;
+    p_nor->status_tx[0] = NODI_SPI_NOR_CMD_RDSR;
+
+    p_nor->desc_wren.p_context = p_nor;
+    p_nor->desc_cmd.p_context = p_nor;
+    p_nor->desc_data[0].p_context = p_nor;
+    p_nor->desc_data[1].p_context = p_nor;
+    p_nor->desc_status.p_context = p_nor;
+
+    nodi_spi_nor_desc_set(&p_nor->desc_wren, p_nor->wren_buf, sizeof(p_nor->wren_buf),
+                          NULL, 0, false, NULL);
+    nodi_spi_nor_desc_set(&p_nor->desc_status, p_nor->status_tx, sizeof(p_nor->status_tx),
+                          p_nor->status_rx, sizeof(p_nor->status_rx), false,
+                          nodi_spi_nor_status_cb);
+
+    p_nor->state = NODI_SPI_NOR_STATE_READY;
+}
+
+void nodi_spi_nor_read(nodi_spi_nor_t *p_nor, uint32_t addr, void *p_buf, uint32_t len)
+{
+    NODI_DRV_CHECK(p_nor != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(p_nor->state == NODI_SPI_NOR_STATE_READY, "Driver is busy!");
+    NODI_DRV_CHECK((p_buf != NULL) && (len != 0), "Read parameters out of band!");
+
+    p_nor->state = NODI_SPI_NOR_STATE_BUSY;
+    p_nor->op = NODI_SPI_NOR_OP_READ;
+    p_nor->addr = addr;
+
+    if (len > NODI_SPI_NOR_CACHE_SIZE)
+    {
+        p_nor->p_user_buf = NULL;
+        p_nor->p_buf = (uint8_t *)p_buf;
+        p_nor->rem = len;
+        nodi_spi_nor_read_frame_push(p_nor);
+        return;
+    }
+
+    if (p_nor->cache_valid && (addr >= p_nor->cache_addr) &&
+        (addr + len <= p_nor->cache_addr + NODI_SPI_NOR_CACHE_SIZE))
+    {
+        p_nor->stats.cache_hits++;
+        memcpy(p_buf, &p_nor->cache[addr - p_nor->cache_addr], len);
+        nodi_spi_nor_op_finish(p_nor);
+        return;
+    }
+
+    /* Load the whole cache, following sequential reads hit it. */
+    p_nor->stats.cache_misses++;
+    p_nor->cache_valid = false;
+    p_nor->cache_addr = addr;
+    p_nor->p_user_buf = (uint8_t *)p_buf;
+    p_nor->user_len = len;
+    p_nor->p_buf = p_nor->cache;
+    p_nor->rem = NODI_SPI_NOR_CACHE_SIZE;
+    nodi_spi_nor_read_frame_push(p_nor);
+}
+
+void nodi_spi_nor_program(nodi_spi_nor_t *p_nor, uint32_t addr, const void *p_buf, uint32_t len)
+{
+    NODI_DRV_CHECK(p_nor != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(p_nor->state == NODI_SPI_NOR_STATE_READY, "Driver is busy!");
+    NODI_DRV_CHECK((p_buf != NULL) && (len != 0), "Program parameters out of band!");
+
+    p_nor->state = NODI_SPI_NOR_STATE_BUSY;
+    p_nor->op = NODI_SPI_NOR_OP_PROGRAM;
+    p_nor->cache_valid = false;
+    p_nor->addr = addr;
+    /* Data is only sent, descriptors take it as const again. */
+    p_nor->p_buf = (uint8_t *)p_buf;
+    p_nor->rem = len;
+    p_nor->stats.bytes_programmed += len;
+
+    nodi_spi_nor_program_frame_push(p_nor);
+}
+
+void nodi_spi_nor_sector_erase(nodi_spi_nor_t *p_nor, uint32_t addr)
+{
+    NODI_DRV_CHECK(p_nor != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(p_nor->state == NODI_SPI_NOR_STATE_READY, "Driver is busy!");
+
+    p_nor->state = NODI_SPI_NOR_STATE_BUSY;
+    p_nor->op = NODI_SPI_NOR_OP_ERASE;
+    p_nor->cache_valid = false;
+    p_nor->addr = addr & ~(NODI_SPI_NOR_SECTOR_SIZE - 1);
+    p_nor->p_buf = NULL;
+    p_nor->rem = 0;
+
+    nodi_spi_nor_frame_push(p_nor, NODI_SPI_NOR_CMD_SE, true, false, 0);
+}
+
+void nodi_spi_nor_rtc_handle(nodi_spi_nor_t *p_nor)
+{
+    NODI_DRV_CHECK(p_nor != NULL, "Driver pointer is NULL!");
+
+    nodi_rtc_evt_disable(p_nor->config->p_rtc_drv,
+                         (nodi_rtc_cb_evt_t)(NODI_RTC_DRV_CB_EVT_COMP0 + p_nor->config->rtc_cc));
+    nodi_spim_bus_push(p_nor->config->p_spim_drv, p_nor->config->p_dev, &p_nor->desc_status);
+}
+
+const nodi_spi_nor_stats_s *nodi_spi_nor_stats_get(nodi_spi_nor_t *p_nor)
+{
+    NODI_DRV_CHECK(p_nor != NULL, "Driver pointer is NULL!");
+    return &p_nor->stats;
+}
+
+#endif
@@ -0,0 +1,211 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NODI_SPI_NOR_H
+#define NODI_SPI_NOR_H
+
+#include "nodi_common.h"
+#include "nodi_spim.h"
+#include "nodi_rtc.h"
+
+#if ((NODI_SPI_NOR_ENABLED == 1) && (NODI_SPIM_ENABLED == 1) && (NODI_RTC_ENABLED == 1)) || \
+    defined(__DOXYGEN__)
+
+/**
+ * @brief Read-ahead cache length. Reads not longer than cache are served by cache.
+ */
+#if !defined(NODI_SPI_NOR_CACHE_SIZE) || defined(__DOXYGEN__)
+#define NODI_SPI_NOR_CACHE_SIZE 64
+#endif
+
+/**
+ * @brief Flash page length. Page program cannot cross page boundary.
+ */
+#define NODI_SPI_NOR_PAGE_SIZE       256
+
+/**
+ * @brief Flash sector length erased by nodi_spi_nor_sector_erase.
+ */
+#define NODI_SPI_NOR_SECTOR_SIZE     4096
+
+/**
+ * @brief Longest data part of a single CS frame.
+ */
+#define NODI_SPI_NOR_FRAME_MAX       (2 * NODI_SPIM_MAXCNT)
+
+typedef struct nodi_spi_nor nodi_spi_nor_t;
+
+/**
+ * @brief   SPI NOR operation complete callback type.
+ *
+ * @param[in] p_nor           Pointer to the nodi_spi_nor_t object triggering the callback.
+ */
+typedef void (*nodi_spi_nor_callback_t)(nodi_spi_nor_t *p_nor);
+
+typedef struct {
+    nodi_spim_drv_t          *p_spim_drv; ///< SPIM driver of the bus flash is connected to.
+    const nodi_spim_dev_s    *p_dev;      ///< Flash bus settings and CS pin.
+    nodi_spi_nor_callback_t   op_cb;      ///< Operation complete callback or NULL.
+    nodi_rtc_drv_t           *p_rtc_drv;  ///< Started RTC driver timing status polls.
+    uint8_t                   rtc_cc;     ///< RTC compare channel reserved for flash.
+    uint32_t                  program_us; ///< Typical page program time (tPP).
+    uint32_t                  erase_us;   ///< Typical sector erase time (tSE).
+} nodi_spi_nor_config_s;
+
+/**
+ * @brief   SPI NOR driver state machine possible states.
+ */
+typedef enum {
+    NODI_SPI_NOR_STATE_UNINIT, ///< Driver is uninitialized.
+    NODI_SPI_NOR_STATE_READY,  ///< Driver is ready to start an operation.
+    NODI_SPI_NOR_STATE_BUSY,   ///< Driver is busy, executing operation.
+} nodi_spi_nor_state_t;
+
+/**
+ * @brief   SPI NOR operations.
+ */
+typedef enum {
+    NODI_SPI_NOR_OP_NONE,    ///< No operation.
+    NODI_SPI_NOR_OP_READ,    ///< Read, possibly through cache.
+    NODI_SPI_NOR_OP_PROGRAM, ///< Page program sequence.
+    NODI_SPI_NOR_OP_ERASE,   ///< Sector erase.
+} nodi_spi_nor_op_t;
+
+/**
+ * @brief   SPI NOR counters.
+ */
+typedef struct {
+    uint32_t                  cache_hits;       ///< Reads served by cache.
+    uint32_t                  cache_misses;     ///< Reads loading cache.
+    uint32_t                  bytes_read;       ///< Bytes read from flash.
+    uint32_t                  bytes_programmed; ///< Bytes programmed.
+    uint32_t                  pages_programmed; ///< Page program commands.
+    uint32_t                  status_polls;     ///< Status register reads finding flash busy.
+} nodi_spi_nor_stats_s;
+
+/**
+ * @brief   Structure representing a SPI NOR driver.
+ *
+ * @details Object is owned by application. Command and status buffers are kept here,
+ *          because EasyDMA cannot read them from flash.
+ */
+struct nodi_spi_nor {
+    const nodi_spi_nor_config_s *config;    ///< Current configuration data.
+    volatile nodi_spi_nor_state_t state;    ///< Driver current state.
+    nodi_spi_nor_op_t         op;           ///< Operation in progress.
+    uint32_t                  addr;         ///< Flash address of the next frame.
+    uint8_t                  *p_buf;        ///< Data of the next frame.
+    uint32_t                  rem;          ///< Operation remainder length.
+    uint8_t                  *p_user_buf;   ///< Application buffer of cached read or NULL.
+    uint32_t                  user_len;     ///< Application buffer length of cached read.
+    uint32_t                  frame_len;    ///< Data length of the frame in progress.
+    nodi_spim_xfer_desc_t     desc_wren;    ///< Write enable frame.
+    nodi_spim_xfer_desc_t     desc_cmd;     ///< Command and address part of frame.
+    nodi_spim_xfer_desc_t     desc_data[2]; ///< Data part of frame.
+    nodi_spim_xfer_desc_t     desc_status;  ///< Status register read frame.
+    uint8_t                   wren_buf[1];  ///< Write enable command.
+    uint8_t                   cmd_buf[4];   ///< Command and address.
+    uint8_t                   status_tx[1]; ///< Status register read command.
+    uint8_t                   status_rx[2]; ///< Status register value in second byte.
+    uint8_t                   cache[NODI_SPI_NOR_CACHE_SIZE]; ///< Read-ahead cache.
+    uint32_t                  cache_addr;   ///< Flash address of cache content.
+    bool                      cache_valid;  ///< Cache content is valid.
+    nodi_spi_nor_stats_s      stats;        ///< Driver counters.
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initializes SPI NOR driver object.
+ *
+ * SPIM driver has to be initialized before. Flash shares SPIM through bus manager queue.
+ *
+ * @param[in] p_nor             Pointer to structure representing SPI NOR driver.
+ * @param[in] p_config          Driver configuration.
+ */
+void nodi_spi_nor_init(nodi_spi_nor_t *p_nor, const nodi_spi_nor_config_s *p_config);
+
+/**
+ * @brief Reads data from flash.
+ *
+ * Reads not longer than NODI_SPI_NOR_CACHE_SIZE load the whole cache from given address,
+ * so following sequential reads are served from RAM. Cache hit calls op_cb before
+ * function returns.
+ *
+ * @param[in]  p_nor            Pointer to structure representing SPI NOR driver.
+ * @param[in]  addr             Flash address.
+ * @param[out] p_buf            Input data buffer.
+ * @param[in]  len              Data length.
+ */
+void nodi_spi_nor_read(nodi_spi_nor_t *p_nor, uint32_t addr, void *p_buf, uint32_t len);
+
+/**
+ * @brief Programs data to flash.
+ *
+ * Data is split at page boundaries. Status register is first read program_us after the
+ * page is sent and then every program_us / 4 until flash is ready, so the bus is free
+ * for other devices meanwhile. Next page is programmed from interrupt routine.
+ *
+ * @param[in] p_nor             Pointer to structure representing SPI NOR driver.
+ * @param[in] addr              Flash address.
+ * @param[in] p_buf             Output data buffer. Must stay valid until op_cb.
+ * @param[in] len               Data length.
+ */
+void nodi_spi_nor_program(nodi_spi_nor_t *p_nor, uint32_t addr, const void *p_buf, uint32_t len);
+
+/**
+ * @brief Erases sector containing given address.
+ *
+ * @param[in] p_nor             Pointer to structure representing SPI NOR driver.
+ * @param[in] addr              Flash address.
+ */
+void nodi_spi_nor_sector_erase(nodi_spi_nor_t *p_nor, uint32_t addr);
+
+/**
+ * @brief Reads status register of busy flash.
+ *
+ * Application has to call it from RTC evt_cb on COMPARE event of rtc_cc channel.
+ *
+ * @param[in] p_nor             Pointer to structure representing SPI NOR driver.
+ */
+void nodi_spi_nor_rtc_handle(nodi_spi_nor_t *p_nor);
+
+/**
+ * @brief Returns driver counters.
+ *
+ * @param[in] p_nor             Pointer to structure representing SPI NOR driver.
+ *
+ * @return Pointer to counters.
+ */
+const nodi_spi_nor_stats_s *nodi_spi_nor_stats_get(nodi_spi_nor_t *p_nor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NODI_SPI_NOR_ENABLED */
+
+#endif /* NODI_SPI_NOR_H */
@@ -56,6 +56,11 @@ void nodi_spim_prepare(void)
     NODI_SPIM0.p_spim_reg = NRF_SPIM0;
     NODI_SPIM0.irq = SPIM0_IRQn;
     NODI_SPIM0.irq_priority = NODI_SPIM_SPIM0_IRQ_PRIORITY;
+    NODI_SPIM0.p_queue_cur = NULL;
+    NODI_SPIM0.large_rem = 0;
+    NODI_SPIM0.fill = false;
+    NODI_SPIM0.sampling = false;
+    NODI_SPIM0.p_stream_bufs = NULL;
 #ifndef NODI_SPIM_DISABLE_IRQ_CONNECT
     nodi_mnd_register(nodi_spim_irq_routine, &NODI_SPIM0, SPIM0_IRQn);
 #endif
@@ -66,6 +71,11 @@ void nodi_spim_prepare(void)
     NODI_SPIM1.p_spim_reg = NRF_SPIM1;
     NODI_SPIM1.irq = SPIM1_IRQn;
     NODI_SPIM1.irq_priority = NODI_SPIM_SPIM1_IRQ_PRIORITY;
+    NODI_SPIM1.p_queue_cur = NULL;
+    NODI_SPIM1.large_rem = 0;
+    NODI_SPIM1.fill = false;
+    NODI_SPIM1.sampling = false;
+    NODI_SPIM1.p_stream_bufs = NULL;
 #ifndef NODI_SPIM_DISABLE_IRQ_CONNECT
     nodi_mnd_register(nodi_spim_irq_routine, &NODI_SPIM1, SPIM1_IRQn);
 #endif
@@ -76,22 +86,81 @@ void nodi_spim_prepare(void)
     NODI_SPIM2.p_spim_reg = NRF_SPIM2;
     NODI_SPIM2.irq = SPIM2_IRQn;
     NODI_SPIM2.irq_priority = NODI_SPIM_SPIM2_IRQ_PRIORITY;
+    NODI_SPIM2.p_queue_cur = NULL;
+    NODI_SPIM2.large_rem = 0;
+    NODI_SPIM2.fill = false;
+    NODI_SPIM2.sampling = false;
+    NODI_SPIM2.p_stream_bufs = NULL;
 #ifndef NODI_SPIM_DISABLE_IRQ_CONNECT
     nodi_mnd_register(nodi_spim_irq_routine, &NODI_SPIM2, SPIM2_IRQn);
 #endif
 #endif
 
-#if (NODI_SPIM_USE_SPIM1 == 1)
+#if (NODI_SPIM_USE_SPIM3 == 1)
     NODI_SPIM3.spim_state = NODI_SPIM_DRV_STATE_UNINIT;
     NODI_SPIM3.p_spim_reg = NRF_SPIM3;
     NODI_SPIM3.irq = SPIM3_IRQn;
     NODI_SPIM3.irq_priority = NODI_SPIM_SPIM3_IRQ_PRIORITY;
+    NODI_SPIM3.p_queue_cur = NULL;
+    NODI_SPIM3.large_rem = 0;
+    NODI_SPIM3.fill = false;
+    NODI_SPIM3.sampling = false;
+    NODI_SPIM3.p_stream_bufs = NULL;
 #ifndef NODI_SPIM_DISABLE_IRQ_CONNECT
     nodi_mnd_register(nodi_spim_irq_routine, &NODI_SPIM3, SPIM3_IRQn);
 #endif
 #endif
 }
 
+static void nodi_spim_ext_init(nodi_spim_drv_t *p_spim_drv)
+{
+    const nodi_spim_ext_config_s *p_ext = p_spim_drv->config->p_ext_cfg;
+    NRF_SPIM_Type * p_reg = p_spim_drv->p_spim_reg;
+
+    NODI_DRV_CHECK(p_reg == NRF_SPIM3, "Extended features available only on SPIM3!");
+    NODI_DRV_CHECK(p_ext->rx_delay <= SPIM_IFTIMING_RXDELAY_RXDELAY_Msk, "RX delay out of band!");
+
+    p_reg->PSEL.CSN = nodi_gpio_translate_periph(&p_ext->csn_pin);
+    p_reg->CSNPOL = p_ext->csn_pol;
+    p_reg->IFTIMING.CSNDUR = p_ext->csn_dur;
+    p_reg->IFTIMING.RXDELAY = p_ext->rx_delay;
+    p_reg->PSELDCX = nodi_gpio_translate_periph(&p_ext->dcx_pin);
+    p_reg->DCXCNT = 0;
+}
+
+static void nodi_spim_ts_init(nodi_spim_drv_t *p_spim_drv)
+{
+    const nodi_spim_ts_config_s *p_ts = p_spim_drv->config->p_ts_cfg;
+    NRF_SPIM_Type * p_reg = p_spim_drv->p_spim_reg;
+    NRF_TIMER_Type * p_timer = p_ts->p_timer_reg;
+
+    NODI_DRV_CHECK(p_ts->prescaler <= TIMER_PRESCALER_PRESCALER_Msk, "Prescaler out of band!");
+
+    p_timer->TASKS_STOP = 1;
+    p_timer->INTENCLR = 0xFFFFFFFF;
+    p_timer->SHORTS = 0;
+    p_timer->MODE = TIMER_MODE_MODE_Timer;
+    p_timer->BITMODE = TIMER_BITMODE_BITMODE_32Bit;
+    p_timer->PRESCALER = p_ts->prescaler;
+    p_timer->TASKS_CLEAR = 1;
+    p_timer->TASKS_START = 1;
+
+    nodi_ppi_channel_assign(p_ts->ppi_ch_started,
+                            (uint32_t)&p_reg->EVENTS_STARTED,
+                            (uint32_t)&p_timer->TASKS_CAPTURE[p_ts->cc_started]);
+    nodi_ppi_channel_assign(p_ts->ppi_ch_end,
+                            (uint32_t)&p_reg->EVENTS_END,
+                            (uint32_t)&p_timer->TASKS_CAPTURE[p_ts->cc_end]);
+    nodi_ppi_channels_enable(NODI_PPI_CH_MSK(p_ts->ppi_ch_started) |
+                             NODI_PPI_CH_MSK(p_ts->ppi_ch_end));
+}
+
+static bool nodi_spim_hw_csn_check(nodi_spim_drv_t *p_spim_drv)
+{
+    return (p_spim_drv->config->p_ext_cfg != NULL) &&
+           (p_spim_drv->config->p_ext_cfg->csn_pin.p_port != NULL);
+}
+
 void nodi_spim_init(nodi_spim_drv_t *p_spim_drv)
 {
     NODI_DRV_CHECK(p_spim_drv != NULL, "Driver pointer is NULL!");
@@ -100,6 +169,11 @@ void nodi_spim_init(nodi_spim_drv_t *p_spim_drv)
 
     NRF_SPIM_Type * p_reg = p_spim_drv->p_spim_reg;
 
+    NODI_DRV_CHECK(((p_spim_drv->config->frequency != NODI_SPIM_FREQ_16M) &&
+                    (p_spim_drv->config->frequency != NODI_SPIM_FREQ_32M)) ||
+                   (p_spim_drv->p_spim_reg == NRF_SPIM3),
+                   "Frequency available only on SPIM3!");
+
     /* Set pins. */
     p_reg->PSEL.SCK  = nodi_gpio_translate_periph(&p_spim_drv->config->sck_pin),
     p_reg->PSEL.MOSI = nodi_gpio_translate_periph(&p_spim_drv->config->mosi_pin),
@@ -114,6 +188,32 @@ void nodi_spim_init(nodi_spim_drv_t *p_spim_drv)
     /* Set overrun character. */
     p_reg->ORC = p_spim_drv->config->orc;
 
+    /* Queue is empty. */
+    for (uint32_t lane = 0; lane < NODI_SPIM_LANE_COUNT; lane++)
+    {
+        p_spim_drv->p_queue_head[lane] = NULL;
+        p_spim_drv->p_queue_tail[lane] = NULL;
+    }
+
+    /* Bus settings of the configuration are in use until a device is applied. */
+    p_spim_drv->p_bus_dev = NULL;
+    p_spim_drv->bus_frequency = p_reg->FREQUENCY;
+    p_spim_drv->bus_config = p_reg->CONFIG;
+    p_spim_drv->bus_orc = p_reg->ORC;
+    nodi_spim_bus_stats_clear(p_spim_drv);
+
+    /* Set SPIM3 extended features. */
+    if (p_spim_drv->config->p_ext_cfg != NULL)
+    {
+        nodi_spim_ext_init(p_spim_drv);
+    }
+
+    /* Set hardware timestamps. */
+    if (p_spim_drv->config->p_ts_cfg != NULL)
+    {
+        nodi_spim_ts_init(p_spim_drv);
+    }
+
     /* Set interrupt, because driver is based on interrupts. */
     p_reg->INTENCLR = 0xFFFFFFFF;
 //    p_reg->EVENTS_END = 0;
@@ -143,6 +243,22 @@ void nodi_spim_deinit(nodi_spim_drv_t *p_spim_drv)
     /* Disable peripheral. */
     p_reg->ENABLE = SPIM_ENABLE_ENABLE_Disabled;
 
+    /* Release timestamps resources. */
+    if (p_spim_drv->config->p_ts_cfg != NULL)
+    {
+        const nodi_spim_ts_config_s *p_ts = p_spim_drv->config->p_ts_cfg;
+        nodi_ppi_channels_disable(NODI_PPI_CH_MSK(p_ts->ppi_ch_started) |
+                                  NODI_PPI_CH_MSK(p_ts->ppi_ch_end));
+        p_ts->p_timer_reg->TASKS_STOP = 1;
+    }
+
+    /* Release SPIM3 only pins. */
+    if (p_spim_drv->config->p_ext_cfg != NULL)
+    {
+        p_reg->PSEL.CSN = 0xFFFFFFFF;
+        p_reg->PSELDCX = 0xFFFFFFFF;
+    }
+
     p_spim_drv->spim_state = NODI_SPIM_DRV_STATE_UNINIT;
 }
 
@@ -151,6 +267,10 @@ inline void nodi_spim_select(nodi_spim_drv_t *p_spim_drv)
     NODI_DRV_CHECK(p_spim_drv != NULL, "Driver pointer is NULL!");
     NODI_DRV_CHECK(p_spim_drv->spim_state == NODI_SPIM_DRV_STATE_READY,
                   "Driver is not initialized!");
+    if (nodi_spim_hw_csn_check(p_spim_drv))
+    {
+        return;
+    }
     nodi_gpio_clr(p_spim_drv->config->cs_pin.p_port, p_spim_drv->config->cs_pin.pin);
 }
 
@@ -160,9 +280,23 @@ inline void nodi_spim_unselect(nodi_spim_drv_t *p_spim_drv)
     NODI_DRV_CHECK(((p_spim_drv->spim_state == NODI_SPIM_DRV_STATE_FINISH) ||
                    (p_spim_drv->spim_state == NODI_SPIM_DRV_STATE_READY)),
                     "Driver is in bad state!");
+    if (nodi_spim_hw_csn_check(p_spim_drv))
+    {
+        return;
+    }
     nodi_gpio_set(p_spim_drv->config->cs_pin.p_port, p_spim_drv->config->cs_pin.pin);
 }
 
+void nodi_spim_dcx_cnt_set(nodi_spim_drv_t *p_spim_drv, uint32_t n_cmd)
+{
+    NODI_DRV_CHECK(p_spim_drv != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(p_spim_drv->config->p_ext_cfg != NULL, "Extended features not configured!");
+    NODI_DRV_CHECK(n_cmd <= NODI_SPIM_DCX_CNT_ALL_CMD, "DCX count out of band!");
+
+    NRF_SPIM_Type * p_reg = p_spim_drv->p_spim_reg;
+    p_reg->DCXCNT = n_cmd;
+}
+
 void nodi_spim_exchange(nodi_spim_drv_t *p_spim_drv,
                        uint32_t n_tx,
                        const void *p_txbuf,
@@ -185,6 +319,114 @@ void nodi_spim_exchange(nodi_spim_drv_t *p_spim_drv,
     p_reg->TASKS_START = 1;
 }
 
+static void nodi_spim_end_handle(nodi_spim_drv_t *p_spim_drv)
+{
+    NRF_SPIM_Type * p_reg = p_spim_drv->p_spim_reg;
+
+    /* Fill left its byte in ORC, plain transfers clock out the configured one. */
+    if (p_spim_drv->fill)
+    {
+        p_spim_drv->fill = false;
+        p_reg->ORC = p_spim_drv->config->orc;
+        p_spim_drv->bus_orc = p_spim_drv->config->orc;
+    }
+
+    /* Set finish state to indicate operation end. */
+    p_spim_drv->spim_state = NODI_SPIM_DRV_STATE_FINISH;
+
+    /* Call callback if not null. */
+    if (p_spim_drv->config->end_cb)
+    {
+        p_spim_drv->config->end_cb(p_spim_drv);
+    }
+
+    /* Callback can start next transmission. Checking... */
+    if (p_spim_drv->spim_state == NODI_SPIM_DRV_STATE_FINISH)
+    {
+        p_spim_drv->spim_state = NODI_SPIM_DRV_STATE_READY;
+        p_reg->INTENCLR = SPIM_INTENCLR_END_Msk;
+    }
+}
+
+void nodi_spim_exchange_polled(nodi_spim_drv_t *p_spim_drv,
+                               uint32_t n_tx,
+                               const void *p_txbuf,
+                               uint32_t n_rx,
+                               void *p_rxbuf)
+{
+    NODI_DRV_CHECK(p_spim_drv != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(p_spim_drv->spim_state != NODI_SPIM_DRV_STATE_BUSY, "Driver is busy!");
+    NODI_DRV_CHECK(n_tx <= 255, "TX length is too long!");
+    NODI_DRV_CHECK(n_rx <= 255, "RX length is too long!");
+
+    NRF_SPIM_Type * p_reg = p_spim_drv->p_spim_reg;
+    p_reg->INTENCLR = SPIM_INTENCLR_END_Msk;
+
+    p_reg->TXD.PTR    = (uint32_t)p_txbuf;
+    p_reg->TXD.MAXCNT = n_tx;
+    p_reg->RXD.PTR    = (uint32_t)p_rxbuf;
+    p_reg->RXD.MAXCNT = n_rx;
+
+    p_reg->EVENTS_END = 0;
+    p_reg->TASKS_START = 1;
+    while (p_reg->EVENTS_END == 0)
+    {
+    }
+    p_reg->EVENTS_END = 0;
+}
+
+static uint32_t nodi_spim_freq_khz_get(uint32_t frequency)
+{
+    switch (frequency)
+    {
+    case NODI_SPIM_FREQ_125K:
+        return 125;
+    case NODI_SPIM_FREQ_250K:
+        return 250;
+    case NODI_SPIM_FREQ_500K:
+        return 500;
+    case NODI_SPIM_FREQ_1M:
+        return 1000;
+    case NODI_SPIM_FREQ_2M:
+        return 2000;
+    case NODI_SPIM_FREQ_4M:
+        return 4000;
+    case NODI_SPIM_FREQ_8M:
+        return 8000;
+    case NODI_SPIM_FREQ_16M:
+        return 16000;
+    case NODI_SPIM_FREQ_32M:
+        return 32000;
+    default:
+        NODI_DRV_CHECK(false, "Unhandled frequency!");
+        return 125;
+    }
+}
+
+uint32_t nodi_spim_exchange_auto(nodi_spim_drv_t *p_spim_drv,
+                                 uint32_t n_tx,
+                                 const void *p_txbuf,
+                                 uint32_t n_rx,
+                                 void *p_rxbuf)
+{
+    NODI_DRV_CHECK(p_spim_drv != NULL, "Driver pointer is NULL!");
+
+    uint32_t n = n_tx > n_rx ? n_tx : n_rx;
+    /* Bus manager may have switched the clock to the one of the last applied device. */
+    uint32_t xfer_ns = (n * 8UL * 1000000UL) / nodi_spim_freq_khz_get(p_spim_drv->bus_frequency);
+
+    if (xfer_ns > NODI_SPIM_POLL_MAX_NS)
+    {
+        nodi_spim_exchange(p_spim_drv, n_tx, p_txbuf, n_rx, p_rxbuf);
+        return 0;
+    }
+
+    nodi_spim_exchange_polled(p_spim_drv, n_tx, p_txbuf, n_rx, p_rxbuf);
+    /* Keep the same callback semantic as interrupt driven transfer. */
+    nodi_spim_end_handle(p_spim_drv);
+    return 1;
+}
+
 void nodi_spim_send(nodi_spim_drv_t *p_spim_drv, uint32_t n, const void *p_txbuf)
 {
     NODI_DRV_CHECK(p_spim_drv != NULL, "Driver pointer is NULL!");
@@ -215,6 +457,689 @@ void nodi_spim_receive(nodi_spim_drv_t *p_spim_drv, uint32_t n, void *p_rxbuf)
     p_reg->TASKS_START = 1;
 }
 
+/* Chains chunks by hardware. TIMER counts END events, PPI restarts SPIM and stops it
+ * after the last chunk. Buffer registers are set by caller. */
+static void nodi_spim_chain_start(nodi_spim_drv_t *p_spim_drv, uint32_t chunks)
+{
+    const nodi_spim_list_config_s *p_list = p_spim_drv->config->p_list_cfg;
+    NRF_SPIM_Type * p_reg = p_spim_drv->p_spim_reg;
+    NRF_TIMER_Type * p_timer = p_list->p_timer_reg;
+    uint32_t ppi_mask;
+
+    /* TIMER counts finished chunks. */
+    p_timer->TASKS_STOP = 1;
+    p_timer->INTENCLR = 0xFFFFFFFF;
+    p_timer->SHORTS = 0;
+    p_timer->MODE = TIMER_MODE_MODE_LowPowerCounter;
+    p_timer->BITMODE = TIMER_BITMODE_BITMODE_32Bit;
+    p_timer->CC[0] = chunks - 1;
+    p_timer->CC[1] = chunks;
+    p_timer->EVENTS_COMPARE[0] = 0;
+    p_timer->EVENTS_COMPARE[1] = 0;
+    p_timer->TASKS_CLEAR = 1;
+    p_timer->TASKS_START = 1;
+
+    nodi_ppi_channel_assign(p_list->ppi_ch_count,
+                            (uint32_t)&p_reg->EVENTS_END,
+                            (uint32_t)&p_timer->TASKS_COUNT);
+    nodi_ppi_channel_assign(p_list->ppi_ch_done,
+                            (uint32_t)&p_timer->EVENTS_COMPARE[1],
+                            (uint32_t)&p_reg->TASKS_STOP);
+    ppi_mask = NODI_PPI_CH_MSK(p_list->ppi_ch_count) | NODI_PPI_CH_MSK(p_list->ppi_ch_done);
+
+    /* Works as END_START short, but can be broken by hardware before the last chunk. */
+    if (chunks > 1)
+    {
+        nodi_ppi_channel_assign(p_list->ppi_ch_restart,
+                                (uint32_t)&p_reg->EVENTS_END,
+                                (uint32_t)&p_reg->TASKS_START);
+        nodi_ppi_channel_assign(p_list->ppi_ch_break,
+                                (uint32_t)&p_timer->EVENTS_COMPARE[0],
+                                nodi_ppi_group_disable_task_addr_get(p_list->ppi_group));
+        nodi_ppi_group_assign(p_list->ppi_group, NODI_PPI_CH_MSK(p_list->ppi_ch_restart));
+        ppi_mask |= NODI_PPI_CH_MSK(p_list->ppi_ch_restart) |
+                    NODI_PPI_CH_MSK(p_list->ppi_ch_break);
+    }
+
+    p_spim_drv->spim_state = NODI_SPIM_DRV_STATE_BUSY;
+    p_reg->EVENTS_END = 0;
+    p_reg->EVENTS_STOPPED = 0;
+    p_reg->INTENCLR = SPIM_INTENCLR_END_Msk;
+    p_reg->INTENSET = SPIM_INTENSET_STOPPED_Msk;
+
+    nodi_ppi_channels_enable(ppi_mask);
+    p_reg->TASKS_START = 1;
+}
+
+void nodi_spim_exchange_large(nodi_spim_drv_t *p_spim_drv,
+                              uint32_t n,
+                              const void *p_txbuf,
+                              void *p_rxbuf)
+{
+    NODI_DRV_CHECK(p_spim_drv != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(p_spim_drv->config->p_list_cfg != NULL, "Large transfer not configured!");
+    NODI_DRV_CHECK(p_spim_drv->spim_state == NODI_SPIM_DRV_STATE_READY, "Driver is busy!");
+
+    NRF_SPIM_Type * p_reg = p_spim_drv->p_spim_reg;
+    uint32_t chunks = n / NODI_SPIM_MAXCNT;
+
+    if (n <= NODI_SPIM_MAXCNT)
+    {
+        nodi_spim_exchange(p_spim_drv, p_txbuf ? n : 0, p_txbuf, p_rxbuf ? n : 0, p_rxbuf);
+        return;
+    }
+
+    /* Remainder is sent from interrupt routine after ArrayList part. */
+    p_spim_drv->large_rem = n % NODI_SPIM_MAXCNT;
+    p_spim_drv->p_large_tx = p_txbuf ?
+            (const uint8_t *)p_txbuf + chunks * NODI_SPIM_MAXCNT : NULL;
+    p_spim_drv->p_large_rx = p_rxbuf ?
+            (uint8_t *)p_rxbuf + chunks * NODI_SPIM_MAXCNT : NULL;
+
+    p_reg->TXD.PTR    = (uint32_t)p_txbuf;
+    p_reg->TXD.MAXCNT = p_txbuf ? NODI_SPIM_MAXCNT : 0;
+    p_reg->TXD.LIST   = p_txbuf ? SPIM_TXD_LIST_LIST_ArrayList : SPIM_TXD_LIST_LIST_Disabled;
+    p_reg->RXD.PTR    = (uint32_t)p_rxbuf;
+    p_reg->RXD.MAXCNT = p_rxbuf ? NODI_SPIM_MAXCNT : 0;
+    p_reg->RXD.LIST   = p_rxbuf ? SPIM_RXD_LIST_LIST_ArrayList : SPIM_RXD_LIST_LIST_Disabled;
+
+    nodi_spim_chain_start(p_spim_drv, chunks);
+}
+
+void nodi_spim_fill(nodi_spim_drv_t *p_spim_drv, uint8_t value, uint32_t n)
+{
+    NODI_DRV_CHECK(p_spim_drv != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(p_spim_drv->config->p_list_cfg != NULL, "Large transfer not configured!");
+    NODI_DRV_CHECK(p_spim_drv->config->p_list_cfg->p_sink_buf != NULL, "Sink not configured!");
+    NODI_DRV_CHECK(p_spim_drv->config->p_list_cfg->sink_len != 0, "Sink not configured!");
+    NODI_DRV_CHECK(p_spim_drv->spim_state == NODI_SPIM_DRV_STATE_READY, "Driver is busy!");
+
+    const nodi_spim_list_config_s *p_list = p_spim_drv->config->p_list_cfg;
+    NRF_SPIM_Type * p_reg = p_spim_drv->p_spim_reg;
+    uint32_t chunks = n / p_list->sink_len;
+
+    /* ORC is clocked out when TXD.MAXCNT is exhausted. It is restored in end handler. */
+    p_reg->ORC = value;
+    p_spim_drv->bus_orc = value;
+    p_spim_drv->p_bus_dev = NULL;
+    p_spim_drv->fill = true;
+
+    if (chunks == 0)
+    {
+        nodi_spim_exchange(p_spim_drv, 0, NULL, n, p_list->p_sink_buf);
+        return;
+    }
+
+    /* Received bytes are dropped to the same sink by every chunk. */
+    p_spim_drv->large_rem = n % p_list->sink_len;
+    p_spim_drv->p_large_tx = NULL;
+    p_spim_drv->p_large_rx = p_list->p_sink_buf;
+
+    p_reg->TXD.MAXCNT = 0;
+    p_reg->TXD.LIST   = SPIM_TXD_LIST_LIST_Disabled;
+    p_reg->RXD.PTR    = (uint32_t)p_list->p_sink_buf;
+    p_reg->RXD.MAXCNT = p_list->sink_len;
+    p_reg->RXD.LIST   = SPIM_RXD_LIST_LIST_Disabled;
+
+    nodi_spim_chain_start(p_spim_drv, chunks);
+}
+
+static void nodi_spim_large_stopped_handle(nodi_spim_drv_t *p_spim_drv)
+{
+    const nodi_spim_list_config_s *p_list = p_spim_drv->config->p_list_cfg;
+    NRF_SPIM_Type * p_reg = p_spim_drv->p_spim_reg;
+
+    nodi_ppi_channels_disable(NODI_PPI_CH_MSK(p_list->ppi_ch_count)   |
+                              NODI_PPI_CH_MSK(p_list->ppi_ch_restart) |
+                              NODI_PPI_CH_MSK(p_list->ppi_ch_break)   |
+                              NODI_PPI_CH_MSK(p_list->ppi_ch_done));
+    p_list->p_timer_reg->TASKS_STOP = 1;
+
+    p_reg->INTENCLR = SPIM_INTENCLR_STOPPED_Msk;
+    p_reg->TXD.LIST = SPIM_TXD_LIST_LIST_Disabled;
+    p_reg->RXD.LIST = SPIM_RXD_LIST_LIST_Disabled;
+
+    /* Remainder finishes as ordinary transfer with END interrupt. */
+    if (p_spim_drv->large_rem != 0)
+    {
+        uint32_t n = p_spim_drv->large_rem;
+        p_spim_drv->large_rem = 0;
+        nodi_spim_exchange(p_spim_drv,
+                           p_spim_drv->p_large_tx ? n : 0, p_spim_drv->p_large_tx,
+                           p_spim_drv->p_large_rx ? n : 0, p_spim_drv->p_large_rx);
+        return;
+    }
+
+    nodi_spim_end_handle(p_spim_drv);
+}
+
+void nodi_spim_sampling_start(nodi_spim_drv_t *p_spim_drv,
+                              uint32_t period_us,
+                              uint32_t n_tx,
+                              const void *p_txbuf,
+                              uint32_t n_rx,
+                              void *p_rxbuf,
+                              uint32_t n_samples)
+{
+    NODI_DRV_CHECK(p_spim_drv != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(p_spim_drv->config->p_sampling_cfg != NULL, "Sampling not configured!");
+    NODI_DRV_CHECK(p_spim_drv->spim_state == NODI_SPIM_DRV_STATE_READY, "Driver is busy!");
+    NODI_DRV_CHECK(n_tx <= NODI_SPIM_MAXCNT, "TX length is too long!");
+    NODI_DRV_CHECK(n_rx <= NODI_SPIM_MAXCNT, "RX length is too long!");
+    NODI_DRV_CHECK((period_us != 0) && (n_samples != 0), "Sampling parameters out of band!");
+
+    const nodi_spim_sampling_config_s *p_smp = p_spim_drv->config->p_sampling_cfg;
+    NRF_SPIM_Type * p_reg = p_spim_drv->p_spim_reg;
+    NRF_TIMER_Type * p_trigger = p_smp->p_trigger_timer_reg;
+    NRF_TIMER_Type * p_counter = p_smp->p_counter_timer_reg;
+
+    /* Trigger TIMER runs at 1 MHz and restarts its period by itself. */
+    p_trigger->TASKS_STOP = 1;
+    p_trigger->INTENCLR = 0xFFFFFFFF;
+    p_trigger->MODE = TIMER_MODE_MODE_Timer;
+    p_trigger->BITMODE = TIMER_BITMODE_BITMODE_32Bit;
+    p_trigger->PRESCALER = 4;
+    p_trigger->CC[0] = period_us;
+    p_trigger->SHORTS = TIMER_SHORTS_COMPARE0_CLEAR_Msk;
+    p_trigger->EVENTS_COMPARE[0] = 0;
+    p_trigger->TASKS_CLEAR = 1;
+
+    /* Counter TIMER stops sampling after the last sample. */
+    p_counter->TASKS_STOP = 1;
+    p_counter->INTENCLR = 0xFFFFFFFF;
+    p_counter->SHORTS = 0;
+    p_counter->MODE = TIMER_MODE_MODE_LowPowerCounter;
+    p_counter->BITMODE = TIMER_BITMODE_BITMODE_32Bit;
+    p_counter->CC[0] = n_samples;
+    p_counter->EVENTS_COMPARE[0] = 0;
+    p_counter->TASKS_CLEAR = 1;
+    p_counter->TASKS_START = 1;
+
+    nodi_ppi_channel_assign(p_smp->ppi_ch_trigger,
+                            (uint32_t)&p_trigger->EVENTS_COMPARE[0],
+                            (uint32_t)&p_reg->TASKS_START);
+    nodi_ppi_channel_assign(p_smp->ppi_ch_count,
+                            (uint32_t)&p_reg->EVENTS_END,
+                            (uint32_t)&p_counter->TASKS_COUNT);
+    nodi_ppi_channel_assign(p_smp->ppi_ch_done,
+                            (uint32_t)&p_counter->EVENTS_COMPARE[0],
+                            (uint32_t)&p_reg->TASKS_STOP);
+    nodi_ppi_channel_fork_assign(p_smp->ppi_ch_done, (uint32_t)&p_trigger->TASKS_STOP);
+
+    /* CS is asserted with START and released with END of every sample. */
+    if (p_smp->gpiote_cs_ch != NODI_SPIM_GPIOTE_NONE)
+    {
+        nodi_gpiote_task_config(p_smp->gpiote_cs_ch, &p_spim_drv->config->cs_pin, 1);
+        nodi_ppi_channel_fork_assign(p_smp->ppi_ch_trigger,
+                                     nodi_gpiote_clr_task_addr_get(p_smp->gpiote_cs_ch));
+        nodi_ppi_channel_fork_assign(p_smp->ppi_ch_count,
+                                     nodi_gpiote_set_task_addr_get(p_smp->gpiote_cs_ch));
+    }
+
+    /* The same command is sent every time, received data goes to the next array element. */
+    p_reg->TXD.PTR    = (uint32_t)p_txbuf;
+    p_reg->TXD.MAXCNT = n_tx;
+    p_reg->TXD.LIST   = SPIM_TXD_LIST_LIST_Disabled;
+    p_reg->RXD.PTR    = (uint32_t)p_rxbuf;
+    p_reg->RXD.MAXCNT = n_rx;
+    p_reg->RXD.LIST   = SPIM_RXD_LIST_LIST_ArrayList;
+
+    p_spim_drv->sampling = true;
+    p_spim_drv->spim_state = NODI_SPIM_DRV_STATE_BUSY;
+    p_reg->EVENTS_END = 0;
+    p_reg->EVENTS_STOPPED = 0;
+    p_reg->INTENCLR = SPIM_INTENCLR_END_Msk;
+    p_reg->INTENSET = SPIM_INTENSET_STOPPED_Msk;
+
+    nodi_ppi_channels_enable(NODI_PPI_CH_MSK(p_smp->ppi_ch_trigger) |
+                             NODI_PPI_CH_MSK(p_smp->ppi_ch_count)   |
+                             NODI_PPI_CH_MSK(p_smp->ppi_ch_done));
+    p_trigger->TASKS_START = 1;
+}
+
+void nodi_spim_sampling_stop(nodi_spim_drv_t *p_spim_drv)
+{
+    NODI_DRV_CHECK(p_spim_drv != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(p_spim_drv->config->p_sampling_cfg != NULL, "Sampling not configured!");
+
+    if (!p_spim_drv->sampling)
+    {
+        return;
+    }
+
+    /* STOP aborts sample in progress, it has no END so it is not counted. STOPPED event
+     * is handled in interrupt routine. */
+    p_spim_drv->config->p_sampling_cfg->p_trigger_timer_reg->TASKS_STOP = 1;
+    p_spim_drv->p_spim_reg->TASKS_STOP = 1;
+}
+
+uint32_t nodi_spim_sampling_count_get(nodi_spim_drv_t *p_spim_drv)
+{
+    NODI_DRV_CHECK(p_spim_drv != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(p_spim_drv->config->p_sampling_cfg != NULL, "Sampling not configured!");
+
+    NRF_TIMER_Type * p_counter = p_spim_drv->config->p_sampling_cfg->p_counter_timer_reg;
+    p_counter->TASKS_CAPTURE[1] = 1;
+    return p_counter->CC[1];
+}
+
+static void nodi_spim_sampling_stopped_handle(nodi_spim_drv_t *p_spim_drv)
+{
+    const nodi_spim_sampling_config_s *p_smp = p_spim_drv->config->p_sampling_cfg;
+    NRF_SPIM_Type * p_reg = p_spim_drv->p_spim_reg;
+
+    nodi_ppi_channels_disable(NODI_PPI_CH_MSK(p_smp->ppi_ch_trigger) |
+                              NODI_PPI_CH_MSK(p_smp->ppi_ch_count)   |
+                              NODI_PPI_CH_MSK(p_smp->ppi_ch_done));
+    p_smp->p_trigger_timer_reg->TASKS_STOP = 1;
+    /* Counter keeps its value for nodi_spim_sampling_count_get. */
+    p_smp->p_counter_timer_reg->TASKS_STOP = 1;
+
+    /* Return CS pin to GPIO control. */
+    if (p_smp->gpiote_cs_ch != NODI_SPIM_GPIOTE_NONE)
+    {
+        nodi_gpiote_channel_disable(p_smp->gpiote_cs_ch);
+    }
+
+    p_reg->INTENCLR = SPIM_INTENCLR_STOPPED_Msk;
+    p_reg->RXD.LIST = SPIM_RXD_LIST_LIST_Disabled;
+
+    p_spim_drv->sampling = false;
+    nodi_spim_end_handle(p_spim_drv);
+}
+
+static inline void nodi_spim_stream_ptr_set(NRF_SPIM_Type *p_reg,
+                                            nodi_spim_stream_buf_s *p_buf,
+                                            uint32_t n)
+{
+    p_reg->TXD.PTR    = (uint32_t)p_buf->p_txbuf;
+    p_reg->TXD.MAXCNT = p_buf->p_txbuf ? n : 0;
+    p_reg->RXD.PTR    = (uint32_t)p_buf->p_rxbuf;
+    p_reg->RXD.MAXCNT = p_buf->p_rxbuf ? n : 0;
+}
+
+void nodi_spim_stream_start(nodi_spim_drv_t *p_spim_drv,
+                            uint32_t n,
+                            nodi_spim_stream_buf_s *p_bufs,
+                            nodi_spim_stream_callback_t stream_cb)
+{
+    NODI_DRV_CHECK(p_spim_drv != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(p_bufs != NULL, "Buffers pointer is NULL!");
+    NODI_DRV_CHECK(stream_cb != NULL, "Callback pointer is NULL!");
+    NODI_DRV_CHECK(p_spim_drv->spim_state == NODI_SPIM_DRV_STATE_READY, "Driver is busy!");
+    NODI_DRV_CHECK((n != 0) && (n <= NODI_SPIM_MAXCNT), "Chunk length out of band!");
+
+    NRF_SPIM_Type * p_reg = p_spim_drv->p_spim_reg;
+
+    p_spim_drv->p_stream_bufs = p_bufs;
+    p_spim_drv->stream_cb = stream_cb;
+    p_spim_drv->stream_len = n;
+    p_spim_drv->stream_idx = 0;
+    p_spim_drv->stream_stop = false;
+
+    nodi_spim_stream_ptr_set(p_reg, &p_bufs[0], n);
+
+    p_spim_drv->spim_state = NODI_SPIM_DRV_STATE_BUSY;
+    p_reg->EVENTS_STARTED = 0;
+    p_reg->EVENTS_END = 0;
+    p_reg->SHORTS = SPIM_SHORTS_END_START_Msk;
+    p_reg->INTENSET = SPIM_INTENSET_STARTED_Msk | SPIM_INTENSET_END_Msk;
+    p_reg->TASKS_START = 1;
+}
+
+void nodi_spim_stream_stop(nodi_spim_drv_t *p_spim_drv)
+{
+    NODI_DRV_CHECK(p_spim_drv != NULL, "Driver pointer is NULL!");
+
+    if (p_spim_drv->p_stream_bufs == NULL)
+    {
+        return;
+    }
+
+    /* Chunk in progress is the last one. */
+    p_spim_drv->stream_stop = true;
+    p_spim_drv->p_spim_reg->SHORTS = 0;
+}
+
+static void nodi_spim_stream_irq_handle(nodi_spim_drv_t *p_spim_drv)
+{
+    NRF_SPIM_Type * p_reg = p_spim_drv->p_spim_reg;
+    nodi_spim_stream_buf_s *p_bufs = p_spim_drv->p_stream_bufs;
+
+    /* END is handled first. STARTED of the next chunk can be pending already. */
+    if (p_reg->EVENTS_END == 1)
+    {
+        uint8_t done = p_spim_drv->stream_idx;
+
+        p_reg->EVENTS_END = 0;
+        p_spim_drv->stream_idx ^= 1;
+
+        /* Short was removed before this END and next chunk was not started. */
+        if (p_spim_drv->stream_stop && (p_reg->EVENTS_STARTED == 0))
+        {
+            p_reg->INTENCLR = SPIM_INTENCLR_STARTED_Msk;
+            p_spim_drv->p_stream_bufs = NULL;
+            p_spim_drv->stream_cb(p_spim_drv, &p_bufs[done]);
+            nodi_spim_end_handle(p_spim_drv);
+            return;
+        }
+
+        p_spim_drv->stream_cb(p_spim_drv, &p_bufs[done]);
+    }
+
+    /* Registers are latched already, stage pointers of the chunk after the current one. */
+    if (p_reg->EVENTS_STARTED == 1)
+    {
+        p_reg->EVENTS_STARTED = 0;
+        nodi_spim_stream_ptr_set(p_reg, &p_bufs[p_spim_drv->stream_idx ^ 1],
+                                 p_spim_drv->stream_len);
+    }
+}
+
+static void nodi_spim_bus_settings_write(nodi_spim_drv_t *p_spim_drv,
+                                         const nodi_spim_dev_s *p_dev)
+{
+    NRF_SPIM_Type * p_reg = p_spim_drv->p_spim_reg;
+    nodi_spim_bus_stats_s *p_stats = &p_spim_drv->bus_stats;
+    uint32_t config = p_dev->bit_order | p_dev->mode;
+    uint32_t start = DWT->CYCCNT;
+
+    p_stats->dev_switches++;
+
+    if (p_spim_drv->bus_frequency != p_dev->frequency)
+    {
+        p_reg->FREQUENCY = p_dev->frequency;
+        p_spim_drv->bus_frequency = p_dev->frequency;
+        p_stats->reg_writes++;
+    }
+    else
+    {
+        p_stats->reg_writes_saved++;
+    }
+
+    if (p_spim_drv->bus_config != config)
+    {
+        p_reg->CONFIG = config;
+        p_spim_drv->bus_config = config;
+        p_stats->reg_writes++;
+    }
+    else
+    {
+        p_stats->reg_writes_saved++;
+    }
+
+    if (p_spim_drv->bus_orc != p_dev->orc)
+    {
+        p_reg->ORC = p_dev->orc;
+        p_spim_drv->bus_orc = p_dev->orc;
+        p_stats->reg_writes++;
+    }
+    else
+    {
+        p_stats->reg_writes_saved++;
+    }
+
+    p_spim_drv->p_bus_dev = p_dev;
+    p_stats->reconf_cycles += DWT->CYCCNT - start;
+}
+
+static inline void nodi_spim_bus_settings_update(nodi_spim_drv_t *p_spim_drv,
+                                                 const nodi_spim_dev_s *p_dev)
+{
+    if (p_dev == NULL)
+    {
+        return;
+    }
+
+    /* The same device as previously, FREQUENCY, CONFIG and ORC are untouched. */
+    if (p_dev == p_spim_drv->p_bus_dev)
+    {
+        p_spim_drv->bus_stats.reg_writes_saved += 3;
+        return;
+    }
+    nodi_spim_bus_settings_write(p_spim_drv, p_dev);
+}
+
+/* Starts the next chunk of transaction. Transactions longer than NODI_SPIM_MAXCNT are
+ * split, so other lane can take the bus between chunks. */
+static void nodi_spim_queue_chunk_start(nodi_spim_drv_t *p_spim_drv,
+                                        nodi_spim_xfer_desc_t *p_desc,
+                                        bool frame_start)
+{
+    NRF_SPIM_Type * p_reg = p_spim_drv->p_spim_reg;
+    uint32_t done = p_desc->done;
+    uint32_t n_tx = p_desc->n_tx > done ? p_desc->n_tx - done : 0;
+    uint32_t n_rx = p_desc->n_rx > done ? p_desc->n_rx - done : 0;
+    uint32_t tx_ptr = (uint32_t)p_desc->p_txbuf + done;
+
+    if (frame_start)
+    {
+        nodi_spim_bus_settings_update(p_spim_drv, p_desc->p_dev);
+
+        if (p_desc->p_cs_pin != NULL)
+        {
+            nodi_gpio_clr(p_desc->p_cs_pin->p_port, p_desc->p_cs_pin->pin);
+        }
+        if (p_desc->p_dc_pin != NULL)
+        {
+            nodi_gpio_clr(p_desc->p_dc_pin->p_port, p_desc->p_dc_pin->pin);
+        }
+    }
+
+    /* ArrayList advances PTR by MAXCNT only, strided rows are pointed one by one. */
+    if ((p_desc->tx_row != 0) && (n_tx != 0))
+    {
+        uint32_t off = done % p_desc->tx_row;
+        tx_ptr = (uint32_t)p_desc->p_txbuf + (done / p_desc->tx_row) * p_desc->tx_stride + off;
+        n_tx = n_tx > p_desc->tx_row - off ? p_desc->tx_row - off : n_tx;
+    }
+
+    n_tx = n_tx > NODI_SPIM_MAXCNT ? NODI_SPIM_MAXCNT : n_tx;
+    n_rx = n_rx > NODI_SPIM_MAXCNT ? NODI_SPIM_MAXCNT : n_rx;
+    p_spim_drv->queue_chunk = n_tx > n_rx ? n_tx : n_rx;
+
+    p_reg->TXD.PTR    = n_tx ? tx_ptr : (uint32_t)p_desc->p_txbuf;
+    p_reg->TXD.MAXCNT = n_tx;
+    p_reg->RXD.PTR    = n_rx ? (uint32_t)p_desc->p_rxbuf + done : (uint32_t)p_desc->p_rxbuf;
+    p_reg->RXD.MAXCNT = n_rx;
+
+    p_reg->EVENTS_END = 0;
+    p_reg->TASKS_START = 1;
+}
+
+static void nodi_spim_queue_frame_end(nodi_spim_xfer_desc_t *p_desc, bool cs_keep)
+{
+    if ((p_desc->p_cs_pin != NULL) && !cs_keep)
+    {
+        nodi_gpio_set(p_desc->p_cs_pin->p_port, p_desc->p_cs_pin->pin);
+    }
+    if (p_desc->p_dc_pin != NULL)
+    {
+        nodi_gpio_set(p_desc->p_dc_pin->p_port, p_desc->p_dc_pin->pin);
+    }
+}
+
+void nodi_spim_queue_push(nodi_spim_drv_t *p_spim_drv, nodi_spim_xfer_desc_t *p_desc)
+{
+    NODI_DRV_CHECK(p_spim_drv != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(p_desc != NULL, "Descriptor pointer is NULL!");
+    NODI_DRV_CHECK(p_desc->lane < NODI_SPIM_LANE_COUNT, "Lane does not exist!");
+    NODI_DRV_CHECK(p_spim_drv->spim_state != NODI_SPIM_DRV_STATE_UNINIT,
+                  "Driver is not initialized!");
+
+    NRF_SPIM_Type * p_reg = p_spim_drv->p_spim_reg;
+    uint8_t lane = p_desc->lane;
+    uint32_t primask;
+    p_desc->p_next = NULL;
+    p_desc->done = 0;
+
+    /* Interrupt routine and pushes from other priorities modify queue too. */
+    primask = nodi_common_critical_enter();
+
+    if (p_spim_drv->p_queue_tail[lane] == NULL)
+    {
+        p_spim_drv->p_queue_head[lane] = p_desc;
+    }
+    else
+    {
+        p_spim_drv->p_queue_tail[lane]->p_next = p_desc;
+    }
+    p_spim_drv->p_queue_tail[lane] = p_desc;
+
+    if (p_spim_drv->p_queue_cur == NULL)
+    {
+        NODI_DRV_CHECK(p_spim_drv->spim_state != NODI_SPIM_DRV_STATE_BUSY,
+                      "Driver is busy!");
+        p_spim_drv->p_queue_cur = p_desc;
+        p_spim_drv->spim_state = NODI_SPIM_DRV_STATE_BUSY;
+        p_reg->INTENSET = SPIM_INTENSET_END_Msk;
+        nodi_spim_queue_chunk_start(p_spim_drv, p_desc, true);
+    }
+
+    nodi_common_critical_exit(primask);
+}
+
+uint32_t nodi_spim_queue_busy_check(nodi_spim_drv_t *p_spim_drv)
+{
+    NODI_DRV_CHECK(p_spim_drv != NULL, "Driver pointer is NULL!");
+    return p_spim_drv->p_queue_cur != NULL ? 1 : 0;
+}
+
+static void nodi_spim_queue_end_handle(nodi_spim_drv_t *p_spim_drv)
+{
+    NRF_SPIM_Type * p_reg = p_spim_drv->p_spim_reg;
+    nodi_spim_xfer_desc_t *p_cur = p_spim_drv->p_queue_cur;
+    nodi_spim_xfer_desc_t *p_next;
+    uint8_t lane = p_cur->lane;
+    uint32_t total = p_cur->n_tx > p_cur->n_rx ? p_cur->n_tx : p_cur->n_rx;
+    uint32_t primask;
+    bool finished;
+
+    /* Next chunk overwrites captured values. */
+    if (p_spim_drv->config->p_ts_cfg != NULL)
+    {
+        uint32_t t_started;
+        nodi_spim_timestamps_get(p_spim_drv, &t_started, &p_cur->t_end);
+        if (p_cur->done == 0)
+        {
+            p_cur->t_started = t_started;
+        }
+    }
+
+    p_cur->done += p_spim_drv->queue_chunk;
+    finished = p_cur->done >= total;
+
+    /* Higher priority push can append to the queue in the meantime. */
+    primask = nodi_common_critical_enter();
+
+    if (finished)
+    {
+        p_spim_drv->p_queue_head[lane] = p_cur->p_next;
+        if (p_cur->p_next == NULL)
+        {
+            p_spim_drv->p_queue_tail[lane] = NULL;
+        }
+    }
+
+    /* Frame held by CS cannot be broken by other lane, started transaction neither unless
+     * it is preemptible. Otherwise urgent lane goes first. */
+    if (p_cur->cs_hold)
+    {
+        p_next = finished ? p_spim_drv->p_queue_head[lane] : p_cur;
+    }
+    else if (!finished && !p_cur->preemptible)
+    {
+        p_next = p_cur;
+    }
+    else
+    {
+        p_next = p_spim_drv->p_queue_head[NODI_SPIM_LANE_URGENT];
+        if (p_next == NULL)
+        {
+            p_next = p_spim_drv->p_queue_head[NODI_SPIM_LANE_NORMAL];
+        }
+    }
+
+    /* Preempted transaction releases CS too and asserts it again when resumed. */
+    if (p_next != p_cur)
+    {
+        nodi_spim_queue_frame_end(p_cur, finished && p_cur->cs_hold);
+    }
+
+    /* Start next chunk before calling callback to keep gap between transfers short. */
+    p_spim_drv->p_queue_cur = p_next;
+    if (p_next != NULL)
+    {
+        nodi_spim_queue_chunk_start(p_spim_drv, p_next, p_next != p_cur);
+    }
+    else
+    {
+        p_spim_drv->spim_state = NODI_SPIM_DRV_STATE_READY;
+        p_reg->INTENCLR = SPIM_INTENCLR_END_Msk;
+    }
+    nodi_common_critical_exit(primask);
+
+    /* Descriptor belongs to the application again. Callback can push it once more. */
+    if (finished && p_cur->xfer_cb)
+    {
+        p_cur->xfer_cb(p_spim_drv, p_cur);
+    }
+}
+
+void nodi_spim_bus_dev_apply(nodi_spim_drv_t *p_spim_drv, const nodi_spim_dev_s *p_dev)
+{
+    NODI_DRV_CHECK(p_spim_drv != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(p_dev != NULL, "Device pointer is NULL!");
+    NODI_DRV_CHECK(p_spim_drv->spim_state == NODI_SPIM_DRV_STATE_READY, "Driver is busy!");
+    NODI_DRV_CHECK(((p_dev->frequency != NODI_SPIM_FREQ_16M) &&
+                    (p_dev->frequency != NODI_SPIM_FREQ_32M)) ||
+                   (p_spim_drv->p_spim_reg == NRF_SPIM3),
+                   "Frequency available only on SPIM3!");
+
+    nodi_spim_bus_settings_update(p_spim_drv, p_dev);
+}
+
+void nodi_spim_bus_push(nodi_spim_drv_t *p_spim_drv,
+                        const nodi_spim_dev_s *p_dev,
+                        nodi_spim_xfer_desc_t *p_desc)
+{
+    NODI_DRV_CHECK(p_dev != NULL, "Device pointer is NULL!");
+    NODI_DRV_CHECK(p_desc != NULL, "Descriptor pointer is NULL!");
+    NODI_DRV_CHECK(((p_dev->frequency != NODI_SPIM_FREQ_16M) &&
+                    (p_dev->frequency != NODI_SPIM_FREQ_32M)) ||
+                   (p_spim_drv->p_spim_reg == NRF_SPIM3),
+                   "Frequency available only on SPIM3!");
+
+    p_desc->p_dev = p_dev;
+    p_desc->p_cs_pin = (p_dev->cs_pin.p_port != NULL) ? &p_dev->cs_pin : NULL;
+    nodi_spim_queue_push(p_spim_drv, p_desc);
+}
+
+const nodi_spim_bus_stats_s *nodi_spim_bus_stats_get(nodi_spim_drv_t *p_spim_drv)
+{
+    NODI_DRV_CHECK(p_spim_drv != NULL, "Driver pointer is NULL!");
+    return &p_spim_drv->bus_stats;
+}
+
+void nodi_spim_bus_stats_clear(nodi_spim_drv_t *p_spim_drv)
+{
+    NODI_DRV_CHECK(p_spim_drv != NULL, "Driver pointer is NULL!");
+    p_spim_drv->bus_stats.dev_switches = 0;
+    p_spim_drv->bus_stats.reg_writes = 0;
+    p_spim_drv->bus_stats.reg_writes_saved = 0;
+    p_spim_drv->bus_stats.reconf_cycles = 0;
+}
+
+void nodi_spim_timestamps_get(nodi_spim_drv_t *p_spim_drv, uint32_t *p_started, uint32_t *p_end)
+{
+    NODI_DRV_CHECK(p_spim_drv != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(p_spim_drv->config->p_ts_cfg != NULL, "Timestamps not configured!");
+
+    const nodi_spim_ts_config_s *p_ts = p_spim_drv->config->p_ts_cfg;
+    *p_started = p_ts->p_timer_reg->CC[p_ts->cc_started];
+    *p_end = p_ts->p_timer_reg->CC[p_ts->cc_end];
+}
+
 void nodi_spim_xfer_configure(nodi_spim_drv_t *p_spim_drv,
                               uint32_t n_tx,
                               const void *p_txbuf,
@@ -238,14 +1163,14 @@ uint32_t nodi_spim_start_task_addr_get(nodi_spim_drv_t *p_spim_drv)
 {
     NODI_DRV_CHECK(p_spim_drv != NULL, "Driver pointer is NULL!");
     NRF_SPIM_Type * p_reg = p_spim_drv->p_spim_reg;
-    return p_reg->TASKS_START;
+    return (uint32_t)&p_reg->TASKS_START;
 }
 
 uint32_t nodi_spim_end_evt_addr_get(nodi_spim_drv_t *p_spim_drv)
 {
     NODI_DRV_CHECK(p_spim_drv != NULL, "Driver pointer is NULL!");
     NRF_SPIM_Type * p_reg = p_spim_drv->p_spim_reg;
-    return p_reg->EVENTS_END;
+    return (uint32_t)&p_reg->EVENTS_END;
 }
 
 void nodi_spim_irq_routine(void *p_ctx)
@@ -255,24 +1180,40 @@ void nodi_spim_irq_routine(void *p_ctx)
     nodi_spim_drv_t *p_spim_drv = (nodi_spim_drv_t *)p_ctx;
     NRF_SPIM_Type * p_reg = p_spim_drv->p_spim_reg;
 
-    if (p_reg->EVENTS_END == 1)
+    /* Continuous streaming uses STARTED and END of every chunk. */
+    if (p_spim_drv->p_stream_bufs != NULL)
     {
-        p_reg->EVENTS_END = 0;
-        /* Set finish state to indicate operation end. */
-        p_spim_drv->spim_state = NODI_SPIM_DRV_STATE_FINISH;
+        nodi_spim_stream_irq_handle(p_spim_drv);
+        return;
+    }
 
-        /* Call callback if not null. */
-        if (p_spim_drv->config->end_cb)
+    /* Large transfer finished its ArrayList part or autonomous sampling is over. */
+    if ((p_reg->EVENTS_STOPPED == 1) && (p_reg->INTENSET & SPIM_INTENSET_STOPPED_Msk))
+    {
+        p_reg->EVENTS_STOPPED = 0;
+        if (p_spim_drv->sampling)
+        {
+            nodi_spim_sampling_stopped_handle(p_spim_drv);
+        }
+        else
         {
-            p_spim_drv->config->end_cb(p_spim_drv);
+            nodi_spim_large_stopped_handle(p_spim_drv);
         }
+    }
 
-        /* Callback can start next transmission. Checking... */
-        if (p_spim_drv->spim_state == NODI_SPIM_DRV_STATE_FINISH)
+    /* END is generated by every chunk of large transfer. Check if it is expected. */
+    if ((p_reg->EVENTS_END == 1) && (p_reg->INTENSET & SPIM_INTENSET_END_Msk))
+    {
+        p_reg->EVENTS_END = 0;
+
+        /* Queued transactions have their own callbacks. */
+        if (p_spim_drv->p_queue_cur != NULL)
         {
-            p_spim_drv->spim_state = NODI_SPIM_DRV_STATE_READY;
-            p_reg->INTENCLR = SPIM_INTENCLR_END_Msk;
+            nodi_spim_queue_end_handle(p_spim_drv);
+            return;
         }
+
+        nodi_spim_end_handle(p_spim_drv);
     }
 }
 
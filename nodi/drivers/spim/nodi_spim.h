@@ -46,6 +46,13 @@
 #define NODI_SPIM_USE_SPIM3 0
 #endif
 
+/**
+ * @brief Longest transfer time in nanoseconds completed by polling in nodi_spim_exchange_auto.
+ */
+#if !defined(NODI_SPIM_POLL_MAX_NS) || defined(__DOXYGEN__)
+#define NODI_SPIM_POLL_MAX_NS 4000
+#endif
+
 typedef struct nodi_spim_drv nodi_spim_drv_t;
 
 /**
@@ -55,6 +62,154 @@ typedef struct nodi_spim_drv nodi_spim_drv_t;
  */
 typedef void (*nodi_spim_irq_callback_t)(nodi_spim_drv_t *p_spim_drv);
 
+typedef struct nodi_spim_xfer_desc nodi_spim_xfer_desc_t;
+
+/**
+ * @brief   SPIM queue priority lanes.
+ */
+typedef enum {
+    NODI_SPIM_LANE_NORMAL, ///< Default lane.
+    NODI_SPIM_LANE_URGENT, ///< Served first, also between chunks of normal lane transaction.
+    NODI_SPIM_LANE_COUNT,  ///< Number of lanes.
+} nodi_spim_lane_t;
+
+/**
+ * @brief   Buffer pair used by continuous streaming.
+ */
+typedef struct {
+    const void               *p_txbuf;   ///< Output data buffer or NULL to send ORC only.
+    void                     *p_rxbuf;   ///< Input data buffer or NULL to ignore input data.
+} nodi_spim_stream_buf_s;
+
+/**
+ * @brief   SPIM streaming callback type.
+ *
+ * @param[in] p_spim_drv      pointer to the nodi_spim_drv_t object triggering the callback
+ * @param[in] p_buf           pointer to the finished buffer pair, owned by application
+ *                            until the next chunk is finished
+ */
+typedef void (*nodi_spim_stream_callback_t)(nodi_spim_drv_t *p_spim_drv,
+                                            nodi_spim_stream_buf_s *p_buf);
+
+/**
+ * @brief   SPI device sharing the bus with other devices.
+ *
+ * @details Bus settings are written to SPIM only if they differ from settings of
+ *          the previous transaction.
+ */
+typedef struct {
+    nodi_gpio_pin_t           cs_pin;    ///< CS pin config structure
+    uint32_t                  frequency; ///< SPIM frequency
+    uint32_t                  mode;      ///< SPI mode (0,1,2,3)
+    uint32_t                  bit_order; ///< Bit order (MSB, LSB)
+    uint8_t                   orc;       ///< Overrun character sending
+} nodi_spim_dev_s;
+
+/**
+ * @brief   Bus manager counters.
+ */
+typedef struct {
+    uint32_t                  dev_switches;    ///< Transactions addressed to other device than previous one.
+    uint32_t                  reg_writes;      ///< Bus settings registers written.
+    uint32_t                  reg_writes_saved;///< Bus settings registers left untouched.
+    uint32_t                  reconf_cycles;   ///< CPU cycles spent on reconfiguration (DWT CYCCNT).
+} nodi_spim_bus_stats_s;
+
+/**
+ * @brief   SPIM queued transaction callback type.
+ *
+ * @param[in] p_spim_drv      pointer to the nodi_spim_drv_t object triggering the callback
+ * @param[in] p_desc          pointer to the finished transaction descriptor
+ */
+typedef void (*nodi_spim_xfer_callback_t)(nodi_spim_drv_t *p_spim_drv,
+                                          nodi_spim_xfer_desc_t *p_desc);
+
+/**
+ * @brief   SPIM queued transaction descriptor.
+ *
+ * @details Descriptor memory is owned by the application and must stay valid until
+ *          the transaction callback is called.
+ */
+struct nodi_spim_xfer_desc {
+    nodi_spim_xfer_desc_t    *p_next;      ///< Next queued transaction. Managed by driver.
+    const void               *p_txbuf;     ///< Output data buffer.
+    void                     *p_rxbuf;     ///< Input data buffer.
+    uint32_t                  n_tx;        ///< Output data length.
+    uint32_t                  n_rx;        ///< Input data length.
+    uint32_t                  tx_row;      ///< Output row length of strided buffer or 0 if contiguous.
+    uint32_t                  tx_stride;   ///< Distance between output rows of strided buffer.
+    const nodi_gpio_pin_t    *p_cs_pin;    ///< CS pin driven around transaction or NULL.
+    const nodi_spim_dev_s    *p_dev;       ///< Target device or NULL to keep bus settings.
+    bool                      cs_hold;     ///< Keep CS asserted, next queued transaction continues frame.
+    bool                      preemptible; ///< Urgent lane can break in between chunks, CS toggles mid-payload.
+    const nodi_gpio_pin_t    *p_dc_pin;    ///< Data/command pin driven low during transaction or NULL.
+    uint8_t                   lane;        ///< Priority lane (nodi_spim_lane_t).
+    uint32_t                  done;        ///< Bytes already transferred. Managed by driver.
+    nodi_spim_xfer_callback_t xfer_cb;     ///< Transaction complete callback or NULL.
+    void                     *p_context;   ///< Application context, not used by driver.
+    uint32_t                  t_started;   ///< TIMER value captured on STARTED, if timestamps configured.
+    uint32_t                  t_end;       ///< TIMER value captured on END, if timestamps configured.
+};
+
+/**
+ * @brief   Resources used by large transfers and fills.
+ *
+ * @details Chunks of a large transfer are chained by PPI. TIMER counts END events,
+ *          breaks the chain before the last chunk and stops SPIM after it.
+ */
+typedef struct {
+    NRF_TIMER_Type           *p_timer_reg;    ///< TIMER used as chunk counter.
+    uint8_t                   ppi_ch_count;   ///< PPI channel: SPIM END -> TIMER COUNT.
+    uint8_t                   ppi_ch_restart; ///< PPI channel: SPIM END -> SPIM START.
+    uint8_t                   ppi_ch_break;   ///< PPI channel: TIMER COMPARE[0] -> group disable.
+    uint8_t                   ppi_ch_done;    ///< PPI channel: TIMER COMPARE[1] -> SPIM STOP.
+    uint8_t                   ppi_group;      ///< PPI group holding restart channel.
+    uint8_t                  *p_sink_buf;     ///< Buffer for input data dropped by fill or NULL.
+    uint8_t                   sink_len;       ///< Sink length, fill chunk length.
+} nodi_spim_list_config_s;
+
+/**
+ * @brief   Resources used by hardware timestamps.
+ *
+ * @details SPIM STARTED and END events capture free running TIMER through PPI.
+ */
+typedef struct {
+    NRF_TIMER_Type           *p_timer_reg;    ///< Free running TIMER, started by driver.
+    uint8_t                   prescaler;      ///< TIMER prescaler, tick is 2^prescaler/16 us.
+    uint8_t                   cc_started;     ///< CC register capturing STARTED.
+    uint8_t                   cc_end;         ///< CC register capturing END.
+    uint8_t                   ppi_ch_started; ///< PPI channel: SPIM STARTED -> TIMER CAPTURE.
+    uint8_t                   ppi_ch_end;     ///< PPI channel: SPIM END -> TIMER CAPTURE.
+} nodi_spim_ts_config_s;
+
+/**
+ * @brief   Resources used by autonomous sampling.
+ *
+ * @details Trigger TIMER starts SPIM every sampling period and counter TIMER counts
+ *          finished samples. CS pin is driven by GPIOTE, unless hardware CSN is used.
+ */
+typedef struct {
+    NRF_TIMER_Type           *p_trigger_timer_reg; ///< TIMER generating sampling period.
+    NRF_TIMER_Type           *p_counter_timer_reg; ///< TIMER used as sample counter.
+    uint8_t                   ppi_ch_trigger; ///< PPI channel: trigger COMPARE[0] -> SPIM START.
+    uint8_t                   ppi_ch_count;   ///< PPI channel: SPIM END -> counter COUNT.
+    uint8_t                   ppi_ch_done;    ///< PPI channel: counter COMPARE[0] -> SPIM STOP.
+    uint8_t                   gpiote_cs_ch;   ///< GPIOTE channel driving cs_pin or NODI_SPIM_GPIOTE_NONE.
+} nodi_spim_sampling_config_s;
+
+/**
+ * @brief   SPIM3 extended features configuration.
+ *
+ * @details Unused pins should have p_port set to NULL.
+ */
+typedef struct {
+    nodi_gpio_pin_t           csn_pin;   ///< Hardware CSN pin config structure
+    uint32_t                  csn_pol;   ///< Hardware CSN polarity
+    uint8_t                   csn_dur;   ///< CSN to SCK edge and CSN inactive time in 64 MHz cycles
+    uint8_t                   rx_delay;  ///< MISO sample delay in 64 MHz cycles (0-7)
+    nodi_gpio_pin_t           dcx_pin;   ///< Command/data (DCX) pin config structure
+} nodi_spim_ext_config_s;
+
 typedef struct {
     nodi_spim_irq_callback_t  end_cb;    ///< Operation complete callback NULL.
     nodi_gpio_pin_t           sck_pin;   ///< SCK pin config structure
@@ -65,6 +220,10 @@ typedef struct {
     uint32_t                  mode;      ///< SPI mode (0,1,2,3)
     uint32_t                  bit_order; ///< Bit order (MSB, LSB)
     uint8_t                   orc;       ///< Overrun character sending
+    const nodi_spim_list_config_s *p_list_cfg; ///< Large transfer resources or NULL.
+    const nodi_spim_ext_config_s  *p_ext_cfg;  ///< SPIM3 extended features or NULL.
+    const nodi_spim_sampling_config_s *p_sampling_cfg; ///< Autonomous sampling resources or NULL.
+    const nodi_spim_ts_config_s   *p_ts_cfg;   ///< Hardware timestamps resources or NULL.
 } nodi_spim_config_s;
 
 /**
@@ -86,6 +245,25 @@ struct nodi_spim_drv {
     NRF_SPIM_Type             *p_spim_reg;   ///< Pointer to the SPIM registers block.
     IRQn_Type                  irq;          ///< SPIM peripheral instance IRQ number.
     uint8_t                    irq_priority; ///< Interrupt priority.
+    nodi_spim_xfer_desc_t     *p_queue_head[NODI_SPIM_LANE_COUNT]; ///< First queued transaction of lane or NULL.
+    nodi_spim_xfer_desc_t     *p_queue_tail[NODI_SPIM_LANE_COUNT]; ///< Last queued transaction of lane or NULL.
+    nodi_spim_xfer_desc_t     *p_queue_cur;  ///< Queued transaction in progress or NULL.
+    uint32_t                   queue_chunk;  ///< Length of chunk in progress.
+    const uint8_t             *p_large_tx;   ///< Large transfer output remainder or NULL.
+    uint8_t                   *p_large_rx;   ///< Large transfer input remainder or NULL.
+    uint32_t                   large_rem;    ///< Large transfer remainder length.
+    bool                       fill;         ///< Fill in progress, ORC is restored at its end.
+    volatile bool              sampling;     ///< Autonomous sampling in progress.
+    const nodi_spim_dev_s     *p_bus_dev;    ///< Device bus settings are applied for or NULL.
+    uint32_t                   bus_frequency;///< FREQUENCY register shadow.
+    uint32_t                   bus_config;   ///< CONFIG register shadow.
+    uint8_t                    bus_orc;      ///< ORC register shadow.
+    nodi_spim_bus_stats_s      bus_stats;    ///< Bus manager counters.
+    nodi_spim_stream_buf_s    *p_stream_bufs;///< Streaming buffer pairs (2 elements) or NULL.
+    nodi_spim_stream_callback_t stream_cb;   ///< Streaming chunk complete callback.
+    uint32_t                   stream_len;   ///< Streaming chunk length.
+    uint8_t                    stream_idx;   ///< Buffer pair in flight.
+    volatile bool              stream_stop;  ///< Streaming stop requested.
 };
 
 /*===========================================================================*/
@@ -126,6 +304,8 @@ void nodi_spim_init(nodi_spim_drv_t *p_spim_drv);
 /**
  * @brief Selects chip select pin.
  *
+ * Does nothing when hardware CSN is configured.
+ *
  * @param[in] p_spim_drv        Pointer to structure representing SPIM driver.
  */
 void nodi_spim_select(nodi_spim_drv_t *p_spim_drv);
@@ -133,10 +313,22 @@ void nodi_spim_select(nodi_spim_drv_t *p_spim_drv);
 /**
  * @brief Deselects chip select pin.
  *
+ * Does nothing when hardware CSN is configured.
+ *
  * @param[in] p_spim_drv        Pointer to structure representing SPIM driver.
  */
 void nodi_spim_unselect(nodi_spim_drv_t *p_spim_drv);
 
+/**
+ * @brief Sets number of command bytes at the beginning of next transfers (SPIM3 only).
+ *
+ * DCX pin is held low during command bytes and high during data bytes.
+ *
+ * @param[in] p_spim_drv        Pointer to structure representing SPIM driver.
+ * @param[in] n_cmd             Command bytes count (0-14) or NODI_SPIM_DCX_CNT_ALL_CMD.
+ */
+void nodi_spim_dcx_cnt_set(nodi_spim_drv_t *p_spim_drv, uint32_t n_cmd);
+
 /**
  * @brief   Exchanges data using SPIM peripheral.
  *
@@ -152,6 +344,46 @@ void nodi_spim_exchange(nodi_spim_drv_t *p_spim_drv,
                        uint32_t n_rx,
                        void *p_rxbuf);
 
+/**
+ * @brief   Exchanges data using SPIM peripheral and waits for the end of transfer.
+ *
+ * @details END interrupt is disabled during the transfer and end_cb is not called.
+ *          Intended for short register accesses where interrupt handling costs
+ *          more than the transfer itself.
+ *
+ * @param[in]  p_spim_drv       Pointer to structure representing SPIM driver.
+ * @param[in]  n_tx             Output data length.
+ * @param[out] p_txbuf          Output data buffer.
+ * @param[in]  n_rx             Input data length.
+ * @param[in]  p_rxbuf          Input data buffer.
+ */
+void nodi_spim_exchange_polled(nodi_spim_drv_t *p_spim_drv,
+                               uint32_t n_tx,
+                               const void *p_txbuf,
+                               uint32_t n_rx,
+                               void *p_rxbuf);
+
+/**
+ * @brief   Exchanges data choosing polled or interrupt driven completion.
+ *
+ * @details Transfer is polled when its duration at configured frequency does not
+ *          exceed NODI_SPIM_POLL_MAX_NS. In both cases end_cb is called, for polled
+ *          transfer before this function returns.
+ *
+ * @param[in]  p_spim_drv       Pointer to structure representing SPIM driver.
+ * @param[in]  n_tx             Output data length.
+ * @param[out] p_txbuf          Output data buffer.
+ * @param[in]  n_rx             Input data length.
+ * @param[in]  p_rxbuf          Input data buffer.
+ *
+ * @return 1 if transfer was polled and is finished, 0 if it is interrupt driven.
+ */
+uint32_t nodi_spim_exchange_auto(nodi_spim_drv_t *p_spim_drv,
+                                 uint32_t n_tx,
+                                 const void *p_txbuf,
+                                 uint32_t n_rx,
+                                 void *p_rxbuf);
+
 /**
  * @brief Sends data using SPIM peripheral.
  *
@@ -170,6 +402,197 @@ void nodi_spim_send(nodi_spim_drv_t *p_spim_drv, uint32_t n, const void *p_txbuf
  */
 void nodi_spim_receive(nodi_spim_drv_t *p_spim_drv, uint32_t n, void *p_rxbuf);
 
+/**
+ * @brief   Exchanges buffers longer than a single EasyDMA transfer.
+ *
+ * @details Buffers are sent as NODI_SPIM_MAXCNT long chunks using EasyDMA ArrayList.
+ *          Chunks are started by hardware, so CPU is woken up only after the last
+ *          chunk and once more if length is not a multiple of the chunk length.
+ *          end_cb is called once for the whole operation. Requires p_list_cfg in
+ *          driver's configuration.
+ *
+ * @param[in]  p_spim_drv       Pointer to structure representing SPIM driver.
+ * @param[in]  n                Data length in both directions.
+ * @param[out] p_txbuf          Output data buffer or NULL to send ORC only.
+ * @param[in]  p_rxbuf          Input data buffer or NULL to ignore input data.
+ */
+void nodi_spim_exchange_large(nodi_spim_drv_t *p_spim_drv,
+                              uint32_t n,
+                              const void *p_txbuf,
+                              void *p_rxbuf);
+
+/**
+ * @brief   Sends the same byte n times without source buffer.
+ *
+ * @details Byte is set as ORC and clocked out with zero output data length. EasyDMA
+ *          writes input data anyway, so every chunk drops it to the same sink buffer
+ *          from p_list_cfg. Chunks are chained by hardware like in large transfers.
+ *          end_cb is called once for the whole operation. ORC is set back to config->orc
+ *          when the fill is finished.
+ *
+ * @param[in]  p_spim_drv       Pointer to structure representing SPIM driver.
+ * @param[in]  value            Fill byte.
+ * @param[in]  n                Number of bytes to send.
+ */
+void nodi_spim_fill(nodi_spim_drv_t *p_spim_drv, uint8_t value, uint32_t n);
+
+/**
+ * @brief   Starts autonomous sampling.
+ *
+ * @details Every period_us the same output data is sent and n_rx bytes are received into
+ *          the next element of p_rxbuf array. Samples are started, counted and stopped by
+ *          TIMERs and PPI, so CPU is woken up only once, when n_samples samples are in RAM.
+ *          end_cb is called then. Requires p_sampling_cfg in driver's configuration.
+ *
+ * @param[in]  p_spim_drv       Pointer to structure representing SPIM driver.
+ * @param[in]  period_us        Sampling period in microseconds.
+ * @param[in]  n_tx             Output data length of single sample.
+ * @param[out] p_txbuf          Output data buffer sent in every sample.
+ * @param[in]  n_rx             Input data length of single sample.
+ * @param[in]  p_rxbuf          Input data array, n_samples elements n_rx bytes long.
+ * @param[in]  n_samples        Number of samples.
+ */
+void nodi_spim_sampling_start(nodi_spim_drv_t *p_spim_drv,
+                              uint32_t period_us,
+                              uint32_t n_tx,
+                              const void *p_txbuf,
+                              uint32_t n_rx,
+                              void *p_rxbuf,
+                              uint32_t n_samples);
+
+/**
+ * @brief Stops autonomous sampling before all samples are collected.
+ *
+ * Sample in progress is aborted. Its array element may be partially written and it is
+ * not included in nodi_spim_sampling_count_get. end_cb is called from interrupt routine
+ * when SPIM is stopped.
+ *
+ * @param[in] p_spim_drv        Pointer to structure representing SPIM driver.
+ */
+void nodi_spim_sampling_stop(nodi_spim_drv_t *p_spim_drv);
+
+/**
+ * @brief Returns number of samples collected by the current or last autonomous sampling.
+ *
+ * @param[in] p_spim_drv        Pointer to structure representing SPIM driver.
+ *
+ * @return Number of samples in RAM.
+ */
+uint32_t nodi_spim_sampling_count_get(nodi_spim_drv_t *p_spim_drv);
+
+/**
+ * @brief   Starts continuous full-duplex streaming.
+ *
+ * @details Chunks are exchanged back-to-back using END_START short, alternately with
+ *          both buffer pairs. Pointers of the next pair are loaded on STARTED event of
+ *          the current chunk, so there is no gap between chunks. stream_cb hands over
+ *          every finished pair and application has time of one chunk to process it.
+ *
+ * @param[in] p_spim_drv        Pointer to structure representing SPIM driver.
+ * @param[in] n                 Chunk length in both directions.
+ * @param[in] p_bufs            Array of two buffer pairs.
+ * @param[in] stream_cb         Chunk complete callback.
+ */
+void nodi_spim_stream_start(nodi_spim_drv_t *p_spim_drv,
+                            uint32_t n,
+                            nodi_spim_stream_buf_s *p_bufs,
+                            nodi_spim_stream_callback_t stream_cb);
+
+/**
+ * @brief Stops continuous streaming.
+ *
+ * Chunk in progress is finished and handed over by stream_cb, then end_cb is called.
+ *
+ * @param[in] p_spim_drv        Pointer to structure representing SPIM driver.
+ */
+void nodi_spim_stream_stop(nodi_spim_drv_t *p_spim_drv);
+
+/**
+ * @brief Appends transaction to the driver's queue.
+ *
+ * Queued transactions are executed back-to-back. Next transaction is started directly
+ * from the interrupt routine before the callback of the finished one is called.
+ * Function can be called from the transaction callback and from any interrupt priority.
+ *
+ * Output buffer can be strided: n_tx bytes are taken in rows of tx_row bytes placed
+ * tx_stride bytes apart, like a rectangle of a framebuffer. Every row is sent as
+ * separate chunk within the same transaction.
+ *
+ * Transactions longer than NODI_SPIM_MAXCNT are sent in chunks. Urgent lane is served
+ * first. It can preempt a normal lane transaction between its chunks only if preemptible
+ * is set and cs_hold is not. Preempted transaction releases CS and continues from its own
+ * offset afterwards without command or address bytes, so preemptible is for devices
+ * streaming data regardless of CS, not for command framed ones like flash or display.
+ * Worst-case wait of urgent transaction is the rest of transaction in progress, or one
+ * chunk time (NODI_SPIM_MAXCNT * 8 / frequency) if it is preemptible, plus interrupt
+ * latency.
+ *
+ * @param[in] p_spim_drv        Pointer to structure representing SPIM driver.
+ * @param[in] p_desc            Transaction descriptor.
+ */
+void nodi_spim_queue_push(nodi_spim_drv_t *p_spim_drv, nodi_spim_xfer_desc_t *p_desc);
+
+/**
+ * @brief Checks if driver's queue has pending transactions.
+ *
+ * @param[in] p_spim_drv        Pointer to structure representing SPIM driver.
+ *
+ * @return 1 if queue is not empty, 0 otherwise.
+ */
+uint32_t nodi_spim_queue_busy_check(nodi_spim_drv_t *p_spim_drv);
+
+/**
+ * @brief Applies device's bus settings to SPIM.
+ *
+ * Only registers different from the current settings are written. Use before
+ * direct transfers, queued transfers apply settings by themselves.
+ *
+ * @param[in] p_spim_drv        Pointer to structure representing SPIM driver.
+ * @param[in] p_dev             Device settings.
+ */
+void nodi_spim_bus_dev_apply(nodi_spim_drv_t *p_spim_drv, const nodi_spim_dev_s *p_dev);
+
+/**
+ * @brief Appends transaction addressed to the device to the driver's queue.
+ *
+ * Device's CS pin is driven around transaction and bus settings are updated when
+ * the transaction is started. Function can be called from any interrupt priority.
+ *
+ * @param[in] p_spim_drv        Pointer to structure representing SPIM driver.
+ * @param[in] p_dev             Target device.
+ * @param[in] p_desc            Transaction descriptor.
+ */
+void nodi_spim_bus_push(nodi_spim_drv_t *p_spim_drv,
+                        const nodi_spim_dev_s *p_dev,
+                        nodi_spim_xfer_desc_t *p_desc);
+
+/**
+ * @brief Returns bus manager counters.
+ *
+ * @param[in] p_spim_drv        Pointer to structure representing SPIM driver.
+ *
+ * @return Pointer to counters.
+ */
+const nodi_spim_bus_stats_s *nodi_spim_bus_stats_get(nodi_spim_drv_t *p_spim_drv);
+
+/**
+ * @brief Clears bus manager counters.
+ *
+ * @param[in] p_spim_drv        Pointer to structure representing SPIM driver.
+ */
+void nodi_spim_bus_stats_clear(nodi_spim_drv_t *p_spim_drv);
+
+/**
+ * @brief Returns timestamps of the last transfer.
+ *
+ * Valid in end_cb. Queued transactions get their timestamps in descriptor.
+ *
+ * @param[in]  p_spim_drv       Pointer to structure representing SPIM driver.
+ * @param[out] p_started        TIMER value captured on STARTED.
+ * @param[out] p_end            TIMER value captured on END.
+ */
+void nodi_spim_timestamps_get(nodi_spim_drv_t *p_spim_drv, uint32_t *p_started, uint32_t *p_end);
+
 /**
  * @brief Deinitializes SPIM peripheral.
  *
@@ -207,7 +630,7 @@ void nodi_spim_xfer_configure(nodi_spim_drv_t *p_spim_drv,
  *
  * @return Address to start task of the SPIM peripheral.
  */
-uint32_t nodi_spim_task_addr_get(nodi_spim_drv_t *p_spim_drv);
+uint32_t nodi_spim_start_task_addr_get(nodi_spim_drv_t *p_spim_drv);
 
 /**
  * @brief Returns end event address to connect some tasks with this event using PPI.
@@ -216,7 +639,7 @@ uint32_t nodi_spim_task_addr_get(nodi_spim_drv_t *p_spim_drv);
  *
  * @return Address to end event of the SPIM peripheral.
  */
-uint32_t nodi_spim_evt_addr_get(nodi_spim_drv_t *p_spim_drv);
+uint32_t nodi_spim_end_evt_addr_get(nodi_spim_drv_t *p_spim_drv);
 
 
 #ifdef NODI_SPIM_DISABLE_IRQ_CONNECT
@@ -36,7 +36,36 @@
 #define NODI_SPIM_FREQ_1M      SPIM_FREQUENCY_FREQUENCY_M1
 #define NODI_SPIM_FREQ_2M      SPIM_FREQUENCY_FREQUENCY_M2
 #define NODI_SPIM_FREQ_4M      SPIM_FREQUENCY_FREQUENCY_M4
-#define NRF_SPIM_FREQ_8M      SPIM_FREQUENCY_FREQUENCY_M8
+#define NODI_SPIM_FREQ_8M      SPIM_FREQUENCY_FREQUENCY_M8
+/* Kept for backward compatibility. */
+#define NRF_SPIM_FREQ_8M       NODI_SPIM_FREQ_8M
+
+/**
+ * @brief SPI master data rates available only on SPIM3.
+ */
+#define NODI_SPIM_FREQ_16M     SPIM_FREQUENCY_FREQUENCY_M16
+#define NODI_SPIM_FREQ_32M     SPIM_FREQUENCY_FREQUENCY_M32
+
+/**
+ * @brief Hardware CSN polarity (SPIM3 only).
+ */
+#define NODI_SPIM_CSN_POL_LOW  SPIM_CSNPOL_CSNPOL_LOW
+#define NODI_SPIM_CSN_POL_HIGH SPIM_CSNPOL_CSNPOL_HIGH
+
+/**
+ * @brief DCX count value marking every transmitted byte as command (SPIM3 only).
+ */
+#define NODI_SPIM_DCX_CNT_ALL_CMD  0xF
+
+/**
+ * @brief Longest single EasyDMA transfer handled by the driver.
+ */
+#define NODI_SPIM_MAXCNT       255
+
+/**
+ * @brief GPIOTE channel value marking that autonomous sampling does not drive CS pin.
+ */
+#define NODI_SPIM_GPIOTE_NONE  0xFF
 
 #define NODI_SPIM_BIT_ORDER_MSB_FIRST SPIM_CONFIG_ORDER_MsbFirst
 #define NODI_SPIM_BIT_ORDER_LSB_FIRST SPIM_CONFIG_ORDER_LsbFirst
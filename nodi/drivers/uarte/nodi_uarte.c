@@ -37,6 +37,717 @@ nodi_uarte_drv_t NODI_UARTE0;
 nodi_uarte_drv_t NODI_UARTE1;
 #endif
 
+/* Baudrate register is baud * 2^32 / 16 MHz. */
+static inline uint32_t nodi_uarte_baud_get(uint32_t baudrate_reg)
+{
+    return (uint32_t)(((uint64_t)baudrate_reg * 16000000UL + (1UL << 31)) >> 32);
+}
+
+void nodi_uarte_rx_ring_start(nodi_uarte_drv_t *p_uarte_drv, nodi_uarte_rx_ring_s *p_ring)
+{
+    NODI_DRV_CHECK(p_uarte_drv != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(p_ring != NULL, "Ring pointer is NULL!");
+    NODI_DRV_CHECK(p_uarte_drv->uarte_rx_state == NODI_UARTE_DRV_STATE_READY, "Driver is busy!");
+    NODI_DRV_CHECK(p_ring->block_count >= 4, "Ring too short!");
+    NODI_DRV_CHECK((p_ring->block_count & (p_ring->block_count - 1)) == 0,
+                  "Block count is not a power of two!");
+    NODI_DRV_CHECK((p_ring->block_len != 0) && (p_ring->block_len <= 255), "Block length out of band!");
+
+    NRF_UARTE_Type * p_reg = p_uarte_drv->p_uarte_reg;
+
+    p_ring->wr = 0;
+    p_ring->rd = 0;
+    p_ring->lost = 0;
+    p_uarte_drv->p_rx_ring = p_ring;
+    p_uarte_drv->rx_ring_drop = false;
+    p_uarte_drv->rx_ring_stop = false;
+
+    p_reg->RXD.PTR    = (uint32_t)nodi_uarte_rx_ring_block(p_ring, 0);
+    p_reg->RXD.MAXCNT = p_ring->block_len;
+
+    p_uarte_drv->uarte_rx_state = NODI_UARTE_DRV_STATE_BUSY;
+    p_reg->EVENTS_ENDRX = 0;
+    p_reg->EVENTS_RXSTARTED = 0;
+    p_reg->SHORTS |= UARTE_SHORTS_ENDRX_STARTRX_Msk;
+    p_reg->INTENSET = UARTE_INTENSET_RXSTARTED_Msk;
+    p_reg->TASKS_STARTRX = 1;
+}
+
+void nodi_uarte_rx_ring_stop(nodi_uarte_drv_t *p_uarte_drv)
+{
+    NODI_DRV_CHECK(p_uarte_drv != NULL, "Driver pointer is NULL!");
+
+    NRF_UARTE_Type * p_reg = p_uarte_drv->p_uarte_reg;
+
+    if (p_uarte_drv->p_rx_ring == NULL)
+    {
+        return;
+    }
+
+    /* Block in progress ends with ENDRX and exact AMOUNT. */
+    p_uarte_drv->rx_ring_stop = true;
+    p_reg->SHORTS &= ~UARTE_SHORTS_ENDRX_STARTRX_Msk;
+    p_reg->TASKS_STOPRX = 1;
+}
+
+uint32_t nodi_uarte_rx_ring_get(nodi_uarte_drv_t *p_uarte_drv, const uint8_t **pp_data)
+{
+    NODI_DRV_CHECK(p_uarte_drv != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(pp_data != NULL, "Data pointer is NULL!");
+
+    nodi_uarte_rx_ring_s *p_ring = p_uarte_drv->p_rx_ring;
+    uint32_t amount;
+
+    if ((p_ring == NULL) || !nodi_uarte_rx_ring_peek(p_ring, p_ring->rd, pp_data, &amount))
+    {
+        return 0;
+    }
+    return amount;
+}
+
+void nodi_uarte_rx_ring_release(nodi_uarte_drv_t *p_uarte_drv)
+{
+    NODI_DRV_CHECK(p_uarte_drv != NULL, "Driver pointer is NULL!");
+
+    nodi_uarte_rx_ring_s *p_ring = p_uarte_drv->p_rx_ring;
+
+    NODI_DRV_CHECK(p_ring != NULL, "Ring is not started!");
+    NODI_DRV_CHECK(p_ring->rd != p_ring->wr, "Ring is empty!");
+    p_ring->rd++;
+}
+
+static void nodi_uarte_rx_ring_irq_handle(nodi_uarte_drv_t *p_uarte_drv)
+{
+    NRF_UARTE_Type * p_reg = p_uarte_drv->p_uarte_reg;
+    nodi_uarte_rx_ring_s *p_ring = p_uarte_drv->p_rx_ring;
+
+    /* ENDRX is handled first. RXSTARTED of the next block can be pending already. */
+    if (p_reg->EVENTS_ENDRX == 1)
+    {
+        uint32_t amount = p_reg->RXD.AMOUNT;
+        p_reg->EVENTS_ENDRX = 0;
+
+        if (p_uarte_drv->rx_ring_drop)
+        {
+            p_ring->lost += amount;
+        }
+        else
+        {
+            p_ring->p_amounts[nodi_uarte_rx_ring_idx(p_ring, p_ring->wr)] = amount;
+            p_ring->wr++;
+        }
+
+        /* Short was removed, reception is over unless it restarted just before. */
+        if (p_uarte_drv->rx_ring_stop)
+        {
+            if (p_reg->EVENTS_RXSTARTED == 0)
+            {
+                p_reg->INTENCLR = UARTE_INTENCLR_RXSTARTED_Msk;
+                p_uarte_drv->uarte_rx_state = NODI_UARTE_DRV_STATE_FINISH;
+            }
+            else
+            {
+                p_reg->TASKS_STOPRX = 1;
+            }
+        }
+
+        if (p_uarte_drv->config->rx_end_cb)
+        {
+            p_uarte_drv->config->rx_end_cb(p_uarte_drv);
+        }
+
+        if (p_uarte_drv->uarte_rx_state == NODI_UARTE_DRV_STATE_FINISH)
+        {
+            p_uarte_drv->uarte_rx_state = NODI_UARTE_DRV_STATE_READY;
+        }
+    }
+
+    /* Block in progress is latched, load the one after it. When ring is full the block
+     * in progress is loaded again and its data is dropped at ENDRX. */
+    if (p_reg->EVENTS_RXSTARTED == 1)
+    {
+        p_reg->EVENTS_RXSTARTED = 0;
+        p_uarte_drv->rx_ring_drop = nodi_uarte_rx_ring_space(p_ring, p_ring->wr) < 2;
+        p_reg->RXD.PTR = (uint32_t)nodi_uarte_rx_ring_block(p_ring,
+                p_uarte_drv->rx_ring_drop ? p_ring->wr : p_ring->wr + 1);
+    }
+}
+
+/* DE is released by TIMER started from ENDTX, after the last character leaves the line. */
+static void nodi_uarte_rs485_timing_set(nodi_uarte_drv_t *p_uarte_drv)
+{
+    const nodi_uarte_rs485_config_s *p_rs485 = p_uarte_drv->config->p_rs485_cfg;
+    NRF_UARTE_Type * p_reg = p_uarte_drv->p_uarte_reg;
+    uint32_t bits = p_rs485->tail_bits;
+
+    if (bits == 0)
+    {
+        /* Character in shift register and one bit of margin. */
+        bits = ((p_reg->CONFIG & UARTE_CONFIG_PARITY_Msk) ? 11 : 10) + 1;
+    }
+
+    p_rs485->p_timer_reg->CC[0] = (uint32_t)(((uint64_t)bits * 16000000UL) /
+                                             nodi_uarte_baud_get(p_reg->BAUDRATE));
+}
+
+static void nodi_uarte_rs485_init(nodi_uarte_drv_t *p_uarte_drv)
+{
+    const nodi_uarte_rs485_config_s *p_rs485 = p_uarte_drv->config->p_rs485_cfg;
+    NRF_UARTE_Type * p_reg = p_uarte_drv->p_uarte_reg;
+    NRF_TIMER_Type * p_timer = p_rs485->p_timer_reg;
+
+    p_timer->TASKS_STOP = 1;
+    p_timer->INTENCLR = 0xFFFFFFFF;
+    p_timer->MODE = TIMER_MODE_MODE_Timer;
+    p_timer->BITMODE = TIMER_BITMODE_BITMODE_32Bit;
+    p_timer->PRESCALER = 0;
+    p_timer->SHORTS = TIMER_SHORTS_COMPARE0_STOP_Msk | TIMER_SHORTS_COMPARE0_CLEAR_Msk;
+    p_timer->TASKS_CLEAR = 1;
+    nodi_uarte_rs485_timing_set(p_uarte_drv);
+
+    nodi_gpiote_task_config(p_rs485->gpiote_ch, &p_rs485->de_pin, 0);
+    nodi_ppi_channel_assign(p_rs485->ppi_ch_end,
+                            (uint32_t)&p_reg->EVENTS_ENDTX,
+                            (uint32_t)&p_timer->TASKS_START);
+    nodi_ppi_channel_assign(p_rs485->ppi_ch_release,
+                            (uint32_t)&p_timer->EVENTS_COMPARE[0],
+                            nodi_gpiote_clr_task_addr_get(p_rs485->gpiote_ch));
+    nodi_ppi_channels_enable(NODI_PPI_CH_MSK(p_rs485->ppi_ch_end) |
+                             NODI_PPI_CH_MSK(p_rs485->ppi_ch_release));
+}
+
+static void nodi_uarte_rs485_deinit(nodi_uarte_drv_t *p_uarte_drv)
+{
+    const nodi_uarte_rs485_config_s *p_rs485 = p_uarte_drv->config->p_rs485_cfg;
+
+    nodi_ppi_channels_disable(NODI_PPI_CH_MSK(p_rs485->ppi_ch_end) |
+                              NODI_PPI_CH_MSK(p_rs485->ppi_ch_release));
+    p_rs485->p_timer_reg->TASKS_STOP = 1;
+    nodi_gpiote_channel_disable(p_rs485->gpiote_ch);
+}
+
+/* Asserts DE before STARTTX. Release pending from previous ENDTX is cancelled. */
+static inline void nodi_uarte_rs485_tx_begin(nodi_uarte_drv_t *p_uarte_drv)
+{
+    const nodi_uarte_rs485_config_s *p_rs485 = p_uarte_drv->config->p_rs485_cfg;
+
+    if (p_rs485 != NULL)
+    {
+        p_rs485->p_timer_reg->TASKS_STOP = 1;
+        p_rs485->p_timer_reg->TASKS_CLEAR = 1;
+        *(volatile uint32_t *)nodi_gpiote_set_task_addr_get(p_rs485->gpiote_ch) = 1;
+    }
+}
+
+/* Starts the next chunk of transmission in progress. Returns false if frame is sent. */
+static bool nodi_uarte_tx_chunk_start(nodi_uarte_drv_t *p_uarte_drv, nodi_uarte_tx_desc_t *p_desc)
+{
+    NRF_UARTE_Type * p_reg = p_uarte_drv->p_uarte_reg;
+
+    /* Skip finished and empty gather list elements. */
+    while ((p_uarte_drv->tx_seg < p_desc->seg_count) &&
+           (p_uarte_drv->tx_off >= p_desc->p_segs[p_uarte_drv->tx_seg].len))
+    {
+        p_uarte_drv->tx_seg++;
+        p_uarte_drv->tx_off = 0;
+    }
+
+    if (p_uarte_drv->tx_seg == p_desc->seg_count)
+    {
+        return false;
+    }
+
+    const nodi_uarte_seg_s *p_seg = &p_desc->p_segs[p_uarte_drv->tx_seg];
+    uint32_t n = p_seg->len - p_uarte_drv->tx_off;
+
+    p_uarte_drv->tx_chunk = n > NODI_UARTE_MAXCNT ? NODI_UARTE_MAXCNT : n;
+
+    p_reg->TXD.PTR    = (uint32_t)p_seg->p_buf + p_uarte_drv->tx_off;
+    p_reg->TXD.MAXCNT = p_uarte_drv->tx_chunk;
+
+    p_reg->EVENTS_ENDTX = 0;
+    nodi_uarte_rs485_tx_begin(p_uarte_drv);
+    p_reg->TASKS_STARTTX = 1;
+    return true;
+}
+
+/* Starts the first non-empty queued transmission. Finished ones are moved to pp_done list. */
+static void nodi_uarte_tx_queue_next(nodi_uarte_drv_t *p_uarte_drv,
+                                     nodi_uarte_tx_desc_t **pp_done)
+{
+    while (p_uarte_drv->p_tx_head != NULL)
+    {
+        if (nodi_uarte_tx_chunk_start(p_uarte_drv, p_uarte_drv->p_tx_head))
+        {
+            return;
+        }
+
+        nodi_uarte_tx_desc_t *p_desc = p_uarte_drv->p_tx_head;
+        p_uarte_drv->p_tx_head = p_desc->p_next;
+        if (p_uarte_drv->p_tx_head == NULL)
+        {
+            p_uarte_drv->p_tx_tail = NULL;
+        }
+        p_uarte_drv->tx_seg = 0;
+        p_uarte_drv->tx_off = 0;
+
+        /* Keep completion order, list is longer than one only for empty frames. */
+        p_desc->p_next = NULL;
+        while (*pp_done != NULL)
+        {
+            pp_done = &(*pp_done)->p_next;
+        }
+        *pp_done = p_desc;
+    }
+
+    p_uarte_drv->uarte_tx_state = NODI_UARTE_DRV_STATE_READY;
+}
+
+static void nodi_uarte_tx_done_notify(nodi_uarte_drv_t *p_uarte_drv, nodi_uarte_tx_desc_t *p_done)
+{
+    while (p_done != NULL)
+    {
+        nodi_uarte_tx_desc_t *p_next = p_done->p_next;
+        if (p_done->tx_cb)
+        {
+            p_done->tx_cb(p_uarte_drv, p_done);
+        }
+        p_done = p_next;
+    }
+}
+
+void nodi_uarte_tx_queue_push(nodi_uarte_drv_t *p_uarte_drv, nodi_uarte_tx_desc_t *p_desc)
+{
+    NODI_DRV_CHECK(p_uarte_drv != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(p_desc != NULL, "Descriptor pointer is NULL!");
+    NODI_DRV_CHECK((p_desc->p_segs != NULL) || (p_desc->seg_count == 0),
+                  "Gather list pointer is NULL!");
+    NODI_DRV_CHECK(p_uarte_drv->uarte_tx_state != NODI_UARTE_DRV_STATE_UNINIT,
+                  "Driver is not initialized!");
+
+    nodi_uarte_tx_desc_t *p_done = NULL;
+    uint32_t primask;
+    p_desc->p_next = NULL;
+
+    /* Interrupt routine and pushes from other priorities modify queue too. */
+    primask = nodi_common_critical_enter();
+
+    if (p_uarte_drv->p_tx_tail == NULL)
+    {
+        NODI_DRV_CHECK(p_uarte_drv->uarte_tx_state != NODI_UARTE_DRV_STATE_BUSY,
+                      "Driver is busy!");
+        p_uarte_drv->p_tx_head = p_desc;
+        p_uarte_drv->p_tx_tail = p_desc;
+        p_uarte_drv->tx_seg = 0;
+        p_uarte_drv->tx_off = 0;
+        p_uarte_drv->uarte_tx_state = NODI_UARTE_DRV_STATE_BUSY;
+        nodi_uarte_tx_queue_next(p_uarte_drv, &p_done);
+    }
+    else
+    {
+        p_uarte_drv->p_tx_tail->p_next = p_desc;
+        p_uarte_drv->p_tx_tail = p_desc;
+    }
+
+    nodi_common_critical_exit(primask);
+
+    nodi_uarte_tx_done_notify(p_uarte_drv, p_done);
+}
+
+uint32_t nodi_uarte_tx_queue_busy_check(nodi_uarte_drv_t *p_uarte_drv)
+{
+    NODI_DRV_CHECK(p_uarte_drv != NULL, "Driver pointer is NULL!");
+    return p_uarte_drv->p_tx_head != NULL ? 1 : 0;
+}
+
+static void nodi_uarte_tx_queue_end_handle(nodi_uarte_drv_t *p_uarte_drv)
+{
+    NRF_UARTE_Type * p_reg = p_uarte_drv->p_uarte_reg;
+    nodi_uarte_tx_desc_t *p_done = NULL;
+    uint32_t primask;
+
+    p_reg->EVENTS_ENDTX = 0;
+
+    primask = nodi_common_critical_enter();
+    p_uarte_drv->tx_off += p_uarte_drv->tx_chunk;
+    nodi_uarte_tx_queue_next(p_uarte_drv, &p_done);
+    nodi_common_critical_exit(primask);
+
+    nodi_uarte_tx_done_notify(p_uarte_drv, p_done);
+}
+
+static const uint32_t nodi_uarte_std_bauds[][2] = {
+    {1200,    NODI_UARTE_BAUD_1200},
+    {2400,    NODI_UARTE_BAUD_2400},
+    {4800,    NODI_UARTE_BAUD_4800},
+    {9600,    NODI_UARTE_BAUD_9600},
+    {14400,   NODI_UARTE_BAUD_14400},
+    {19200,   NODI_UARTE_BAUD_19200},
+    {28800,   NODI_UARTE_BAUD_28800},
+    {31250,   NODI_UARTE_BAUD_31250},
+    {38400,   NODI_UARTE_BAUD_38400},
+    {56000,   NODI_UARTE_BAUD_56000},
+    {57600,   NODI_UARTE_BAUD_57600},
+    {76800,   NODI_UARTE_BAUD_76800},
+    {115200,  NODI_UARTE_BAUD_115200},
+    {230400,  NODI_UARTE_BAUD_230400},
+    {250000,  NODI_UARTE_BAUD_250000},
+    {460800,  NODI_UARTE_BAUD_460800},
+    {921600,  NODI_UARTE_BAUD_921600},
+    {1000000, NODI_UARTE_BAUD_1M},
+};
+
+uint32_t nodi_uarte_baudrate_calc(uint32_t baud, int32_t *p_err_ppm)
+{
+    NODI_DRV_CHECK((baud >= 1200) && (baud <= 1000000), "Baudrate out of band!");
+
+    uint32_t reg = (uint32_t)((((uint64_t)baud << 32) + 8000000UL) / 16000000UL);
+
+    /* Lower 12 bits are ignored by baudrate generator. */
+    reg = (reg + 0x800) & 0xFFFFF000;
+
+    if (p_err_ppm != NULL)
+    {
+        int64_t diff = (int64_t)nodi_uarte_baud_get(reg) - (int64_t)baud;
+        *p_err_ppm = (int32_t)(diff * 1000000 / (int64_t)baud);
+    }
+    return reg;
+}
+
+void nodi_uarte_baudrate_set(nodi_uarte_drv_t *p_uarte_drv, uint32_t baudrate)
+{
+    NODI_DRV_CHECK(p_uarte_drv != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(p_uarte_drv->uarte_rx_state != NODI_UARTE_DRV_STATE_UNINIT,
+                  "Driver is not initialized!");
+
+    p_uarte_drv->p_uarte_reg->BAUDRATE = baudrate;
+
+    if (p_uarte_drv->config->p_rs485_cfg != NULL)
+    {
+        nodi_uarte_rs485_timing_set(p_uarte_drv);
+    }
+}
+
+void nodi_uarte_autobaud_start(nodi_uarte_drv_t *p_uarte_drv)
+{
+    NODI_DRV_CHECK(p_uarte_drv != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(p_uarte_drv->config->p_autobaud_cfg != NULL, "Autobaud not configured!");
+
+    const nodi_uarte_autobaud_config_s *p_ab = p_uarte_drv->config->p_autobaud_cfg;
+    NRF_TIMER_Type * p_timer = p_ab->p_timer_reg;
+    uint32_t ch_mask = NODI_PPI_CH_MSK(p_ab->ppi_ch_fall) | NODI_PPI_CH_MSK(p_ab->ppi_ch_rise);
+
+    /* TIMER runs at 16 MHz, the same clock as baudrate generator. */
+    p_timer->TASKS_STOP = 1;
+    p_timer->INTENCLR = 0xFFFFFFFF;
+    p_timer->SHORTS = 0;
+    p_timer->MODE = TIMER_MODE_MODE_Timer;
+    p_timer->BITMODE = TIMER_BITMODE_BITMODE_32Bit;
+    p_timer->PRESCALER = 0;
+    p_timer->CC[1] = 0;
+    p_timer->TASKS_CLEAR = 1;
+
+    nodi_gpiote_event_config(p_ab->gpiote_ch_fall, &p_uarte_drv->config->rx_pin,
+                             GPIOTE_CONFIG_POLARITY_HiToLo);
+    nodi_gpiote_event_config(p_ab->gpiote_ch_rise, &p_uarte_drv->config->rx_pin,
+                             GPIOTE_CONFIG_POLARITY_LoToHi);
+
+    nodi_ppi_channel_assign(p_ab->ppi_ch_fall,
+                            nodi_gpiote_event_addr_get(p_ab->gpiote_ch_fall),
+                            (uint32_t)&p_timer->TASKS_CLEAR);
+    nodi_ppi_channel_fork_assign(p_ab->ppi_ch_fall, (uint32_t)&p_timer->TASKS_START);
+    nodi_ppi_channel_assign(p_ab->ppi_ch_rise,
+                            nodi_gpiote_event_addr_get(p_ab->gpiote_ch_rise),
+                            (uint32_t)&p_timer->TASKS_CAPTURE[1]);
+    nodi_ppi_channel_fork_assign(p_ab->ppi_ch_rise,
+                                 nodi_ppi_group_disable_task_addr_get(p_ab->ppi_group));
+    nodi_ppi_group_assign(p_ab->ppi_group, ch_mask);
+
+    nodi_ppi_channels_enable(ch_mask);
+}
+
+uint32_t nodi_uarte_autobaud_poll(nodi_uarte_drv_t *p_uarte_drv)
+{
+    NODI_DRV_CHECK(p_uarte_drv != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(p_uarte_drv->config->p_autobaud_cfg != NULL, "Autobaud not configured!");
+
+    const nodi_uarte_autobaud_config_s *p_ab = p_uarte_drv->config->p_autobaud_cfg;
+    NRF_TIMER_Type * p_timer = p_ab->p_timer_reg;
+    uint32_t ticks = p_timer->CC[1];
+    uint32_t baud;
+    uint32_t reg;
+    uint32_t best = 0;
+    uint32_t best_diff = 0xFFFFFFFF;
+    uint32_t i;
+
+    if (ticks == 0)
+    {
+        return 0;
+    }
+
+    p_timer->TASKS_STOP = 1;
+    nodi_ppi_channels_disable(NODI_PPI_CH_MSK(p_ab->ppi_ch_fall) |
+                              NODI_PPI_CH_MSK(p_ab->ppi_ch_rise));
+    nodi_gpiote_channel_disable(p_ab->gpiote_ch_fall);
+    nodi_gpiote_channel_disable(p_ab->gpiote_ch_rise);
+
+    baud = (16000000UL + ticks / 2) / ticks;
+    baud = baud < 1200 ? 1200 : (baud > 1000000 ? 1000000 : baud);
+    reg = nodi_uarte_baudrate_calc(baud, NULL);
+
+    /* Measurement error is one TIMER tick, the nearest standard rate is preferred. */
+    for (i = 0; i < sizeof(nodi_uarte_std_bauds) / sizeof(nodi_uarte_std_bauds[0]); i++)
+    {
+        uint32_t std = nodi_uarte_std_bauds[i][0];
+        uint32_t diff = baud > std ? baud - std : std - baud;
+        if (diff < best_diff)
+        {
+            best_diff = diff;
+            best = i;
+        }
+    }
+
+    if (best_diff * 100 <= nodi_uarte_std_bauds[best][0] * 3)
+    {
+        baud = nodi_uarte_std_bauds[best][0];
+        reg = nodi_uarte_std_bauds[best][1];
+    }
+
+    nodi_uarte_baudrate_set(p_uarte_drv, reg);
+    return baud;
+}
+
+/* Prepares idle line receive, reception is started by STARTRX task. */
+static void nodi_uarte_rx_idle_arm(nodi_uarte_drv_t *p_uarte_drv, uint32_t n, void *p_rxbuf)
+{
+    const nodi_uarte_idle_config_s *p_idle = p_uarte_drv->config->p_idle_cfg;
+    NRF_UARTE_Type * p_reg = p_uarte_drv->p_uarte_reg;
+    NRF_TIMER_Type * p_count = p_idle->p_count_timer_reg;
+    NRF_TIMER_Type * p_timer = p_idle->p_idle_timer_reg;
+
+    /* Character is start, 8 data, parity and stop bits. */
+    uint32_t bits = (p_reg->CONFIG & UARTE_CONFIG_PARITY_Msk) ? 11 : 10;
+    uint32_t baud = nodi_uarte_baud_get(p_reg->BAUDRATE);
+    uint32_t timeout_us = (uint32_t)(((uint64_t)p_idle->timeout_chars * bits * 1000000UL +
+                                      baud - 1) / baud);
+
+    p_count->TASKS_STOP = 1;
+    p_count->INTENCLR = 0xFFFFFFFF;
+    p_count->SHORTS = 0;
+    p_count->MODE = TIMER_MODE_MODE_LowPowerCounter;
+    p_count->BITMODE = TIMER_BITMODE_BITMODE_32Bit;
+    p_count->TASKS_CLEAR = 1;
+    p_count->TASKS_START = 1;
+
+    /* Idle TIMER runs at 1 MHz, it is started by the first byte and stops itself on timeout. */
+    p_timer->TASKS_STOP = 1;
+    p_timer->INTENCLR = 0xFFFFFFFF;
+    p_timer->MODE = TIMER_MODE_MODE_Timer;
+    p_timer->BITMODE = TIMER_BITMODE_BITMODE_32Bit;
+    p_timer->PRESCALER = 4;
+    p_timer->CC[0] = timeout_us + 1;
+    p_timer->SHORTS = TIMER_SHORTS_COMPARE0_STOP_Msk | TIMER_SHORTS_COMPARE0_CLEAR_Msk;
+    p_timer->EVENTS_COMPARE[0] = 0;
+    p_timer->TASKS_CLEAR = 1;
+
+    nodi_ppi_channel_assign(p_idle->ppi_ch_count,
+                            (uint32_t)&p_reg->EVENTS_RXDRDY,
+                            (uint32_t)&p_count->TASKS_COUNT);
+    nodi_ppi_channel_assign(p_idle->ppi_ch_restart,
+                            (uint32_t)&p_reg->EVENTS_RXDRDY,
+                            (uint32_t)&p_timer->TASKS_CLEAR);
+    nodi_ppi_channel_fork_assign(p_idle->ppi_ch_restart, (uint32_t)&p_timer->TASKS_START);
+    nodi_ppi_channel_assign(p_idle->ppi_ch_timeout,
+                            (uint32_t)&p_timer->EVENTS_COMPARE[0],
+                            (uint32_t)&p_reg->TASKS_STOPRX);
+
+    p_reg->RXD.PTR    = (uint32_t)p_rxbuf;
+    p_reg->RXD.MAXCNT = n;
+
+    p_uarte_drv->rx_idle = true;
+    p_uarte_drv->rx_amount = 0;
+    p_uarte_drv->uarte_rx_state = NODI_UARTE_DRV_STATE_BUSY;
+    p_reg->EVENTS_ENDRX = 0;
+    p_reg->EVENTS_RXTO = 0;
+    p_reg->INTENSET = UARTE_INTENSET_RXTO_Msk;
+
+    nodi_ppi_channels_enable(NODI_PPI_CH_MSK(p_idle->ppi_ch_count)   |
+                             NODI_PPI_CH_MSK(p_idle->ppi_ch_restart) |
+                             NODI_PPI_CH_MSK(p_idle->ppi_ch_timeout));
+}
+
+void nodi_uarte_receive_idle_start(nodi_uarte_drv_t *p_uarte_drv, uint32_t n, void *p_rxbuf)
+{
+    NODI_DRV_CHECK(p_uarte_drv != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(p_rxbuf != NULL, "Buffer pointer is NULL!");
+    NODI_DRV_CHECK(p_uarte_drv->config->p_idle_cfg != NULL, "Idle receive not configured!");
+    NODI_DRV_CHECK((p_uarte_drv->uarte_rx_state == NODI_UARTE_DRV_STATE_READY) ||
+                  (p_uarte_drv->uarte_rx_state == NODI_UARTE_DRV_STATE_FINISH), "Driver is busy!");
+
+    nodi_uarte_rx_idle_arm(p_uarte_drv, n, p_rxbuf);
+    p_uarte_drv->p_uarte_reg->TASKS_STARTRX = 1;
+}
+
+void nodi_uarte_sleep(nodi_uarte_drv_t *p_uarte_drv, uint32_t n, void *p_rxbuf)
+{
+    NODI_DRV_CHECK(p_uarte_drv != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(p_rxbuf != NULL, "Buffer pointer is NULL!");
+    NODI_DRV_CHECK(p_uarte_drv->config->p_wake_cfg != NULL, "Wake on RX not configured!");
+    NODI_DRV_CHECK((p_uarte_drv->uarte_rx_state == NODI_UARTE_DRV_STATE_READY) ||
+                  (p_uarte_drv->uarte_rx_state == NODI_UARTE_DRV_STATE_FINISH), "Driver is busy!");
+
+    const nodi_uarte_wake_config_s *p_wake = p_uarte_drv->config->p_wake_cfg;
+    NRF_UARTE_Type * p_reg = p_uarte_drv->p_uarte_reg;
+    NRF_TIMER_Type * p_timer = p_wake->p_timer_reg;
+    uint32_t ch_mask = NODI_PPI_CH_MSK(p_wake->ppi_ch_wake) | NODI_PPI_CH_MSK(p_wake->ppi_ch_started);
+
+    /* Receive is prepared, only STARTRX is left to the wake edge. */
+    if (p_uarte_drv->config->p_idle_cfg != NULL)
+    {
+        nodi_uarte_rx_idle_arm(p_uarte_drv, n, p_rxbuf);
+    }
+    else
+    {
+        p_reg->RXD.PTR    = (uint32_t)p_rxbuf;
+        p_reg->RXD.MAXCNT = n;
+        p_reg->EVENTS_ENDRX = 0;
+        p_uarte_drv->uarte_rx_state = NODI_UARTE_DRV_STATE_BUSY;
+    }
+
+    /* TIMER at 16 MHz measures time from the edge to RXSTARTED. */
+    p_timer->TASKS_STOP = 1;
+    p_timer->INTENCLR = 0xFFFFFFFF;
+    p_timer->SHORTS = 0;
+    p_timer->MODE = TIMER_MODE_MODE_Timer;
+    p_timer->BITMODE = TIMER_BITMODE_BITMODE_32Bit;
+    p_timer->PRESCALER = 0;
+    p_timer->CC[0] = 0;
+    p_timer->TASKS_CLEAR = 1;
+
+    nodi_gpio_sense_set(&p_uarte_drv->config->rx_pin, NODI_GPIO_SENSE_LOW);
+    nodi_ppi_channel_assign(p_wake->ppi_ch_wake,
+                            nodi_gpiote_port_event_addr_get(),
+                            (uint32_t)&p_reg->TASKS_STARTRX);
+    nodi_ppi_channel_fork_assign(p_wake->ppi_ch_wake, (uint32_t)&p_timer->TASKS_START);
+    nodi_ppi_channel_assign(p_wake->ppi_ch_started,
+                            (uint32_t)&p_reg->EVENTS_RXSTARTED,
+                            (uint32_t)&p_timer->TASKS_CAPTURE[0]);
+    nodi_ppi_channel_fork_assign(p_wake->ppi_ch_started,
+                                 nodi_ppi_group_disable_task_addr_get(p_wake->ppi_group));
+    nodi_ppi_group_assign(p_wake->ppi_group, ch_mask);
+
+    /* Only idle line receive stops receiver by itself, single receive is not rearmed. */
+    p_uarte_drv->p_sleep_buf = (p_uarte_drv->config->p_idle_cfg != NULL) ? p_rxbuf : NULL;
+    p_uarte_drv->sleep_n = n;
+    p_uarte_drv->wake_armed = true;
+    nodi_ppi_channels_enable(ch_mask);
+}
+
+uint32_t nodi_uarte_wake_latency_get(nodi_uarte_drv_t *p_uarte_drv)
+{
+    NODI_DRV_CHECK(p_uarte_drv != NULL, "Driver pointer is NULL!");
+    return p_uarte_drv->wake_latency_ns;
+}
+
+/* Wake resources are released after RXSTARTED was captured. */
+static void nodi_uarte_wake_handle(nodi_uarte_drv_t *p_uarte_drv)
+{
+    const nodi_uarte_wake_config_s *p_wake = p_uarte_drv->config->p_wake_cfg;
+    uint32_t ticks = p_wake->p_timer_reg->CC[0];
+
+    if (ticks == 0)
+    {
+        return;
+    }
+
+    p_wake->p_timer_reg->TASKS_STOP = 1;
+    nodi_gpio_sense_set(&p_uarte_drv->config->rx_pin, NODI_GPIO_SENSE_DISABLED);
+    p_uarte_drv->wake_armed = false;
+    p_uarte_drv->wake_count++;
+    p_uarte_drv->wake_latency_ns = ticks * 125 / 2;
+}
+
+uint32_t nodi_uarte_rx_amount_get(nodi_uarte_drv_t *p_uarte_drv)
+{
+    NODI_DRV_CHECK(p_uarte_drv != NULL, "Driver pointer is NULL!");
+    return p_uarte_drv->rx_amount;
+}
+
+uint32_t nodi_uarte_rx_count_get(nodi_uarte_drv_t *p_uarte_drv)
+{
+    NODI_DRV_CHECK(p_uarte_drv != NULL, "Driver pointer is NULL!");
+    NODI_DRV_CHECK(p_uarte_drv->config->p_idle_cfg != NULL, "Idle receive not configured!");
+
+    NRF_TIMER_Type * p_count = p_uarte_drv->config->p_idle_cfg->p_count_timer_reg;
+
+    p_count->TASKS_CAPTURE[1] = 1;
+    return p_count->CC[1];
+}
+
+static void nodi_uarte_rx_idle_irq_handle(nodi_uarte_drv_t *p_uarte_drv)
+{
+    NRF_UARTE_Type * p_reg = p_uarte_drv->p_uarte_reg;
+    const nodi_uarte_idle_config_s *p_idle = p_uarte_drv->config->p_idle_cfg;
+
+    /* Buffer is full or idle TIMER stopped receiver. After full buffer receiver keeps
+     * taking bytes into FIFO until STOPRX, they are flushed on RXTO. */
+    if (p_reg->EVENTS_ENDRX == 1)
+    {
+        p_reg->EVENTS_ENDRX = 0;
+        p_uarte_drv->rx_amount = p_reg->RXD.AMOUNT;
+        nodi_ppi_channels_disable(NODI_PPI_CH_MSK(p_idle->ppi_ch_count)   |
+                                  NODI_PPI_CH_MSK(p_idle->ppi_ch_restart) |
+                                  NODI_PPI_CH_MSK(p_idle->ppi_ch_timeout));
+        p_idle->p_idle_timer_reg->TASKS_STOP = 1;
+        p_idle->p_count_timer_reg->TASKS_STOP = 1;
+        p_reg->TASKS_STOPRX = 1;
+    }
+
+    if (p_reg->EVENTS_RXTO == 1)
+    {
+        p_reg->EVENTS_RXTO = 0;
+        p_reg->INTENCLR = UARTE_INTENCLR_RXTO_Msk;
+        p_uarte_drv->rx_idle = false;
+
+        /* Tail of packet overrunning the buffer does not fit, drop it. Flush takes a few
+         * cycles and its ENDRX must not reach receive handlers. */
+        if (p_uarte_drv->rx_amount == p_reg->RXD.MAXCNT)
+        {
+            p_reg->RXD.PTR    = (uint32_t)p_uarte_drv->rx_flush;
+            p_reg->RXD.MAXCNT = sizeof(p_uarte_drv->rx_flush);
+            p_reg->EVENTS_ENDRX = 0;
+            p_reg->TASKS_FLUSHRX = 1;
+            while (p_reg->EVENTS_ENDRX == 0)
+            {
+            }
+            p_reg->EVENTS_ENDRX = 0;
+        }
+
+        /* Sleep is left if callback starts another operation. */
+        void *p_sleep_buf = p_uarte_drv->p_sleep_buf;
+        p_uarte_drv->p_sleep_buf = NULL;
+
+        /* Set finish state to allow start next operation in callback. */
+        p_uarte_drv->uarte_rx_state = NODI_UARTE_DRV_STATE_FINISH;
+
+        if (p_uarte_drv->config->rx_end_cb)
+        {
+            p_uarte_drv->config->rx_end_cb(p_uarte_drv);
+        }
+
+        if (p_uarte_drv->uarte_rx_state == NODI_UARTE_DRV_STATE_FINISH)
+        {
+            p_uarte_drv->uarte_rx_state = NODI_UARTE_DRV_STATE_READY;
+
+            /* Packet woke receiver up, line is idle again, so it goes back to sleep. */
+            if (p_sleep_buf != NULL)
+            {
+                nodi_uarte_sleep(p_uarte_drv, p_uarte_drv->sleep_n, p_sleep_buf);
+            }
+        }
+    }
+}
+
 void nodi_uarte_irq_routine(void *p_ctx);
 
 void nodi_uarte_prepare(void)
@@ -47,6 +758,12 @@ void nodi_uarte_prepare(void)
     NODI_UARTE0.p_uarte_reg = NRF_UARTE0;
     NODI_UARTE0.irq = UARTE0_IRQn;
     NODI_UARTE0.irq_priority = NODI_UARTE_UARTE0_IRQ_PRIORITY;
+    NODI_UARTE0.p_rx_ring = NULL;
+    NODI_UARTE0.rx_idle = false;
+    NODI_UARTE0.wake_armed = false;
+    NODI_UARTE0.p_sleep_buf = NULL;
+    NODI_UARTE0.p_tx_head = NULL;
+    NODI_UARTE0.p_tx_tail = NULL;
 #ifndef NODI_UARTE_DISABLE_IRQ_CONNECT
     nodi_mnd_register(nodi_uarte_irq_routine, &NODI_UARTE0, UARTE0_IRQn);
 #endif
@@ -58,6 +775,12 @@ void nodi_uarte_prepare(void)
     NODI_UARTE1.p_uarte_reg = NRF_UARTE1;
     NODI_UARTE1.irq = UARTE1_IRQn;
     NODI_UARTE1.irq_priority = NODI_UARTE_UARTE1_IRQ_PRIORITY;
+    NODI_UARTE1.p_rx_ring = NULL;
+    NODI_UARTE1.rx_idle = false;
+    NODI_UARTE1.wake_armed = false;
+    NODI_UARTE1.p_sleep_buf = NULL;
+    NODI_UARTE1.p_tx_head = NULL;
+    NODI_UARTE1.p_tx_tail = NULL;
 #ifndef NODI_UARTE_DISABLE_IRQ_CONNECT
     nodi_mnd_register(nodi_uarte_irq_routine, &NODI_UARTE1, UARTE1_IRQn);
 #endif
@@ -78,9 +801,17 @@ void nodi_uarte_init(nodi_uarte_drv_t *p_uarte_drv)
     p_reg->PSEL.TXD = nodi_gpio_translate_periph(&p_uarte_drv->config->tx_pin);
     p_reg->PSEL.RXD = nodi_gpio_translate_periph(&p_uarte_drv->config->rx_pin);
 
-    /* Currently driver is not support flow control. Disable pins. */
-    p_reg->PSEL.RTS = 0xFFFFFFFF;
-    p_reg->PSEL.CTS = 0xFFFFFFFF;
+    /* Flow control pins are connected only if flow control is used. */
+    if (p_uarte_drv->config->hwfc == NODI_UARTE_HWFC_ENABLED)
+    {
+        p_reg->PSEL.RTS = nodi_gpio_translate_periph(&p_uarte_drv->config->rts_pin);
+        p_reg->PSEL.CTS = nodi_gpio_translate_periph(&p_uarte_drv->config->cts_pin);
+    }
+    else
+    {
+        p_reg->PSEL.RTS = 0xFFFFFFFF;
+        p_reg->PSEL.CTS = 0xFFFFFFFF;
+    }
 
     p_reg->BAUDRATE = p_uarte_drv->config->baudrate;
 
@@ -91,9 +822,38 @@ void nodi_uarte_init(nodi_uarte_drv_t *p_uarte_drv)
     p_reg->EVENTS_ENDRX = 0;
     p_reg->EVENTS_ENDTX = 0;
 
+    p_reg->EVENTS_ERROR = 0;
+    p_reg->ERRORSRC = p_reg->ERRORSRC;
+
     p_reg->INTENCLR = 0xFFFFFFFF;
     p_reg->INTENSET = UARTE_INTENSET_ENDRX_Msk |
-                      UARTE_INTENSET_ENDTX_Msk;
+                      UARTE_INTENSET_ENDTX_Msk |
+                      UARTE_INTENSET_ERROR_Msk;
+
+    p_uarte_drv->rx_error = false;
+    p_uarte_drv->err_stats.overrun = 0;
+    p_uarte_drv->err_stats.parity = 0;
+    p_uarte_drv->err_stats.framing = 0;
+    p_uarte_drv->err_stats.breaks = 0;
+    p_uarte_drv->err_stats.restarts = 0;
+    p_uarte_drv->wake_count = 0;
+    p_uarte_drv->wake_latency_ns = 0;
+    p_uarte_drv->p_sleep_buf = NULL;
+
+    p_uarte_drv->cts = false;
+    p_uarte_drv->ncts_count = 0;
+    if (p_uarte_drv->config->hwfc == NODI_UARTE_HWFC_ENABLED)
+    {
+        p_reg->EVENTS_CTS = 0;
+        p_reg->EVENTS_NCTS = 0;
+        p_reg->INTENSET = UARTE_INTENSET_CTS_Msk |
+                          UARTE_INTENSET_NCTS_Msk;
+    }
+
+    if (p_uarte_drv->config->p_rs485_cfg != NULL)
+    {
+        nodi_uarte_rs485_init(p_uarte_drv);
+    }
 
     /* Enable peripheral */
     p_reg->ENABLE = UARTE_ENABLE_ENABLE_Enabled;
@@ -119,6 +879,11 @@ void nodi_uarte_deinit(nodi_uarte_drv_t *p_uarte_drv)
     p_reg->INTENCLR = 0xFFFFFFFF;
     p_reg->ENABLE = UARTE_ENABLE_ENABLE_Disabled;
 
+    if (p_uarte_drv->config->p_rs485_cfg != NULL)
+    {
+        nodi_uarte_rs485_deinit(p_uarte_drv);
+    }
+
     p_uarte_drv->uarte_tx_state = NODI_UARTE_DRV_STATE_UNINIT;
     p_uarte_drv->uarte_rx_state = NODI_UARTE_DRV_STATE_UNINIT;
 }
@@ -138,6 +903,7 @@ void nodi_uarte_send_start(nodi_uarte_drv_t *p_uarte_drv, uint32_t n, const void
     p_reg->EVENTS_ENDTX = 0;
     p_reg->EVENTS_TXSTOPPED = 0;
     p_uarte_drv->uarte_tx_state = NODI_UARTE_DRV_STATE_BUSY;
+    nodi_uarte_rs485_tx_begin(p_uarte_drv);
     p_reg->TASKS_STARTTX = 1;
 }
 
@@ -149,8 +915,6 @@ void nodi_uarte_send_stop(nodi_uarte_drv_t *p_uarte_drv)
 
     NRF_UARTE_Type * p_reg = p_uarte_drv->p_uarte_reg;
 
-    p_reg->INTENCLR = UARTE_INTENCLR_ENDRX_Msk |
-                      UARTE_INTENCLR_ERROR_Msk;
     p_reg->TASKS_STOPTX = 1;
     p_uarte_drv->uarte_tx_state = NODI_UARTE_DRV_STATE_READY;
 }
@@ -180,12 +944,52 @@ void nodi_uarte_receive_stop(nodi_uarte_drv_t *p_uarte_drv)
     NODI_DRV_CHECK(p_uarte_drv != NULL, "Driver pointer is NULL!");
     NRF_UARTE_Type * p_reg = p_uarte_drv->p_uarte_reg;
 
-    p_reg->INTENCLR = UARTE_INTENCLR_ENDTX_Msk |
-                      UARTE_INTENCLR_ERROR_Msk;
-
     p_reg->TASKS_STOPRX = 1;
 }
 
+const nodi_uarte_err_stats_s *nodi_uarte_err_stats_get(nodi_uarte_drv_t *p_uarte_drv)
+{
+    NODI_DRV_CHECK(p_uarte_drv != NULL, "Driver pointer is NULL!");
+    return &p_uarte_drv->err_stats;
+}
+
+static void nodi_uarte_error_handle(nodi_uarte_drv_t *p_uarte_drv, bool rx_single)
+{
+    NRF_UARTE_Type * p_reg = p_uarte_drv->p_uarte_reg;
+    nodi_uarte_err_stats_s *p_stats = &p_uarte_drv->err_stats;
+
+    p_reg->EVENTS_ERROR = 0;
+    uint32_t errorsrc = p_reg->ERRORSRC;
+    p_reg->ERRORSRC = errorsrc;
+
+    p_stats->overrun += (errorsrc & UARTE_ERRORSRC_OVERRUN_Msk) ? 1 : 0;
+    p_stats->parity  += (errorsrc & UARTE_ERRORSRC_PARITY_Msk)  ? 1 : 0;
+    p_stats->framing += (errorsrc & UARTE_ERRORSRC_FRAMING_Msk) ? 1 : 0;
+    p_stats->breaks  += (errorsrc & UARTE_ERRORSRC_BREAK_Msk)   ? 1 : 0;
+
+    /* Single receive would wait for the rest of corrupted buffer. Stop it now and start
+     * it again on RXTO, when receiver is idle. */
+    if (rx_single && (p_uarte_drv->uarte_rx_state == NODI_UARTE_DRV_STATE_BUSY) &&
+        !p_uarte_drv->rx_error)
+    {
+        p_uarte_drv->rx_error = true;
+        p_reg->EVENTS_RXTO = 0;
+        p_reg->INTENSET = UARTE_INTENSET_RXTO_Msk;
+        p_reg->TASKS_STOPRX = 1;
+    }
+
+    if (p_uarte_drv->config->error_cb)
+    {
+        p_uarte_drv->config->error_cb(p_uarte_drv, errorsrc);
+    }
+}
+
+uint32_t nodi_uarte_ncts_count_get(nodi_uarte_drv_t *p_uarte_drv)
+{
+    NODI_DRV_CHECK(p_uarte_drv != NULL, "Driver pointer is NULL!");
+    return p_uarte_drv->ncts_count;
+}
+
 uint32_t nodi_uarte_receive_busy_check(nodi_uarte_drv_t *p_uarte_drv)
 {
     NODI_DRV_CHECK(p_uarte_drv != NULL, "Driver pointer is NULL!");
@@ -197,7 +1001,56 @@ void nodi_uarte_irq_routine(void *p_ctx)
     NODI_DRV_CHECK(p_ctx != NULL, "Context is NULL!");
     nodi_uarte_drv_t *p_uarte_drv = (nodi_uarte_drv_t *) p_ctx;
     NRF_UARTE_Type * p_reg = p_uarte_drv->p_uarte_reg;
-    if (p_reg->EVENTS_ENDTX == 1)
+
+    if (p_uarte_drv->wake_armed)
+    {
+        nodi_uarte_wake_handle(p_uarte_drv);
+    }
+
+    /* CTS events are only enabled with flow control. Transmission pauses in hardware. */
+    if ((p_reg->EVENTS_CTS == 1) || (p_reg->EVENTS_NCTS == 1))
+    {
+        if (p_reg->EVENTS_NCTS == 1)
+        {
+            p_reg->EVENTS_NCTS = 0;
+            p_uarte_drv->ncts_count++;
+            p_uarte_drv->cts = false;
+        }
+        /* CTS after NCTS means the line is active again. */
+        if (p_reg->EVENTS_CTS == 1)
+        {
+            p_reg->EVENTS_CTS = 0;
+            p_uarte_drv->cts = true;
+        }
+
+        if (p_uarte_drv->config->cts_cb)
+        {
+            p_uarte_drv->config->cts_cb(p_uarte_drv, p_uarte_drv->cts);
+        }
+    }
+
+    /* Continuous receive uses RXSTARTED and ENDRX of every block. */
+    bool rx_ring = (p_reg->INTENSET & UARTE_INTENSET_RXSTARTED_Msk) != 0;
+
+    if (p_reg->EVENTS_ERROR == 1)
+    {
+        nodi_uarte_error_handle(p_uarte_drv, !rx_ring && !p_uarte_drv->rx_idle);
+    }
+
+    if (rx_ring)
+    {
+        nodi_uarte_rx_ring_irq_handle(p_uarte_drv);
+    }
+    else if (p_uarte_drv->rx_idle)
+    {
+        nodi_uarte_rx_idle_irq_handle(p_uarte_drv);
+    }
+
+    if ((p_reg->EVENTS_ENDTX == 1) && (p_uarte_drv->p_tx_head != NULL))
+    {
+        nodi_uarte_tx_queue_end_handle(p_uarte_drv);
+    }
+    else if (p_reg->EVENTS_ENDTX == 1)
     {
         p_reg->EVENTS_ENDTX = 0;
         /* Set finish state to indicate operation end. */
@@ -216,7 +1069,23 @@ void nodi_uarte_irq_routine(void *p_ctx)
         }
     }
 
-    if (p_reg->EVENTS_ENDRX == 1)
+    /* Stopped reception is restarted to the same buffer, partial data is dropped. */
+    if (p_uarte_drv->rx_error)
+    {
+        if (p_reg->EVENTS_ENDRX == 1)
+        {
+            p_reg->EVENTS_ENDRX = 0;
+        }
+        if (p_reg->EVENTS_RXTO == 1)
+        {
+            p_reg->EVENTS_RXTO = 0;
+            p_reg->INTENCLR = UARTE_INTENCLR_RXTO_Msk;
+            p_uarte_drv->rx_error = false;
+            p_uarte_drv->err_stats.restarts++;
+            p_reg->TASKS_STARTRX = 1;
+        }
+    }
+    else if ((p_reg->EVENTS_ENDRX == 1) && !rx_ring && !p_uarte_drv->rx_idle)
     {
         p_reg->EVENTS_ENDRX = 0;
         /* Set finish state to indicate operation end. */
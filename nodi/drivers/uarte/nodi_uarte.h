@@ -47,17 +47,214 @@ typedef struct nodi_uarte_drv nodi_uarte_drv_t;
  */
 typedef void (*nodi_uarte_irq_callback_t)(nodi_uarte_drv_t *p_uarte_drv);
 
+/**
+ * @brief   UARTE flow control change callback type.
+ *
+ * @param[in] p_uarte_drv      pointer to the nodi_uarte_drv_t object triggering the callback
+ * @param[in] cts              true if peer allows transmission (CTS active)
+ */
+typedef void (*nodi_uarte_cts_callback_t)(nodi_uarte_drv_t *p_uarte_drv, bool cts);
+
+/**
+ * @brief   UARTE receive error callback type.
+ *
+ * @param[in] p_uarte_drv      pointer to the nodi_uarte_drv_t object triggering the callback
+ * @param[in] errorsrc         error sources (NODI_UARTE_ERROR_*)
+ */
+typedef void (*nodi_uarte_error_callback_t)(nodi_uarte_drv_t *p_uarte_drv, uint32_t errorsrc);
+
+/**
+ * @brief   UARTE receive error counters.
+ */
+typedef struct {
+    uint32_t                  overrun;   ///< Byte received before previous one was read from FIFO.
+    uint32_t                  parity;    ///< Parity errors.
+    uint32_t                  framing;   ///< Missing stop bits.
+    uint32_t                  breaks;    ///< Line held low longer than one character.
+    uint32_t                  restarts;  ///< Receptions restarted because of error.
+} nodi_uarte_err_stats_s;
+
+typedef struct nodi_uarte_tx_desc nodi_uarte_tx_desc_t;
+
+/**
+ * @brief   UARTE queued transmission callback type.
+ *
+ * @param[in] p_uarte_drv      pointer to the nodi_uarte_drv_t object triggering the callback
+ * @param[in] p_desc           pointer to the finished transmission descriptor
+ */
+typedef void (*nodi_uarte_tx_callback_t)(nodi_uarte_drv_t *p_uarte_drv,
+                                         nodi_uarte_tx_desc_t *p_desc);
+
+/**
+ * @brief   Gather list element.
+ */
+typedef struct {
+    const void               *p_buf;     ///< Data buffer.
+    uint32_t                  len;       ///< Data length, not limited by NODI_UARTE_MAXCNT.
+} nodi_uarte_seg_s;
+
+/**
+ * @brief   UARTE queued transmission descriptor.
+ *
+ * @details Descriptor and gather list memory is owned by the application and must stay
+ *          valid until the transmission callback is called.
+ */
+struct nodi_uarte_tx_desc {
+    nodi_uarte_tx_desc_t     *p_next;    ///< Next queued transmission. Managed by driver.
+    const nodi_uarte_seg_s   *p_segs;    ///< Gather list, sent in order as one frame.
+    uint32_t                  seg_count; ///< Number of gather list elements.
+    nodi_uarte_tx_callback_t  tx_cb;     ///< Transmission complete callback or NULL.
+    void                     *p_context; ///< Application context, not used by driver.
+};
+
+/**
+ * @brief   Continuous receive ring.
+ *
+ * @details Ring is owned by application. EasyDMA writes directly to its blocks, so
+ *          received data is not copied. Interrupt routine is the only writer of wr and
+ *          application the only writer of rd, so the ring needs no locking.
+ */
+typedef struct {
+    uint8_t                  *p_mem;       ///< block_count * block_len bytes.
+    uint16_t                 *p_amounts;   ///< Received bytes of every block, block_count entries.
+    uint32_t                  block_len;   ///< Block length, DMA transfer length (up to 255).
+    uint32_t                  block_count; ///< Number of blocks, power of two, at least 4.
+    volatile uint32_t         wr;          ///< Completed blocks counter. Managed by driver.
+    volatile uint32_t         rd;          ///< Released blocks counter. Managed by driver.
+    volatile uint32_t         lost;        ///< Bytes dropped because ring was full.
+} nodi_uarte_rx_ring_s;
+
+/**
+ * @brief Returns block index of block counter value.
+ *
+ * @details Counters run freely. Power of two block_count keeps the index continuous at
+ *          their wrap.
+ */
+static inline uint32_t nodi_uarte_rx_ring_idx(const nodi_uarte_rx_ring_s *p_ring, uint32_t cnt)
+{
+    return cnt & (p_ring->block_count - 1);
+}
+
+/**
+ * @brief Returns memory of block counter value.
+ */
+static inline uint8_t *nodi_uarte_rx_ring_block(const nodi_uarte_rx_ring_s *p_ring, uint32_t cnt)
+{
+    return p_ring->p_mem + nodi_uarte_rx_ring_idx(p_ring, cnt) * p_ring->block_len;
+}
+
+/**
+ * @brief Returns number of blocks left to the driver if blocks from rd up to cnt are held.
+ *
+ * @details Driver drops received blocks when less than 2 are left after wr.
+ */
+static inline uint32_t nodi_uarte_rx_ring_space(const nodi_uarte_rx_ring_s *p_ring, uint32_t cnt)
+{
+    return p_ring->block_count - (cnt - p_ring->rd);
+}
+
+/**
+ * @brief Looks at completed block without releasing it.
+ *
+ * @details Lets application keep several blocks, e.g. a line spanning them, and release
+ *          them later in order.
+ *
+ * @param[in]  p_ring           Receive ring.
+ * @param[in]  cnt              Block counter value, from rd to wr - 1 for completed blocks.
+ * @param[out] pp_data          Block data.
+ * @param[out] p_amount         Number of bytes in block.
+ *
+ * @return true if block is completed and not released yet.
+ */
+static inline bool nodi_uarte_rx_ring_peek(const nodi_uarte_rx_ring_s *p_ring, uint32_t cnt,
+                                           const uint8_t **pp_data, uint32_t *p_amount)
+{
+    if ((cnt - p_ring->rd) >= (p_ring->wr - p_ring->rd))
+    {
+        return false;
+    }
+    *pp_data = nodi_uarte_rx_ring_block(p_ring, cnt);
+    *p_amount = p_ring->p_amounts[nodi_uarte_rx_ring_idx(p_ring, cnt)];
+    return true;
+}
+
+/**
+ * @brief   Idle line receive configuration.
+ *
+ * @details Every RXDRDY is counted by counter TIMER and restarts idle TIMER through PPI.
+ *          When line is idle for configured time, idle TIMER triggers STOPRX.
+ */
+typedef struct {
+    NRF_TIMER_Type           *p_count_timer_reg; ///< TIMER counting received bytes.
+    NRF_TIMER_Type           *p_idle_timer_reg;  ///< TIMER measuring line idle time.
+    uint8_t                   ppi_ch_count;      ///< PPI channel: RXDRDY -> counter COUNT.
+    uint8_t                   ppi_ch_restart;    ///< PPI channel: RXDRDY -> idle CLEAR and START.
+    uint8_t                   ppi_ch_timeout;    ///< PPI channel: idle COMPARE[0] -> UARTE STOPRX.
+    uint8_t                   timeout_chars;     ///< Idle time in character times.
+} nodi_uarte_idle_config_s;
+
+/**
+ * @brief   Automatic baudrate detection configuration.
+ *
+ * @details Falling edge on RX pin clears and starts TIMER, rising edge captures it and
+ *          disables both PPI channels through PPI group, so only the first low pulse is
+ *          measured. Peer has to send sync character with bit 0 set, e.g. 'U' or 'A'.
+ */
+typedef struct {
+    NRF_TIMER_Type           *p_timer_reg;   ///< TIMER measuring start bit.
+    uint8_t                   gpiote_ch_fall; ///< GPIOTE channel: RX pin falling edge.
+    uint8_t                   gpiote_ch_rise; ///< GPIOTE channel: RX pin rising edge.
+    uint8_t                   ppi_ch_fall;   ///< PPI channel: falling edge -> TIMER CLEAR and START.
+    uint8_t                   ppi_ch_rise;   ///< PPI channel: rising edge -> TIMER CAPTURE and group disable.
+    uint8_t                   ppi_group;     ///< PPI group of both channels.
+} nodi_uarte_autobaud_config_s;
+
+/**
+ * @brief   Wake on RX edge configuration.
+ *
+ * @details RX pin SENSE low raises GPIOTE PORT event, which starts receiver through PPI
+ *          without CPU. RXSTARTED captures TIMER started by the same event and disables
+ *          both PPI channels. PORT event is shared by all pins with SENSE enabled.
+ */
+typedef struct {
+    NRF_TIMER_Type           *p_timer_reg;   ///< TIMER measuring wake latency.
+    uint8_t                   ppi_ch_wake;   ///< PPI channel: PORT event -> STARTRX and TIMER START.
+    uint8_t                   ppi_ch_started; ///< PPI channel: RXSTARTED -> TIMER CAPTURE and group disable.
+    uint8_t                   ppi_group;     ///< PPI group of both channels.
+} nodi_uarte_wake_config_s;
+
+/**
+ * @brief   RS-485 driver enable configuration.
+ *
+ * @details DE pin is driven by GPIOTE. Driver sets it before STARTTX, ENDTX starts TIMER
+ *          through PPI and TIMER COMPARE[0] clears it when the last character has left
+ *          the line, so turnaround does not depend on interrupt latency.
+ */
+typedef struct {
+    nodi_gpio_pin_t           de_pin;        ///< Transceiver driver enable pin, active high.
+    NRF_TIMER_Type           *p_timer_reg;   ///< TIMER delaying DE release.
+    uint8_t                   gpiote_ch;     ///< GPIOTE channel driving DE pin.
+    uint8_t                   ppi_ch_end;    ///< PPI channel: ENDTX -> TIMER START.
+    uint8_t                   ppi_ch_release; ///< PPI channel: TIMER COMPARE[0] -> DE clear.
+    uint8_t                   tail_bits;     ///< Bit times from ENDTX to DE release, 0 for one character and one bit.
+} nodi_uarte_rs485_config_s;
 
 typedef struct {
     nodi_uarte_irq_callback_t tx_end_cb; ///< Transmit operation complete callback or NULL.
     nodi_uarte_irq_callback_t rx_end_cb; ///< Receive operation complete callback or NULL.
     nodi_gpio_pin_t           rx_pin;    ///< RX pin config structure
     nodi_gpio_pin_t           tx_pin;    ///< TX pin config structure
-    nodi_gpio_pin_t           rts_pin;   ///< RTS pin config structure
-    nodi_gpio_pin_t           cts_pin;   ///< CTS pin config structure
-    uint32_t                  hwfc;      ///< Flow control configuration.
+    nodi_gpio_pin_t           rts_pin;   ///< RTS pin config structure, used if hwfc is enabled.
+    nodi_gpio_pin_t           cts_pin;   ///< CTS pin config structure, used if hwfc is enabled.
+    uint32_t                  hwfc;      ///< Flow control configuration (NODI_UARTE_HWFC_*).
+    nodi_uarte_cts_callback_t cts_cb;    ///< CTS change callback or NULL.
+    nodi_uarte_error_callback_t error_cb; ///< Receive error callback or NULL.
+    const nodi_uarte_autobaud_config_s *p_autobaud_cfg; ///< Baudrate detection resources or NULL.
+    const nodi_uarte_wake_config_s *p_wake_cfg; ///< Wake on RX edge resources or NULL.
+    const nodi_uarte_rs485_config_s *p_rs485_cfg; ///< RS-485 driver enable resources or NULL.
     uint32_t                  parity;    ///< Parity configuration.
     uint32_t                  baudrate;  ///< Baudrate.
+    const nodi_uarte_idle_config_s *p_idle_cfg; ///< Idle line receive resources or NULL.
 } nodi_uarte_config_s;
 
 /**
@@ -80,6 +277,26 @@ struct nodi_uarte_drv {
     NRF_UARTE_Type             *p_uarte_reg;    ///< Pointer to the UARTE registers block.
     IRQn_Type                   irq;            ///< UARTE peripheral instance IRQ number.
     uint8_t                     irq_priority;   ///< Interrupt priority.
+    nodi_uarte_rx_ring_s       *p_rx_ring;      ///< Continuous receive ring or NULL.
+    bool                        rx_ring_drop;   ///< Block in progress is overwritten by the next one.
+    volatile bool               rx_ring_stop;   ///< Continuous receive stop requested.
+    nodi_uarte_tx_desc_t       *p_tx_head;      ///< Transmission in progress or NULL.
+    nodi_uarte_tx_desc_t       *p_tx_tail;      ///< Last queued transmission or NULL.
+    uint32_t                    tx_seg;         ///< Gather list element in progress.
+    uint32_t                    tx_off;         ///< Sent bytes of gather list element in progress.
+    uint32_t                    tx_chunk;       ///< Length of chunk in progress.
+    volatile bool               rx_idle;        ///< Idle line receive in progress.
+    uint32_t                    rx_amount;      ///< Bytes received by the last idle line receive.
+    uint8_t                     rx_flush[4];    ///< RX FIFO flush target, EasyDMA needs RAM.
+    volatile bool               cts;            ///< Last CTS state reported by peripheral.
+    uint32_t                    ncts_count;     ///< Number of times peer stopped transmission.
+    volatile bool               rx_error;       ///< Reception is restarted because of error.
+    nodi_uarte_err_stats_s      err_stats;      ///< Receive error counters.
+    volatile bool               wake_armed;     ///< Receiver is stopped and waits for RX edge.
+    uint32_t                    wake_count;     ///< Number of wake ups.
+    uint32_t                    wake_latency_ns; ///< Last time from RX edge to RXSTARTED.
+    void                       *p_sleep_buf;    ///< Sleep buffer rearmed after idle line receive or NULL.
+    uint32_t                    sleep_n;        ///< Length of p_sleep_buf.
 };
 
 /*===========================================================================*/
@@ -155,6 +372,201 @@ void nodi_uarte_receive_stop(nodi_uarte_drv_t *p_uarte_drv);
  */
 uint32_t nodi_uarte_receive_busy_check(nodi_uarte_drv_t *p_uarte_drv);
 
+/**
+ * @brief Returns number of times peer stopped transmission by deactivating CTS.
+ *
+ * @details With hwfc enabled transmission pauses in hardware while CTS is inactive and
+ *          RTS is deactivated when receiver is stopped or its FIFO can take only 4 more
+ *          bytes, so receive buffers may be swapped in callbacks without overruns.
+ *
+ * @param[in] p_uarte_drv       Pointer to structure representing UARTE driver.
+ *
+ * @return NCTS events counter.
+ */
+uint32_t nodi_uarte_ncts_count_get(nodi_uarte_drv_t *p_uarte_drv);
+
+/**
+ * @brief Returns receive error counters.
+ *
+ * @details Errors are handled in interrupt routine. Single receive is stopped and started
+ *          again to the same buffer without calling rx_end_cb, so corrupted data is not
+ *          delivered. Continuous and idle line receive continue, error_cb can be used to
+ *          resynchronize upper layer, e.g. frame decoder.
+ *
+ * @param[in] p_uarte_drv       Pointer to structure representing UARTE driver.
+ *
+ * @return Pointer to error counters.
+ */
+const nodi_uarte_err_stats_s *nodi_uarte_err_stats_get(nodi_uarte_drv_t *p_uarte_drv);
+
+/**
+ * @brief Calculates BAUDRATE register value for any baudrate.
+ *
+ * @details Register holds baudrate * 2^32 / 16 MHz, hardware uses only its upper 20 bits.
+ *
+ * @param[in]  baud             Requested baudrate in bits per second.
+ * @param[out] p_err_ppm        Error of generated baudrate in ppm or NULL.
+ *
+ * @return BAUDRATE register value.
+ */
+uint32_t nodi_uarte_baudrate_calc(uint32_t baud, int32_t *p_err_ppm);
+
+/**
+ * @brief Changes baudrate without reinitialization of the driver.
+ *
+ * @details New baudrate is used from the next character, so it should be changed
+ *          when line is idle.
+ *
+ * @param[in] p_uarte_drv       Pointer to structure representing UARTE driver.
+ * @param[in] baudrate          BAUDRATE register value, NODI_UARTE_BAUD_* or calculated.
+ */
+void nodi_uarte_baudrate_set(nodi_uarte_drv_t *p_uarte_drv, uint32_t baudrate);
+
+/**
+ * @brief Arms automatic baudrate detection on the next character.
+ *
+ * @param[in] p_uarte_drv       Pointer to structure representing UARTE driver.
+ */
+void nodi_uarte_autobaud_start(nodi_uarte_drv_t *p_uarte_drv);
+
+/**
+ * @brief Checks automatic baudrate detection and applies detected baudrate.
+ *
+ * @details Measured rate within 3% of standard baudrate is rounded to it, otherwise
+ *          the closest rate generated by the peripheral is used. Detection resources
+ *          are released when baudrate is applied.
+ *
+ * @param[in] p_uarte_drv       Pointer to structure representing UARTE driver.
+ *
+ * @return Applied baudrate in bits per second or 0 if start bit was not measured yet.
+ */
+uint32_t nodi_uarte_autobaud_poll(nodi_uarte_drv_t *p_uarte_drv);
+
+/**
+ * @brief Appends transmission to the driver's queue.
+ *
+ * Gather list elements are sent directly from their buffers, elements longer than
+ * NODI_UARTE_MAXCNT are sent in chunks. Next chunk and next queued transmission are
+ * started directly from the interrupt routine, before the callback of the finished
+ * transmission is called. Function can be called from the transmission callback and
+ * from any interrupt priority.
+ *
+ * @param[in] p_uarte_drv       Pointer to structure representing UARTE driver.
+ * @param[in] p_desc            Transmission descriptor.
+ */
+void nodi_uarte_tx_queue_push(nodi_uarte_drv_t *p_uarte_drv, nodi_uarte_tx_desc_t *p_desc);
+
+/**
+ * @brief Checks if driver's transmit queue has pending transmissions.
+ *
+ * @param[in] p_uarte_drv       Pointer to structure representing UARTE driver.
+ *
+ * @return 1 if queue is not empty, 0 otherwise.
+ */
+uint32_t nodi_uarte_tx_queue_busy_check(nodi_uarte_drv_t *p_uarte_drv);
+
+/**
+ * @brief Starts receive finished by full buffer or by idle line.
+ *
+ * @details rx_end_cb is called when n bytes are received or when line is idle for
+ *          timeout_chars character times after the last byte. Number of received bytes
+ *          is returned by nodi_uarte_rx_amount_get. Packet longer than buffer loses its
+ *          tail: bytes received after buffer is full are dropped, so the next receive
+ *          starts with a clean FIFO.
+ *
+ * @param[in] p_uarte_drv       Pointer to structure representing UARTE driver.
+ * @param[in] n                 Buffer length.
+ * @param[in] p_rxbuf           Pointer to the receive buffer.
+ */
+void nodi_uarte_receive_idle_start(nodi_uarte_drv_t *p_uarte_drv, uint32_t n, void *p_rxbuf);
+
+/**
+ * @brief Stops receiver until activity on RX pin.
+ *
+ * @details Receive to p_rxbuf is prepared and started by the first low level on RX pin,
+ *          detected by GPIO SENSE and GPIOTE PORT event through PPI. Stopped receiver and
+ *          SENSE do not need HFCLK, so idle current is System ON sleep current; GPIOTE IN
+ *          channel would keep HFCLK running. Driver sets SENSE of RX pin and clears it on
+ *          wake. Other pins with SENSE enabled share PORT event and wake receiver too.
+ *
+ *          Receive is finished like idle line receive if p_idle_cfg is set, otherwise like
+ *          single receive. After idle line receive the receiver goes back to sleep with
+ *          the same buffer once rx_end_cb returns, unless the callback started another
+ *          operation, so data has to be consumed in the callback. Startup takes a few
+ *          microseconds, first character can be lost at high baudrates, so protocol
+ *          should start with preamble, e.g. 0x55 or COBS delimiter. Call it when line is
+ *          idle.
+ *
+ * @param[in] p_uarte_drv       Pointer to structure representing UARTE driver.
+ * @param[in] n                 Buffer length.
+ * @param[in] p_rxbuf           Pointer to the receive buffer.
+ */
+void nodi_uarte_sleep(nodi_uarte_drv_t *p_uarte_drv, uint32_t n, void *p_rxbuf);
+
+/**
+ * @brief Returns time from the last wake edge to receiver start.
+ *
+ * @param[in] p_uarte_drv       Pointer to structure representing UARTE driver.
+ *
+ * @return Wake latency in nanoseconds, 0 if there was no wake up.
+ */
+uint32_t nodi_uarte_wake_latency_get(nodi_uarte_drv_t *p_uarte_drv);
+
+/**
+ * @brief Returns number of bytes received by the last idle line receive.
+ *
+ * @param[in] p_uarte_drv       Pointer to structure representing UARTE driver.
+ *
+ * @return Received bytes.
+ */
+uint32_t nodi_uarte_rx_amount_get(nodi_uarte_drv_t *p_uarte_drv);
+
+/**
+ * @brief Returns number of bytes received so far by idle line receive in progress.
+ *
+ * @param[in] p_uarte_drv       Pointer to structure representing UARTE driver.
+ *
+ * @return Received bytes.
+ */
+uint32_t nodi_uarte_rx_count_get(nodi_uarte_drv_t *p_uarte_drv);
+
+/**
+ * @brief Starts continuous receive to ring of blocks.
+ *
+ * @details ENDRX_STARTRX short restarts reception in hardware and the next block is
+ *          loaded on RXSTARTED, so there is no gap between blocks. rx_end_cb is called
+ *          after every completed block. If application does not release blocks in time,
+ *          the newest block is dropped and counted in lost.
+ *
+ * @param[in] p_uarte_drv       Pointer to structure representing UARTE driver.
+ * @param[in] p_ring            Receive ring.
+ */
+void nodi_uarte_rx_ring_start(nodi_uarte_drv_t *p_uarte_drv, nodi_uarte_rx_ring_s *p_ring);
+
+/**
+ * @brief Stops continuous receive. Partial block is completed with its byte count.
+ *
+ * @param[in] p_uarte_drv       Pointer to structure representing UARTE driver.
+ */
+void nodi_uarte_rx_ring_stop(nodi_uarte_drv_t *p_uarte_drv);
+
+/**
+ * @brief Returns the oldest completed block of receive ring.
+ *
+ * @param[in]  p_uarte_drv      Pointer to structure representing UARTE driver.
+ * @param[out] pp_data          Block data.
+ *
+ * @return Number of bytes in block or 0 if no block is completed.
+ */
+uint32_t nodi_uarte_rx_ring_get(nodi_uarte_drv_t *p_uarte_drv, const uint8_t **pp_data);
+
+/**
+ * @brief Gives the oldest completed block back to the driver.
+ *
+ * @param[in] p_uarte_drv       Pointer to structure representing UARTE driver.
+ */
+void nodi_uarte_rx_ring_release(nodi_uarte_drv_t *p_uarte_drv);
+
 /**
  * @brief Deinitializes UARTE peripheral.
  *
@@ -50,5 +50,23 @@
 #define NODI_UARTE_BAUD_921600  UARTE_BAUDRATE_BAUDRATE_Baud921600
 #define NODI_UARTE_BAUD_1M      UARTE_BAUDRATE_BAUDRATE_Baud1M
 
+/**
+ * @brief Hardware flow control configuration.
+ */
+#define NODI_UARTE_HWFC_DISABLED UARTE_CONFIG_HWFC_Disabled
+#define NODI_UARTE_HWFC_ENABLED  UARTE_CONFIG_HWFC_Enabled
+
+/**
+ * @brief Receive error sources, reported by error callback.
+ */
+#define NODI_UARTE_ERROR_OVERRUN UARTE_ERRORSRC_OVERRUN_Msk
+#define NODI_UARTE_ERROR_PARITY  UARTE_ERRORSRC_PARITY_Msk
+#define NODI_UARTE_ERROR_FRAMING UARTE_ERRORSRC_FRAMING_Msk
+#define NODI_UARTE_ERROR_BREAK   UARTE_ERRORSRC_BREAK_Msk
+
+/**
+ * @brief Maximum length of single EasyDMA transfer.
+ */
+#define NODI_UARTE_MAXCNT       255
 
 #endif /* NODI_UARTE_CONST_H */
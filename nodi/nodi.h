@@ -34,7 +34,14 @@
 #include "nodi_gpio.h"
 #include "nodi_rtc.h"
 #include "nodi_spim.h"
+#include "nodi_spi_nor.h"
+#include "nodi_display.h"
+#include "nodi_regmap.h"
 #include "nodi_uarte.h"
+#include "nodi_log.h"
+#include "nodi_frame.h"
+#include "nodi_at.h"
+#include "nodi_bridge.h"
 
 void nodi_init(void);
 
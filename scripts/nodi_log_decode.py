@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+#
+# Decodes binary log produced by nodi_log.
+#
+# Usage: nodi_log_decode.py firmware.elf capture.bin [--hz 64000000]
+#        cat /dev/ttyACM0 | nodi_log_decode.py firmware.elf -
+#
+# Record: 0xA0 | n, 16-bit message ID, 32-bit timestamp, n 32-bit arguments,
+# all little endian. Message ID is address of format string in .nodi_log_fmt
+# section of ELF file.
+
+import re
+import struct
+import sys
+
+SYNC = 0xA0
+ARGS_MAX = 6
+
+
+def fmt_section_read(elf_path):
+    with open(elf_path, 'rb') as f:
+        elf = f.read()
+    if elf[:4] != b'\x7fELF' or elf[4] != 1 or elf[5] != 1:
+        sys.exit('Only 32-bit little endian ELF files are supported')
+
+    e_shoff, = struct.unpack_from('<I', elf, 0x20)
+    e_shentsize, e_shnum, e_shstrndx = struct.unpack_from('<HHH', elf, 0x2E)
+
+    def section(i):
+        return struct.unpack_from('<IIIIIIIIII', elf, e_shoff + i * e_shentsize)
+
+    strtab = section(e_shstrndx)
+    for i in range(e_shnum):
+        name, _, _, addr, offset, size, _, _, _, _ = section(i)
+        start = strtab[4] + name
+        if elf[start:elf.index(b'\0', start)] == b'.nodi_log_fmt':
+            return addr, elf[offset:offset + size]
+    sys.exit('No .nodi_log_fmt section, is nodi_log linked in?')
+
+
+def fmt_get(base, data, msg_id):
+    start = msg_id - base
+    if start < 0 or start >= len(data):
+        return None
+    text = data[start:data.index(b'\0', start)]
+    # Alignment padding between strings is not a message.
+    return text.decode('ascii', 'replace') if text else None
+
+
+def text_format(fmt, args):
+    # C length modifiers are not used by Python, signed conversions need sign.
+    spec = r'%([-+ #0]*\d*(?:\.\d+)?)(?:hh|h|ll|l|z|t)?([diuxXoc%])'
+    conv = [m[1] for m in re.findall(spec, fmt) if m[1] != '%']
+    fmt = re.sub(spec, lambda m: '%' + m.group(1) + ('d' if m.group(2) == 'u' else m.group(2)), fmt)
+    vals = []
+    for c, a in zip(conv, args):
+        if c in 'di' and a & 0x80000000:
+            a -= 1 << 32
+        vals.append(a)
+    try:
+        return fmt % tuple(vals)
+    except (TypeError, ValueError):
+        return fmt + ' ' + ' '.join('0x%08x' % a for a in args)
+
+
+def main():
+    args = sys.argv[1:]
+    hz = None
+    if '--hz' in args:
+        i = args.index('--hz')
+        hz = float(args[i + 1])
+        del args[i:i + 2]
+    if len(args) != 2:
+        sys.exit('Usage: nodi_log_decode.py firmware.elf capture.bin [--hz F]')
+
+    base, data = fmt_section_read(args[0])
+    stream = sys.stdin.buffer if args[1] == '-' else open(args[1], 'rb')
+    buf = b''
+
+    while True:
+        chunk = stream.read1(4096) if hasattr(stream, 'read1') else stream.read(4096)
+        if not chunk:
+            break
+        buf += chunk
+        while len(buf) >= 7:
+            n = buf[0] & 0x0F
+            if (buf[0] & 0xF0) != SYNC or n > ARGS_MAX:
+                buf = buf[1:]
+                continue
+            length = 7 + 4 * n
+            if len(buf) < length:
+                break
+            msg_id, ts = struct.unpack_from('<HI', buf, 1)
+            fmt = fmt_get(base, data, msg_id)
+            if fmt is None:
+                # Not a record start, resynchronize on the next byte.
+                buf = buf[1:]
+                continue
+            vals = struct.unpack_from('<%dI' % n, buf, 7)
+            buf = buf[length:]
+            stamp = '%12.6f' % (ts / hz) if hz else '%10u' % ts
+            print('[%s] %s' % (stamp, text_format(fmt, vals)), flush=True)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,310 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/* Display pipeline flush against simulated MIPI DCS panel sharing SPIM with another
+ * device on urgent lane. Every region has to reach the panel as one CS frame. */
+
+#include <stdio.h>
+#include <string.h>
+#include "nodi_display.h"
+#include "sim.h"
+#include "sim_gpio.h"
+#include "sim_spim.h"
+
+#define TEST_W                100
+#define TEST_H                60
+#define TEST_PANEL_CS_PIN     4
+#define TEST_OTHER_CS_PIN     5
+#define TEST_DC_PIN           6
+#define TEST_OTHER_DESCS      64
+
+typedef struct {
+    sim_spi_dev_s             dev;
+    uint8_t                   mem[TEST_W * TEST_H * 2];
+    uint8_t                   cmd;
+    uint32_t                  param;
+    uint16_t                  caset[2];
+    uint16_t                  raset[2];
+    uint32_t                  x;
+    uint32_t                  y;
+    uint32_t                  byte;
+    uint32_t                  frames;
+    uint32_t                  frame_cmds;      // Commands in current frame
+    uint32_t                  frame_ramwr;     // RAMWR commands in current frame
+    uint32_t                  bad_frames;      // Frames not being CASET, RASET, RAMWR and data
+} test_panel_s;
+
+static const nodi_spim_config_s test_spim_cfg = {
+    .sck_pin   = NODI_GPIO_PIN(NODI_GPIO_P0, 1),
+    .mosi_pin  = NODI_GPIO_PIN(NODI_GPIO_P0, 2),
+    .miso_pin  = NODI_GPIO_PIN(NODI_GPIO_P0, 3),
+    .frequency = NODI_SPIM_FREQ_8M,
+    .mode      = NODI_SPIM_MODE_0,
+    .bit_order = NODI_SPIM_BIT_ORDER_MSB_FIRST,
+    .orc       = 0xFF,
+};
+
+static const nodi_spim_dev_s test_panel_dev = {
+    .cs_pin    = NODI_GPIO_PIN(NODI_GPIO_P0, TEST_PANEL_CS_PIN),
+    .frequency = NODI_SPIM_FREQ_8M,
+    .mode      = NODI_SPIM_MODE_0,
+    .bit_order = NODI_SPIM_BIT_ORDER_MSB_FIRST,
+    .orc       = 0xFF,
+};
+
+static const nodi_spim_dev_s test_other_dev = {
+    .cs_pin    = NODI_GPIO_PIN(NODI_GPIO_P0, TEST_OTHER_CS_PIN),
+    .frequency = NODI_SPIM_FREQ_8M,
+    .mode      = NODI_SPIM_MODE_0,
+    .bit_order = NODI_SPIM_BIT_ORDER_MSB_FIRST,
+    .orc       = 0xFF,
+};
+
+static const nodi_gpio_pin_t test_dc = NODI_GPIO_PIN(NODI_GPIO_P0, TEST_DC_PIN);
+
+static void test_flush_cb(nodi_display_t *p_disp);
+
+static uint8_t test_fb[TEST_W * TEST_H * 2];
+
+static const nodi_display_config_s test_disp_cfg = {
+    .p_spim_drv = &NODI_SPIM0,
+    .p_dev      = &test_panel_dev,
+    .dc_pin     = NODI_GPIO_PIN(NODI_GPIO_P0, TEST_DC_PIN),
+    .p_framebuf = test_fb,
+    .width      = TEST_W,
+    .height     = TEST_H,
+    .flush_cb   = test_flush_cb,
+};
+
+static test_panel_s test_panel;
+static sim_spi_dev_s test_other;
+static sim_spim_s *p_test_bus;
+static nodi_display_t test_disp;
+static uint32_t test_flushes;
+
+static nodi_spim_xfer_desc_t test_other_descs[TEST_OTHER_DESCS];
+static uint8_t test_other_tx[TEST_OTHER_DESCS][8];
+
+static void test_panel_cs(sim_spi_dev_s *p_dev, bool selected)
+{
+    test_panel_s *p_panel = (test_panel_s *)p_dev;
+
+    if (selected)
+    {
+        p_panel->frames++;
+        p_panel->frame_cmds = 0;
+        p_panel->frame_ramwr = 0;
+        return;
+    }
+    if ((p_panel->frame_cmds != 3) || (p_panel->frame_ramwr != 1))
+    {
+        p_panel->bad_frames++;
+    }
+}
+
+static uint8_t test_panel_xfer(sim_spi_dev_s *p_dev, uint8_t mosi)
+{
+    test_panel_s *p_panel = (test_panel_s *)p_dev;
+
+    if (!sim_gpio_level_get(TEST_DC_PIN))
+    {
+        p_panel->cmd = mosi;
+        p_panel->param = 0;
+        p_panel->frame_cmds++;
+        if (mosi == NODI_DISPLAY_CMD_RAMWR)
+        {
+            p_panel->frame_ramwr++;
+            p_panel->x = p_panel->caset[0];
+            p_panel->y = p_panel->raset[0];
+            p_panel->byte = 0;
+        }
+        return 0xFF;
+    }
+
+    switch (p_panel->cmd)
+    {
+    case NODI_DISPLAY_CMD_CASET:
+    case NODI_DISPLAY_CMD_RASET:
+    {
+        uint16_t *p_win = p_panel->cmd == NODI_DISPLAY_CMD_CASET ? p_panel->caset : p_panel->raset;
+        SIM_CHECK(p_panel->param < 4);
+        p_win[p_panel->param / 2] = (uint16_t)((p_win[p_panel->param / 2] << 8) | mosi);
+        p_panel->param++;
+        break;
+    }
+    case NODI_DISPLAY_CMD_RAMWR:
+        /* Memory pointer walks the window row by row. */
+        SIM_CHECK((p_panel->y <= p_panel->raset[1]) && (p_panel->x < TEST_W) && (p_panel->y < TEST_H));
+        p_panel->mem[(p_panel->y * TEST_W + p_panel->x) * 2 + p_panel->byte] = mosi;
+        if (++p_panel->byte == 2)
+        {
+            p_panel->byte = 0;
+            if (p_panel->x++ == p_panel->caset[1])
+            {
+                p_panel->x = p_panel->caset[0];
+                p_panel->y++;
+            }
+        }
+        break;
+    default:
+        SIM_CHECK(false);
+        break;
+    }
+    return 0xFF;
+}
+
+static uint8_t test_other_xfer(sim_spi_dev_s *p_dev, uint8_t mosi)
+{
+    return mosi;
+}
+
+static void test_flush_cb(nodi_display_t *p_disp)
+{
+    SIM_CHECK(p_disp == &test_disp);
+    test_flushes++;
+}
+
+static void test_other_push(void *p_ctx, uint32_t arg)
+{
+    nodi_spim_xfer_desc_t *p_desc = &test_other_descs[arg];
+
+    memset(p_desc, 0, sizeof(*p_desc));
+    p_desc->p_txbuf = test_other_tx[arg];
+    p_desc->n_tx = sizeof(test_other_tx[arg]);
+    p_desc->lane = NODI_SPIM_LANE_URGENT;
+    nodi_spim_bus_push(&NODI_SPIM0, &test_other_dev, p_desc);
+}
+
+static void test_setup(void)
+{
+    static const nodi_gpio_pin_t *cs_pins[] = { &test_panel_dev.cs_pin, &test_other_dev.cs_pin };
+
+    sim_init();
+    p_test_bus = sim_spim_add(NRF_SPIM0);
+
+    /* Application configures GPIO, CS is inactive before it becomes output. */
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        nodi_gpio_set(cs_pins[i]->p_port, cs_pins[i]->pin);
+        nodi_gpio_config(cs_pins[i]->p_port, cs_pins[i]->pin, NODI_GPIO_CFG_SPI_CS);
+    }
+    nodi_gpio_config(test_dc.p_port, test_dc.pin, NODI_GPIO_CFG_STD_OUTPUT);
+
+    memset(&test_panel, 0, sizeof(test_panel));
+    test_panel.dev = (sim_spi_dev_s){ .cs_psel = TEST_PANEL_CS_PIN, .cs_cb = test_panel_cs,
+                                      .xfer_cb = test_panel_xfer };
+    test_other = (sim_spi_dev_s){ .cs_psel = TEST_OTHER_CS_PIN, .xfer_cb = test_other_xfer };
+    sim_spim_dev_attach(p_test_bus, &test_panel.dev);
+    sim_spim_dev_attach(p_test_bus, &test_other);
+
+    nodi_spim_prepare();
+    NODI_SPIM0.config = &test_spim_cfg;
+    nodi_spim_init(&NODI_SPIM0);
+
+    nodi_display_init(&test_disp, &test_disp_cfg);
+    test_flushes = 0;
+}
+
+static void test_fb_draw(uint32_t seed)
+{
+    for (uint32_t i = 0; i < sizeof(test_fb); i++)
+    {
+        test_fb[i] = (uint8_t)(i * 13 + seed);
+    }
+}
+
+/* Flushes with urgent transactions of other device pushed in the meantime. */
+static void test_flush_run(uint32_t flushes)
+{
+    uint64_t t = sim_now();
+
+    for (uint32_t i = 0; i < TEST_OTHER_DESCS; i++)
+    {
+        t += SIM_US(1) + sim_rand() % SIM_US(60);
+        sim_at(t, test_other_push, NULL, i);
+    }
+    nodi_display_flush(&test_disp);
+    sim_run(SIM_FOREVER);
+
+    SIM_CHECK(test_flushes == flushes);
+    SIM_CHECK(test_disp.state == NODI_DISPLAY_STATE_READY);
+    SIM_CHECK(nodi_spim_queue_busy_check(&NODI_SPIM0) == 0);
+    SIM_CHECK(p_test_bus->conflicts == 0);
+    SIM_CHECK(sim_gpio_level_get(TEST_PANEL_CS_PIN) && sim_gpio_level_get(TEST_DC_PIN));
+    SIM_CHECK(test_panel.frames == nodi_display_stats_get(&test_disp)->regions);
+    SIM_CHECK(test_panel.bad_frames == 0);
+}
+
+/* Panel content is unknown after init, whole framebuffer is sent. */
+static void test_full(void)
+{
+    test_setup();
+    sim_seed(0xF1);
+    test_fb_draw(0);
+    test_flush_run(1);
+    SIM_CHECK(memcmp(test_panel.mem, test_fb, sizeof(test_fb)) == 0);
+    SIM_CHECK(nodi_display_stats_get(&test_disp)->last_flush_bytes == sizeof(test_fb));
+}
+
+/* Only dirty regions are sent, narrow ones as strided rows. */
+static void test_partial(void)
+{
+    static uint8_t panel_before[sizeof(test_fb)];
+
+    test_setup();
+    sim_seed(0xF2);
+    sim_irq_latency_max_ns = 2000;
+    test_fb_draw(0);
+    test_flush_run(1);
+
+    memcpy(panel_before, test_panel.mem, sizeof(panel_before));
+    test_fb_draw(0x80);
+    test_panel.frames = 0;
+    test_disp.stats.regions = 0;
+    nodi_display_invalidate(&test_disp, 5, 5, 10, 10);      // Tile (0, 0)
+    nodi_display_invalidate(&test_disp, 70, 20, 30, 30);    // Tiles (4..6, 1..3), clipped at right edge
+    test_flush_run(2);
+
+    SIM_CHECK(test_panel.frames == 2);
+    SIM_CHECK(nodi_display_stats_get(&test_disp)->last_flush_bytes ==
+              (16 * 16 + (TEST_W - 64) * (TEST_H - 16)) * 2);
+    for (uint32_t y = 0; y < TEST_H; y++)
+    {
+        for (uint32_t x = 0; x < TEST_W; x++)
+        {
+            bool dirty = ((x < 16) && (y < 16)) || ((x >= 64) && (y >= 16));
+            const uint8_t *p_exp = dirty ? test_fb : panel_before;
+            SIM_CHECK(memcmp(&test_panel.mem[(y * TEST_W + x) * 2], &p_exp[(y * TEST_W + x) * 2], 2) == 0);
+        }
+    }
+}
+
+int main(void)
+{
+    test_full();
+    test_partial();
+    printf("display_flush: %u regions, one CS frame each, %u bytes of other device\n",
+           test_panel.frames, (uint32_t)(TEST_OTHER_DESCS * sizeof(test_other_tx[0])));
+    return 0;
+}
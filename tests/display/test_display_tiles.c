@@ -0,0 +1,202 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/* Dirty tiles bitmap of display pipeline. The unit has no hardware access and is tested
+ * alone. */
+
+#include <stdio.h>
+#include <string.h>
+#include "nodi_display_tiles.h"
+#include "sim.h"
+
+#define TEST_RANDOM_RUNS      2000
+
+static uint32_t test_tiles[NODI_DISPLAY_TILE_ROWS_MAX];
+
+static void test_mark(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
+{
+    nodi_display_rect_s rect = { .x0 = x0, .y0 = y0, .x1 = x1, .y1 = y1 };
+    nodi_display_tiles_mark(test_tiles, &rect);
+}
+
+static void test_take_check(uint32_t cols, uint32_t rows,
+                            uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
+{
+    nodi_display_rect_s rect;
+
+    SIM_CHECK(nodi_display_region_take(test_tiles, cols, rows, &rect));
+    SIM_CHECK((rect.x0 == x0) && (rect.y0 == y0) && (rect.x1 == x1) && (rect.y1 == y1));
+}
+
+static void test_clean_check(uint32_t cols, uint32_t rows)
+{
+    nodi_display_rect_s rect;
+
+    SIM_CHECK(!nodi_display_region_take(test_tiles, cols, rows, &rect));
+    for (uint32_t y = 0; y < NODI_DISPLAY_TILE_ROWS_MAX; y++)
+    {
+        SIM_CHECK(test_tiles[y] == 0);
+    }
+}
+
+static void test_bits(void)
+{
+    SIM_CHECK(NODI_DISPLAY_BITS(0, 0) == 0x00000001UL);
+    SIM_CHECK(NODI_DISPLAY_BITS(3, 5) == 0x00000038UL);
+    SIM_CHECK(NODI_DISPLAY_BITS(31, 31) == 0x80000000UL);
+    SIM_CHECK(NODI_DISPLAY_BITS(0, 31) == 0xFFFFFFFFUL);
+}
+
+/* Marked rectangle comes back as one region and leaves bitmap clean. */
+static void test_single(void)
+{
+    memset(test_tiles, 0, sizeof(test_tiles));
+    test_mark(2, 3, 5, 7);
+    test_take_check(10, 10, 2, 3, 5, 7);
+    test_clean_check(10, 10);
+
+    /* Full bitmap of 32 columns. */
+    test_mark(0, 0, 31, NODI_DISPLAY_TILE_ROWS_MAX - 1);
+    test_take_check(32, NODI_DISPLAY_TILE_ROWS_MAX, 0, 0, 31, NODI_DISPLAY_TILE_ROWS_MAX - 1);
+    test_clean_check(32, NODI_DISPLAY_TILE_ROWS_MAX);
+}
+
+/* Gaps up to NODI_DISPLAY_MERGE_GAP are sent with the region, longer ones split it. */
+static void test_merge_gap(void)
+{
+    memset(test_tiles, 0, sizeof(test_tiles));
+    test_mark(0, 0, 0, 0);
+    test_mark(1 + NODI_DISPLAY_MERGE_GAP, 0, 1 + NODI_DISPLAY_MERGE_GAP, 0);
+    test_take_check(10, 10, 0, 0, 1 + NODI_DISPLAY_MERGE_GAP, 0);
+    test_clean_check(10, 10);
+
+    test_mark(0, 0, 0, 0);
+    test_mark(2 + NODI_DISPLAY_MERGE_GAP, 0, 2 + NODI_DISPLAY_MERGE_GAP, 0);
+    test_take_check(10, 10, 0, 0, 0, 0);
+    test_take_check(10, 10, 2 + NODI_DISPLAY_MERGE_GAP, 0, 2 + NODI_DISPLAY_MERGE_GAP, 0);
+    test_clean_check(10, 10);
+
+    /* Tiles past the last column do not count. */
+    test_mark(0, 0, 0, 0);
+    test_tiles[0] |= 1UL << 5;
+    test_take_check(5, 10, 0, 0, 0, 0);
+    SIM_CHECK(test_tiles[0] == (1UL << 5));
+}
+
+/* Rows join while their span from the region start column starts there and reaches the
+ * region end. */
+static void test_rows_join(void)
+{
+    memset(test_tiles, 0, sizeof(test_tiles));
+    test_mark(2, 1, 4, 3);
+    test_mark(2, 4, 6, 4);      // Wider row joins, its rest stays dirty.
+    test_mark(2, 5, 3, 5);      // Narrower row ends the region.
+    test_take_check(10, 10, 2, 1, 4, 4);
+    SIM_CHECK(test_tiles[4] == NODI_DISPLAY_BITS(5, 6));
+    test_take_check(10, 10, 5, 4, 6, 4);
+    test_take_check(10, 10, 2, 5, 3, 5);
+    test_clean_check(10, 10);
+
+    /* Row starting right of the region ends it. Tiles left of it do not matter. */
+    test_mark(2, 0, 4, 0);
+    test_mark(3, 1, 4, 1);
+    test_take_check(10, 10, 2, 0, 4, 0);
+    test_take_check(10, 10, 3, 1, 4, 1);
+    test_clean_check(10, 10);
+
+    test_mark(2, 0, 4, 0);
+    test_mark(0, 1, 4, 1);
+    test_take_check(10, 10, 2, 0, 4, 1);
+    SIM_CHECK(test_tiles[1] == NODI_DISPLAY_BITS(0, 1));
+    test_take_check(10, 10, 0, 1, 1, 1);
+    test_clean_check(10, 10);
+}
+
+/* Random rectangles: every region takes dirty tiles off the bitmap and all dirty tiles
+ * are sent. */
+static void test_random(void)
+{
+    static uint32_t dirty[NODI_DISPLAY_TILE_ROWS_MAX];
+    static uint32_t left[NODI_DISPLAY_TILE_ROWS_MAX];
+    static uint32_t sent[NODI_DISPLAY_TILE_ROWS_MAX];
+    uint32_t regions = 0;
+
+    sim_seed(0xD15B);
+    for (uint32_t run = 0; run < TEST_RANDOM_RUNS; run++)
+    {
+        uint32_t cols = 1 + sim_rand() % 32;
+        uint32_t rows = 1 + sim_rand() % NODI_DISPLAY_TILE_ROWS_MAX;
+        uint32_t rects = 1 + sim_rand() % 6;
+        nodi_display_rect_s rect;
+        uint32_t n = 0;
+
+        memset(test_tiles, 0, sizeof(test_tiles));
+        memset(sent, 0, sizeof(sent));
+        for (uint32_t i = 0; i < rects; i++)
+        {
+            uint16_t x0 = sim_rand() % cols;
+            uint16_t y0 = sim_rand() % rows;
+            test_mark(x0, y0, x0 + sim_rand() % (cols - x0), y0 + sim_rand() % (rows - y0));
+        }
+        memcpy(dirty, test_tiles, sizeof(dirty));
+        memcpy(left, test_tiles, sizeof(left));
+
+        while (nodi_display_region_take(test_tiles, cols, rows, &rect))
+        {
+            uint32_t mask = NODI_DISPLAY_BITS(rect.x0, rect.x1);
+            SIM_CHECK(++n <= cols * rows);
+            SIM_CHECK((rect.x0 <= rect.x1) && (rect.x1 < cols));
+            SIM_CHECK((rect.y0 <= rect.y1) && (rect.y1 < rows));
+            /* Region starts and ends on dirty tiles of its first row. */
+            SIM_CHECK(left[rect.y0] & (1UL << rect.x0));
+            SIM_CHECK(left[rect.y0] & (1UL << rect.x1));
+            for (uint32_t y = 0; y < rows; y++)
+            {
+                if ((y >= rect.y0) && (y <= rect.y1))
+                {
+                    left[y] &= ~mask;
+                    sent[y] |= mask;
+                }
+                SIM_CHECK(test_tiles[y] == left[y]);
+            }
+        }
+        for (uint32_t y = 0; y < rows; y++)
+        {
+            SIM_CHECK((dirty[y] & ~sent[y]) == 0);
+            SIM_CHECK(test_tiles[y] == 0);
+        }
+        regions += n;
+    }
+    printf("display_tiles: %u random bitmaps, %u regions\n", TEST_RANDOM_RUNS, regions);
+}
+
+int main(void)
+{
+    test_bits();
+    test_single();
+    test_merge_gap();
+    test_rows_join();
+    test_random();
+    return 0;
+}
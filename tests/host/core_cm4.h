@@ -0,0 +1,81 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CORE_CM4_H
+#define CORE_CM4_H
+
+/* Host replacement of CMSIS Cortex-M4 core header. NVIC and PRIMASK are handed to the
+ * simulator, which calls interrupt routines between simulated events. */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define __I     volatile const
+#define __O     volatile
+#define __IO    volatile
+#define __IM    volatile const
+#define __OM    volatile
+#define __IOM   volatile
+
+#define __STATIC_INLINE static inline
+#define __INLINE        inline
+
+extern volatile uint32_t sim_primask;
+
+void sim_nvic_enable(int irq, bool enable);
+void sim_bkpt(void);
+
+static inline void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority) { (void)IRQn; (void)priority; }
+static inline void NVIC_ClearPendingIRQ(IRQn_Type IRQn) { (void)IRQn; }
+static inline void NVIC_SetPendingIRQ(IRQn_Type IRQn) { (void)IRQn; }
+static inline void NVIC_EnableIRQ(IRQn_Type IRQn) { sim_nvic_enable((int)IRQn, true); }
+static inline void NVIC_DisableIRQ(IRQn_Type IRQn) { sim_nvic_enable((int)IRQn, false); }
+
+static inline uint32_t __get_PRIMASK(void) { return sim_primask; }
+static inline void __set_PRIMASK(uint32_t priMask) { sim_primask = priMask; }
+static inline void __disable_irq(void) { sim_primask = 1; }
+static inline void __enable_irq(void) { sim_primask = 0; }
+
+static inline void __DSB(void) {}
+static inline void __DMB(void) {}
+static inline void __ISB(void) {}
+static inline void __NOP(void) {}
+static inline void __WFE(void) {}
+static inline void __WFI(void) {}
+static inline void __SEV(void) {}
+
+/* Failed NODI_DRV_CHECK ends the test with a backtrace. */
+#define __BKPT(...) sim_bkpt()
+
+typedef struct {
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk (1UL)
+
+extern DWT_Type sim_dwt;
+#define DWT (&sim_dwt)
+
+#endif // CORE_CM4_H
@@ -0,0 +1,606 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _GNU_SOURCE
+#include <execinfo.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include "nodi_common.h"
+#include "sim.h"
+#include "sim_gpio.h"
+
+#define SIM_APB_BASE          0x40000000UL
+#define SIM_APB_PAGES         64
+#define SIM_AHB_BASE          0x50000000UL
+#define SIM_PAGE              0x1000UL
+#define SIM_NONE              UINT64_MAX
+
+#define SIM_OFF_INTENSET      0x304
+#define SIM_OFF_INTENCLR      0x308
+#define SIM_OFF_EVENTS        0x100
+
+#define SIM_EFLAGS_TF         0x100
+#define SIM_ISR_STORM_MAX     100000
+
+typedef struct {
+    const sim_periph_ops_s   *p_ops;
+    void                     *p_ctx;
+} sim_periph_s;
+
+typedef struct {
+    uint64_t                  t;
+    uint64_t                  seq;
+    sim_fn_t                  fn;
+    void                     *p_ctx;
+    uint32_t                  arg;
+} sim_evt_s;
+
+typedef struct {
+    nodi_nmd_irq_routine_t    routine;
+    void                     *p_ctx;
+    bool                      enabled;
+    uint64_t                  due;
+} sim_irq_s;
+
+volatile uint32_t sim_primask;
+uint32_t sim_irq_latency_max_ns;
+DWT_Type sim_dwt;
+
+static bool sim_mapped;
+static int sim_unlocked;
+static sim_periph_s sim_apb[SIM_APB_PAGES];
+static sim_periph_s sim_ahb;
+static sim_irq_s sim_irqs[SIM_APB_PAGES];
+static bool sim_isr_active;
+static uint32_t sim_isr_storm;
+static uint64_t sim_time;
+static uint64_t sim_seq;
+static sim_evt_s *sim_heap;
+static uint32_t sim_heap_n;
+static uint32_t sim_heap_cap;
+static uint32_t sim_rand_state = 1;
+
+/* Write in progress, between page fault and single step trap. */
+static uintptr_t sim_trap_addr;
+static uint32_t sim_trap_old;
+
+/*===========================================================================*/
+/* Register space.                                                           */
+/*===========================================================================*/
+
+static bool sim_addr_apb(uintptr_t addr)
+{
+    return (addr >= SIM_APB_BASE) && (addr < SIM_APB_BASE + SIM_APB_PAGES * SIM_PAGE);
+}
+
+static bool sim_addr_ahb(uintptr_t addr)
+{
+    return (addr >= SIM_AHB_BASE) && (addr < SIM_AHB_BASE + SIM_PAGE);
+}
+
+static sim_periph_s *sim_periph_get(uintptr_t addr)
+{
+    if (sim_addr_apb(addr))
+    {
+        return &sim_apb[(addr - SIM_APB_BASE) / SIM_PAGE];
+    }
+    if (sim_addr_ahb(addr))
+    {
+        return &sim_ahb;
+    }
+    return NULL;
+}
+
+static void sim_protect(int prot)
+{
+    mprotect((void *)SIM_APB_BASE, SIM_APB_PAGES * SIM_PAGE, prot);
+    mprotect((void *)SIM_AHB_BASE, SIM_PAGE, prot);
+}
+
+static void sim_unlock(void)
+{
+    if (sim_unlocked++ == 0)
+    {
+        sim_protect(PROT_READ | PROT_WRITE);
+    }
+}
+
+static void sim_lock(void)
+{
+    if (--sim_unlocked == 0)
+    {
+        sim_protect(PROT_READ);
+    }
+}
+
+void sim_reg_write(const volatile uint32_t *p_reg, uint32_t val)
+{
+    sim_unlock();
+    *(volatile uint32_t *)p_reg = val;
+    sim_lock();
+}
+
+/* Applies driver write like hardware does. Old value is the one before the write. */
+static void sim_write_apply(uintptr_t addr, uint32_t old, uint32_t val)
+{
+    sim_periph_s *p_periph = sim_periph_get(addr);
+    uint32_t off = addr & (SIM_PAGE - 1);
+    volatile uint32_t *p_page = (volatile uint32_t *)(addr & ~(SIM_PAGE - 1));
+
+    if (sim_addr_apb(addr) && ((off == SIM_OFF_INTENSET) || (off == SIM_OFF_INTENCLR)))
+    {
+        /* Both registers read back enabled interrupts. */
+        uint32_t inten = (off == SIM_OFF_INTENSET) ? (old | val) : (old & ~val);
+        p_page[SIM_OFF_INTENSET / 4] = inten;
+        p_page[SIM_OFF_INTENCLR / 4] = inten;
+        return;
+    }
+
+    if (sim_addr_apb(addr) && (off < SIM_OFF_EVENTS))
+    {
+        /* Tasks are write only, writing 0 has no effect. */
+        p_page[off / 4] = 0;
+        if ((val != 0) && (p_periph->p_ops != NULL) && (p_periph->p_ops->task != NULL))
+        {
+            p_periph->p_ops->task(p_periph->p_ctx, off);
+        }
+        return;
+    }
+
+    if ((p_periph->p_ops != NULL) && (p_periph->p_ops->write != NULL))
+    {
+        p_periph->p_ops->write(p_periph->p_ctx, off, old, val);
+    }
+}
+
+static void sim_segv_handler(int sig, siginfo_t *p_info, void *p_uctx)
+{
+    ucontext_t *p_uc = (ucontext_t *)p_uctx;
+    uintptr_t addr = (uintptr_t)p_info->si_addr & ~(uintptr_t)3;
+
+    if (sim_periph_get(addr) == NULL)
+    {
+        /* Real crash, let it happen with default action. */
+        signal(SIGSEGV, SIG_DFL);
+        return;
+    }
+
+    /* Let the instruction write and stop right after it. */
+    sim_trap_addr = addr;
+    sim_trap_old = *(volatile uint32_t *)addr;
+    mprotect((void *)(addr & ~(SIM_PAGE - 1)), SIM_PAGE, PROT_READ | PROT_WRITE);
+    p_uc->uc_mcontext.gregs[REG_EFL] |= SIM_EFLAGS_TF;
+}
+
+static void sim_trap_handler(int sig, siginfo_t *p_info, void *p_uctx)
+{
+    ucontext_t *p_uc = (ucontext_t *)p_uctx;
+    uintptr_t addr = sim_trap_addr;
+
+    p_uc->uc_mcontext.gregs[REG_EFL] &= ~SIM_EFLAGS_TF;
+    if (addr == 0)
+    {
+        return;
+    }
+    sim_trap_addr = 0;
+
+    sim_unlock();
+    sim_write_apply(addr, sim_trap_old, *(volatile uint32_t *)addr);
+    sim_lock();
+}
+
+/*===========================================================================*/
+/* PPI.                                                                      */
+/*===========================================================================*/
+
+static void sim_ppi_task(void *p_ctx, uint32_t off)
+{
+    uint32_t group = off / sizeof(NRF_PPI->TASKS_CHG[0]);
+    uint32_t chen = NRF_PPI->CHEN;
+
+    if ((off % sizeof(NRF_PPI->TASKS_CHG[0])) == 0)
+    {
+        chen |= NRF_PPI->CHG[group];
+    }
+    else
+    {
+        chen &= ~NRF_PPI->CHG[group];
+    }
+    sim_reg_write(&NRF_PPI->CHEN, chen);
+    sim_reg_write(&NRF_PPI->CHENSET, chen);
+    sim_reg_write(&NRF_PPI->CHENCLR, chen);
+}
+
+static void sim_ppi_write(void *p_ctx, uint32_t off, uint32_t old, uint32_t val)
+{
+    uint32_t chen = NRF_PPI->CHEN;
+
+    if (off == offsetof(NRF_PPI_Type, CHENSET))
+    {
+        chen |= val;
+    }
+    else if (off == offsetof(NRF_PPI_Type, CHENCLR))
+    {
+        chen &= ~val;
+    }
+    else if (off != offsetof(NRF_PPI_Type, CHEN))
+    {
+        return;
+    }
+    sim_reg_write(&NRF_PPI->CHEN, chen);
+    sim_reg_write(&NRF_PPI->CHENSET, chen);
+    sim_reg_write(&NRF_PPI->CHENCLR, chen);
+}
+
+static const sim_periph_ops_s sim_ppi_ops = {
+    .task  = sim_ppi_task,
+    .write = sim_ppi_write,
+};
+
+void sim_task_trigger(uint32_t addr)
+{
+    sim_periph_s *p_periph = sim_periph_get(addr);
+    uint32_t off = addr & (SIM_PAGE - 1);
+
+    if ((p_periph == NULL) || !sim_addr_apb(addr) || (off >= SIM_OFF_EVENTS))
+    {
+        return;
+    }
+    if ((p_periph->p_ops != NULL) && (p_periph->p_ops->task != NULL))
+    {
+        p_periph->p_ops->task(p_periph->p_ctx, off);
+    }
+}
+
+void sim_evt_raise(volatile uint32_t *p_evt)
+{
+    uint32_t addr = (uint32_t)(uintptr_t)p_evt;
+    uint32_t chen = NRF_PPI->CHEN;
+
+    sim_reg_write(p_evt, 1);
+
+    /* Group tasks triggered by this event change CHEN of following channels only on
+     * the next event, like simultaneous PPI channels do. */
+    for (uint32_t ch = 0; ch < sizeof(NRF_PPI->CH) / sizeof(NRF_PPI->CH[0]); ch++)
+    {
+        if (!(chen & (1UL << ch)) || (NRF_PPI->CH[ch].EEP != addr))
+        {
+            continue;
+        }
+        sim_task_trigger(NRF_PPI->CH[ch].TEP);
+        if (NRF_PPI->FORK[ch].TEP != 0)
+        {
+            sim_task_trigger(NRF_PPI->FORK[ch].TEP);
+        }
+    }
+}
+
+/*===========================================================================*/
+/* Time line and interrupts.                                                 */
+/*===========================================================================*/
+
+static bool sim_evt_before(const sim_evt_s *p_a, const sim_evt_s *p_b)
+{
+    return (p_a->t < p_b->t) || ((p_a->t == p_b->t) && (p_a->seq < p_b->seq));
+}
+
+void sim_at(uint64_t t, sim_fn_t fn, void *p_ctx, uint32_t arg)
+{
+    uint32_t i;
+
+    SIM_CHECK(t >= sim_time);
+    if (sim_heap_n == sim_heap_cap)
+    {
+        sim_heap_cap = sim_heap_cap ? 2 * sim_heap_cap : 64;
+        sim_heap = realloc(sim_heap, sim_heap_cap * sizeof(sim_evt_s));
+        SIM_CHECK(sim_heap != NULL);
+    }
+
+    i = sim_heap_n++;
+    sim_heap[i] = (sim_evt_s){ .t = t, .seq = sim_seq++, .fn = fn, .p_ctx = p_ctx, .arg = arg };
+    while (i > 0)
+    {
+        uint32_t parent = (i - 1) / 2;
+        sim_evt_s tmp;
+        if (!sim_evt_before(&sim_heap[i], &sim_heap[parent]))
+        {
+            break;
+        }
+        tmp = sim_heap[i];
+        sim_heap[i] = sim_heap[parent];
+        sim_heap[parent] = tmp;
+        i = parent;
+    }
+}
+
+static sim_evt_s sim_evt_pop(void)
+{
+    sim_evt_s top = sim_heap[0];
+    uint32_t i = 0;
+
+    sim_heap[0] = sim_heap[--sim_heap_n];
+    for (;;)
+    {
+        uint32_t l = 2 * i + 1;
+        uint32_t r = l + 1;
+        uint32_t min = i;
+        sim_evt_s tmp;
+        if ((l < sim_heap_n) && sim_evt_before(&sim_heap[l], &sim_heap[min]))
+        {
+            min = l;
+        }
+        if ((r < sim_heap_n) && sim_evt_before(&sim_heap[r], &sim_heap[min]))
+        {
+            min = r;
+        }
+        if (min == i)
+        {
+            break;
+        }
+        tmp = sim_heap[i];
+        sim_heap[i] = sim_heap[min];
+        sim_heap[min] = tmp;
+        i = min;
+    }
+    return top;
+}
+
+uint64_t sim_now(void)
+{
+    return sim_time;
+}
+
+bool sim_in_isr(void)
+{
+    return sim_isr_active;
+}
+
+static void sim_time_set(uint64_t t)
+{
+    sim_time = t;
+    sim_dwt.CYCCNT = (uint32_t)(t * 64 / 1000);
+    for (uint32_t i = 0; i < SIM_APB_PAGES; i++)
+    {
+        if ((sim_apb[i].p_ops != NULL) && (sim_apb[i].p_ops->tick != NULL))
+        {
+            sim_apb[i].p_ops->tick(sim_apb[i].p_ctx);
+        }
+    }
+}
+
+/* Interrupt lines are numbered like peripheral pages. Event n has INTEN bit n. */
+static bool sim_irq_pending(uint32_t irq)
+{
+    volatile uint32_t *p_page = (volatile uint32_t *)(SIM_APB_BASE + irq * SIM_PAGE);
+    uint32_t inten = p_page[SIM_OFF_INTENSET / 4];
+
+    while (inten != 0)
+    {
+        uint32_t n = __builtin_ctz(inten);
+        if (p_page[SIM_OFF_EVENTS / 4 + n] != 0)
+        {
+            return true;
+        }
+        inten &= inten - 1;
+    }
+    return false;
+}
+
+static uint64_t sim_irq_next(uint32_t *p_irq)
+{
+    uint64_t t_next = SIM_NONE;
+
+    for (uint32_t irq = 0; irq < SIM_APB_PAGES; irq++)
+    {
+        sim_irq_s *p = &sim_irqs[irq];
+        if ((p->routine == NULL) || !p->enabled || !sim_irq_pending(irq))
+        {
+            p->due = SIM_NONE;
+            continue;
+        }
+        if (p->due == SIM_NONE)
+        {
+            p->due = sim_time + (sim_irq_latency_max_ns ? sim_rand() % sim_irq_latency_max_ns : 0);
+        }
+        if (p->due < t_next)
+        {
+            t_next = p->due;
+            *p_irq = irq;
+        }
+    }
+    return t_next;
+}
+
+bool sim_step(uint64_t t_limit)
+{
+    uint32_t irq = 0;
+    uint64_t t_irq = (sim_primask == 0) ? sim_irq_next(&irq) : SIM_NONE;
+    uint64_t t_evt = sim_heap_n ? sim_heap[0].t : SIM_NONE;
+
+    if ((t_irq == SIM_NONE) && (t_evt == SIM_NONE))
+    {
+        return false;
+    }
+    if ((t_irq > t_limit) && (t_evt > t_limit))
+    {
+        return false;
+    }
+
+    if (t_irq <= t_evt)
+    {
+        SIM_CHECK(++sim_isr_storm < SIM_ISR_STORM_MAX);
+        sim_time_set(t_irq);
+        sim_irqs[irq].due = SIM_NONE;
+        sim_isr_active = true;
+        sim_irqs[irq].routine(sim_irqs[irq].p_ctx);
+        sim_isr_active = false;
+    }
+    else
+    {
+        sim_evt_s evt = sim_evt_pop();
+        sim_isr_storm = 0;
+        sim_time_set(evt.t);
+        evt.fn(evt.p_ctx, evt.arg);
+    }
+    return true;
+}
+
+void sim_run(uint64_t t_limit)
+{
+    while (sim_step(t_limit))
+    {
+    }
+    if (t_limit != SIM_FOREVER)
+    {
+        sim_time_set(t_limit);
+    }
+}
+
+void sim_nvic_enable(int irq, bool enable)
+{
+    SIM_CHECK((irq >= 0) && (irq < SIM_APB_PAGES));
+    sim_irqs[irq].enabled = enable;
+}
+
+/*===========================================================================*/
+/* Micro NVIC dispatcher.                                                    */
+/*===========================================================================*/
+
+void nodi_mnd_init(void)
+{
+}
+
+void nodi_mnd_register(nodi_nmd_irq_routine_t p_func, void * p_ctx, nodi_nmd_irq_t irq_num)
+{
+    SIM_CHECK(((int)irq_num >= 0) && ((int)irq_num < SIM_APB_PAGES));
+    sim_irqs[irq_num].routine = p_func;
+    sim_irqs[irq_num].p_ctx = p_ctx;
+}
+
+void nodi_mnd_unregister(nodi_nmd_irq_t irq_num)
+{
+    SIM_CHECK(((int)irq_num >= 0) && ((int)irq_num < SIM_APB_PAGES));
+    sim_irqs[irq_num].routine = NULL;
+}
+
+/*===========================================================================*/
+/* Setup and helpers.                                                        */
+/*===========================================================================*/
+
+void sim_periph_add(uint32_t base, const sim_periph_ops_s *p_ops, void *p_ctx)
+{
+    sim_periph_s *p_periph = sim_periph_get(base);
+
+    SIM_CHECK(p_periph != NULL);
+    p_periph->p_ops = p_ops;
+    p_periph->p_ctx = p_ctx;
+}
+
+void sim_init(void)
+{
+    static uint8_t dma_probe;
+
+    /* EasyDMA addresses are 32-bit, static data has to be below 4 GB. */
+    SIM_CHECK((uintptr_t)&dma_probe < (1ULL << 32));
+
+    if (!sim_mapped)
+    {
+        struct sigaction sa;
+        void *p_apb = mmap((void *)SIM_APB_BASE, SIM_APB_PAGES * SIM_PAGE, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+        void *p_ahb = mmap((void *)SIM_AHB_BASE, SIM_PAGE, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+        SIM_CHECK(p_apb == (void *)SIM_APB_BASE);
+        SIM_CHECK(p_ahb == (void *)SIM_AHB_BASE);
+
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_flags = SA_SIGINFO;
+        sa.sa_sigaction = sim_segv_handler;
+        sigaction(SIGSEGV, &sa, NULL);
+        sa.sa_sigaction = sim_trap_handler;
+        sigaction(SIGTRAP, &sa, NULL);
+        sim_mapped = true;
+    }
+    else
+    {
+        sim_protect(PROT_READ | PROT_WRITE);
+    }
+
+    memset((void *)SIM_APB_BASE, 0, SIM_APB_PAGES * SIM_PAGE);
+    memset((void *)SIM_AHB_BASE, 0, SIM_PAGE);
+    memset(sim_apb, 0, sizeof(sim_apb));
+    memset(&sim_ahb, 0, sizeof(sim_ahb));
+    memset(sim_irqs, 0, sizeof(sim_irqs));
+    memset(&sim_dwt, 0, sizeof(sim_dwt));
+    sim_unlocked = 0;
+    sim_protect(PROT_READ);
+
+    sim_primask = 0;
+    sim_irq_latency_max_ns = 0;
+    sim_isr_active = false;
+    sim_isr_storm = 0;
+    sim_time = 0;
+    sim_seq = 0;
+    sim_heap_n = 0;
+    sim_seed(1);
+
+    sim_periph_add(NRF_PPI_BASE, &sim_ppi_ops, NULL);
+    sim_gpio_init();
+}
+
+void sim_seed(uint32_t seed)
+{
+    sim_rand_state = seed ? seed : 1;
+}
+
+uint32_t sim_rand(void)
+{
+    /* xorshift32, the same sequence on every host. */
+    sim_rand_state ^= sim_rand_state << 13;
+    sim_rand_state ^= sim_rand_state >> 17;
+    sim_rand_state ^= sim_rand_state << 5;
+    return sim_rand_state;
+}
+
+void sim_fail(const char *p_file, int line, const char *p_text)
+{
+    fprintf(stderr, "%s:%d: check failed at %llu ns: %s\n", p_file, line,
+            (unsigned long long)sim_time, p_text);
+    exit(1);
+}
+
+void sim_bkpt(void)
+{
+    void *bt[32];
+    int n = backtrace(bt, 32);
+
+    fprintf(stderr, "driver check failed at %llu ns:\n", (unsigned long long)sim_time);
+    backtrace_symbols_fd(bt, n, STDERR_FILENO);
+    exit(2);
+}
@@ -0,0 +1,105 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIM_H
+#define SIM_H
+
+/* Host simulation of nRF52840 used by driver tests.
+ *
+ * Peripheral register blocks are mapped at their real addresses and kept read only.
+ * Every register write of a driver traps, the written value is applied by the model of
+ * the peripheral and the page is protected again, so models see writes in program order
+ * like hardware does. INTENSET/INTENCLR and TASKS_* semantics are common to all
+ * peripherals and handled here. Models raise events, schedule their own work on the
+ * simulated time line and PPI forwards raised events to tasks.
+ *
+ * Interrupt routines registered through nodi_mnd_register are called between simulated
+ * events, when their peripheral has an enabled event pending, NVIC line is enabled and
+ * PRIMASK is clear. Tests need to be linked with -no-pie, because drivers pass buffer
+ * addresses to EasyDMA as 32-bit values, so DMA buffers have to be static. */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define SIM_US(us)            ((uint64_t)(us) * 1000ULL)
+#define SIM_MS(ms)            ((uint64_t)(ms) * 1000000ULL)
+#define SIM_FOREVER           UINT64_MAX
+
+/* Converts 32-bit EasyDMA address written by driver to host pointer. */
+#define SIM_PTR(addr)         ((uint8_t *)(uintptr_t)(addr))
+
+#define SIM_CHECK(cond) do {                                 \
+        if (!(cond))                                         \
+        {                                                    \
+            sim_fail(__FILE__, __LINE__, #cond);             \
+        }                                                    \
+    } while (0)
+
+/* Callback of event scheduled on the simulated time line. */
+typedef void (*sim_fn_t)(void *p_ctx, uint32_t arg);
+
+/* Peripheral model bound to 4 kB register page. Offsets are relative to the page. */
+typedef struct {
+    void (*task)(void *p_ctx, uint32_t off);                               // TASKS_* triggered
+    void (*write)(void *p_ctx, uint32_t off, uint32_t old, uint32_t val);  // Other register written
+    void (*tick)(void *p_ctx);                                             // Time advanced
+} sim_periph_ops_s;
+
+extern volatile uint32_t sim_primask;
+extern uint32_t sim_irq_latency_max_ns; // Interrupt routine is called 0..max ns after event.
+
+/* Maps register space and resets time line, interrupts and built-in GPIO, GPIOTE and PPI
+ * models. Can be called again to start another scenario from scratch. */
+void sim_init(void);
+
+void sim_periph_add(uint32_t base, const sim_periph_ops_s *p_ops, void *p_ctx);
+
+uint64_t sim_now(void);
+
+void sim_at(uint64_t t, sim_fn_t fn, void *p_ctx, uint32_t arg);
+
+/* Executes the nearest event or interrupt routine if it is due before t_limit. */
+bool sim_step(uint64_t t_limit);
+
+/* Executes everything due before t_limit. Time stops at t_limit, or at the last event
+ * if there is no limit. */
+void sim_run(uint64_t t_limit);
+
+bool sim_in_isr(void);
+
+/* Register writes and events generated by hardware, not trapped as driver writes. */
+void sim_reg_write(const volatile uint32_t *p_reg, uint32_t val);
+
+void sim_evt_raise(volatile uint32_t *p_evt);
+
+void sim_task_trigger(uint32_t addr);
+
+void sim_seed(uint32_t seed);
+
+uint32_t sim_rand(void);
+
+void sim_fail(const char *p_file, int line, const char *p_text);
+
+#endif // SIM_H
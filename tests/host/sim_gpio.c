@@ -0,0 +1,339 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include "nodi_common.h"
+#include "sim.h"
+#include "sim_gpio.h"
+
+#define SIM_GPIO_PORTS        2
+#define SIM_GPIO_LISTENERS    32
+#define SIM_GPIOTE_CH_COUNT   (sizeof(NRF_GPIOTE->CONFIG) / sizeof(NRF_GPIOTE->CONFIG[0]))
+
+typedef struct {
+    sim_gpio_listener_t       fn;
+    void                     *p_ctx;
+    uint32_t                  psel;
+} sim_gpio_listener_s;
+
+typedef struct {
+    uint32_t                  ext_mask[SIM_GPIO_PORTS];
+    uint32_t                  ext_val[SIM_GPIO_PORTS];
+    uint32_t                  te_mask[SIM_GPIO_PORTS];
+    uint32_t                  te_val[SIM_GPIO_PORTS];
+    uint32_t                  level[SIM_GPIO_PORTS];
+    bool                      detect;
+    sim_gpio_listener_s       listeners[SIM_GPIO_LISTENERS];
+    uint32_t                  listener_count;
+} sim_gpio_s;
+
+static sim_gpio_s sim_gpio;
+
+static NRF_GPIO_Type *sim_gpio_port_get(uint32_t port)
+{
+    return port == 0 ? NRF_P0 : NRF_P1;
+}
+
+static uint32_t sim_gpio_level_calc(uint32_t port)
+{
+    NRF_GPIO_Type *p_reg = sim_gpio_port_get(port);
+    uint32_t level = 0;
+
+    for (uint32_t pin = 0; pin < 32; pin++)
+    {
+        uint32_t msk = 1UL << pin;
+        bool high;
+        if (sim_gpio.te_mask[port] & msk)
+        {
+            high = sim_gpio.te_val[port] & msk;
+        }
+        else if (sim_gpio.ext_mask[port] & msk)
+        {
+            high = sim_gpio.ext_val[port] & msk;
+        }
+        else if (p_reg->PIN_CNF[pin] & GPIO_PIN_CNF_DIR_Msk)
+        {
+            high = p_reg->OUT & msk;
+        }
+        else
+        {
+            high = true;
+        }
+        level |= high ? msk : 0;
+    }
+    return level;
+}
+
+static void sim_gpiote_pin_event(uint32_t psel, bool level)
+{
+    for (uint32_t ch = 0; ch < SIM_GPIOTE_CH_COUNT; ch++)
+    {
+        uint32_t config = NRF_GPIOTE->CONFIG[ch];
+        uint32_t polarity = (config & GPIOTE_CONFIG_POLARITY_Msk) >> GPIOTE_CONFIG_POLARITY_Pos;
+        uint32_t ch_psel = (config & (GPIOTE_CONFIG_PSEL_Msk | GPIOTE_CONFIG_PORT_Msk)) >>
+                           GPIOTE_CONFIG_PSEL_Pos;
+
+        if (((config & GPIOTE_CONFIG_MODE_Msk) >> GPIOTE_CONFIG_MODE_Pos != GPIOTE_CONFIG_MODE_Event) ||
+            (ch_psel != psel))
+        {
+            continue;
+        }
+        if ((polarity == GPIOTE_CONFIG_POLARITY_Toggle) ||
+            ((polarity == GPIOTE_CONFIG_POLARITY_LoToHi) && level) ||
+            ((polarity == GPIOTE_CONFIG_POLARITY_HiToLo) && !level))
+        {
+            sim_evt_raise(&NRF_GPIOTE->EVENTS_IN[ch]);
+        }
+    }
+}
+
+/* DETECT is shared by all pins with SENSE enabled, PORT event is its rising edge. */
+static void sim_gpio_detect_update(void)
+{
+    bool detect = false;
+
+    for (uint32_t port = 0; port < SIM_GPIO_PORTS; port++)
+    {
+        NRF_GPIO_Type *p_reg = sim_gpio_port_get(port);
+        for (uint32_t pin = 0; pin < 32; pin++)
+        {
+            uint32_t sense = (p_reg->PIN_CNF[pin] & GPIO_PIN_CNF_SENSE_Msk) >> GPIO_PIN_CNF_SENSE_Pos;
+            bool high = sim_gpio.level[port] & (1UL << pin);
+            if (((sense == GPIO_PIN_CNF_SENSE_High) && high) ||
+                ((sense == GPIO_PIN_CNF_SENSE_Low) && !high))
+            {
+                detect = true;
+            }
+        }
+    }
+
+    if (detect && !sim_gpio.detect)
+    {
+        sim_evt_raise(&NRF_GPIOTE->EVENTS_PORT);
+    }
+    sim_gpio.detect = detect;
+}
+
+static void sim_gpio_update(void)
+{
+    for (uint32_t port = 0; port < SIM_GPIO_PORTS; port++)
+    {
+        uint32_t level = sim_gpio_level_calc(port);
+        uint32_t changed = level ^ sim_gpio.level[port];
+
+        sim_gpio.level[port] = level;
+        sim_reg_write(&sim_gpio_port_get(port)->IN, level);
+
+        while (changed != 0)
+        {
+            uint32_t pin = __builtin_ctz(changed);
+            uint32_t psel = pin | (port << 5);
+            bool high = level & (1UL << pin);
+
+            changed &= changed - 1;
+            for (uint32_t i = 0; i < sim_gpio.listener_count; i++)
+            {
+                if (sim_gpio.listeners[i].psel == psel)
+                {
+                    sim_gpio.listeners[i].fn(sim_gpio.listeners[i].p_ctx, psel, high);
+                }
+            }
+            sim_gpiote_pin_event(psel, high);
+        }
+    }
+    sim_gpio_detect_update();
+}
+
+static void sim_gpio_write(void *p_ctx, uint32_t off, uint32_t old, uint32_t val)
+{
+    uint32_t port = off >= NRF_P1_BASE - NRF_P0_BASE + offsetof(NRF_GPIO_Type, OUT) ? 1 : 0;
+    NRF_GPIO_Type *p_reg = sim_gpio_port_get(port);
+    uint32_t reg = off - (port ? NRF_P1_BASE - NRF_P0_BASE : 0);
+    uint32_t out = p_reg->OUT;
+    uint32_t dir = p_reg->DIR;
+
+    switch (reg)
+    {
+    case offsetof(NRF_GPIO_Type, OUTSET):
+        out = old | val;
+        break;
+    case offsetof(NRF_GPIO_Type, OUTCLR):
+        out = old & ~val;
+        break;
+    case offsetof(NRF_GPIO_Type, DIRSET):
+        dir = old | val;
+        break;
+    case offsetof(NRF_GPIO_Type, DIRCLR):
+        dir = old & ~val;
+        break;
+    default:
+        if (reg >= offsetof(NRF_GPIO_Type, PIN_CNF))
+        {
+            /* DIR register mirrors DIR fields of PIN_CNF. */
+            uint32_t msk = 1UL << ((reg - offsetof(NRF_GPIO_Type, PIN_CNF)) / 4);
+            dir = (val & GPIO_PIN_CNF_DIR_Msk) ? (dir | msk) : (dir & ~msk);
+        }
+        break;
+    }
+
+    for (uint32_t pin = 0; pin < 32; pin++)
+    {
+        uint32_t cnf = p_reg->PIN_CNF[pin] & ~GPIO_PIN_CNF_DIR_Msk;
+        sim_reg_write(&p_reg->PIN_CNF[pin], cnf | ((dir >> pin) & 1UL));
+    }
+    sim_reg_write(&p_reg->OUT, out);
+    sim_reg_write(&p_reg->OUTSET, out);
+    sim_reg_write(&p_reg->OUTCLR, out);
+    sim_reg_write(&p_reg->DIR, dir);
+    sim_reg_write(&p_reg->DIRSET, dir);
+    sim_reg_write(&p_reg->DIRCLR, dir);
+    sim_gpio_update();
+}
+
+static const sim_periph_ops_s sim_gpio_ops = {
+    .write = sim_gpio_write,
+};
+
+static uint32_t sim_gpiote_psel_get(uint32_t ch)
+{
+    return (NRF_GPIOTE->CONFIG[ch] & (GPIOTE_CONFIG_PSEL_Msk | GPIOTE_CONFIG_PORT_Msk)) >>
+           GPIOTE_CONFIG_PSEL_Pos;
+}
+
+static void sim_gpiote_task(void *p_ctx, uint32_t off)
+{
+    uint32_t ch = (off % offsetof(NRF_GPIOTE_Type, TASKS_SET)) / 4;
+    uint32_t psel = sim_gpiote_psel_get(ch);
+    uint32_t port = psel >> 5;
+    uint32_t msk = 1UL << (psel & 31);
+    uint32_t polarity = (NRF_GPIOTE->CONFIG[ch] & GPIOTE_CONFIG_POLARITY_Msk) >>
+                        GPIOTE_CONFIG_POLARITY_Pos;
+    bool high = sim_gpio.te_val[port] & msk;
+
+    if ((NRF_GPIOTE->CONFIG[ch] & GPIOTE_CONFIG_MODE_Msk) >> GPIOTE_CONFIG_MODE_Pos !=
+        GPIOTE_CONFIG_MODE_Task)
+    {
+        return;
+    }
+
+    if (off >= offsetof(NRF_GPIOTE_Type, TASKS_CLR))
+    {
+        high = false;
+    }
+    else if (off >= offsetof(NRF_GPIOTE_Type, TASKS_SET))
+    {
+        high = true;
+    }
+    else if (polarity == GPIOTE_CONFIG_POLARITY_Toggle)
+    {
+        high = !high;
+    }
+    else if (polarity != GPIOTE_CONFIG_POLARITY_None)
+    {
+        high = polarity == GPIOTE_CONFIG_POLARITY_LoToHi;
+    }
+
+    sim_gpio.te_val[port] = high ? (sim_gpio.te_val[port] | msk) : (sim_gpio.te_val[port] & ~msk);
+    sim_gpio_update();
+}
+
+static void sim_gpiote_write(void *p_ctx, uint32_t off, uint32_t old, uint32_t val)
+{
+    if (off < offsetof(NRF_GPIOTE_Type, CONFIG))
+    {
+        return;
+    }
+
+    /* Task channel owns its pin since configuration, event channel only watches it. */
+    memset(sim_gpio.te_mask, 0, sizeof(sim_gpio.te_mask));
+    for (uint32_t ch = 0; ch < SIM_GPIOTE_CH_COUNT; ch++)
+    {
+        uint32_t config = NRF_GPIOTE->CONFIG[ch];
+        uint32_t psel = sim_gpiote_psel_get(ch);
+        uint32_t msk = 1UL << (psel & 31);
+
+        if ((config & GPIOTE_CONFIG_MODE_Msk) >> GPIOTE_CONFIG_MODE_Pos != GPIOTE_CONFIG_MODE_Task)
+        {
+            continue;
+        }
+        sim_gpio.te_mask[psel >> 5] |= msk;
+        if (off == offsetof(NRF_GPIOTE_Type, CONFIG) + 4 * ch)
+        {
+            bool high = config & GPIOTE_CONFIG_OUTINIT_Msk;
+            sim_gpio.te_val[psel >> 5] = high ? (sim_gpio.te_val[psel >> 5] | msk) :
+                                                (sim_gpio.te_val[psel >> 5] & ~msk);
+        }
+    }
+    sim_gpio_update();
+}
+
+static const sim_periph_ops_s sim_gpiote_ops = {
+    .task  = sim_gpiote_task,
+    .write = sim_gpiote_write,
+};
+
+void sim_gpio_init(void)
+{
+    memset(&sim_gpio, 0, sizeof(sim_gpio));
+    for (uint32_t port = 0; port < SIM_GPIO_PORTS; port++)
+    {
+        NRF_GPIO_Type *p_reg = sim_gpio_port_get(port);
+        for (uint32_t pin = 0; pin < 32; pin++)
+        {
+            sim_reg_write(&p_reg->PIN_CNF[pin], GPIO_PIN_CNF_INPUT_Msk);
+        }
+        sim_gpio.level[port] = sim_gpio_level_calc(port);
+        sim_reg_write(&p_reg->IN, sim_gpio.level[port]);
+    }
+    sim_periph_add(NRF_P0_BASE, &sim_gpio_ops, NULL);
+    sim_periph_add(NRF_GPIOTE_BASE, &sim_gpiote_ops, NULL);
+}
+
+void sim_gpio_listen(uint32_t psel, sim_gpio_listener_t fn, void *p_ctx)
+{
+    SIM_CHECK(sim_gpio.listener_count < SIM_GPIO_LISTENERS);
+    sim_gpio.listeners[sim_gpio.listener_count++] =
+            (sim_gpio_listener_s){ .fn = fn, .p_ctx = p_ctx, .psel = psel };
+}
+
+bool sim_gpio_level_get(uint32_t psel)
+{
+    return sim_gpio.level[psel >> 5] & (1UL << (psel & 31));
+}
+
+void sim_gpio_drive(uint32_t psel, bool level)
+{
+    uint32_t port = psel >> 5;
+    uint32_t msk = 1UL << (psel & 31);
+
+    sim_gpio.ext_mask[port] |= msk;
+    sim_gpio.ext_val[port] = level ? (sim_gpio.ext_val[port] | msk) : (sim_gpio.ext_val[port] & ~msk);
+    sim_gpio_update();
+}
+
+void sim_gpio_release(uint32_t psel)
+{
+    sim_gpio.ext_mask[psel >> 5] &= ~(1UL << (psel & 31));
+    sim_gpio_update();
+}
@@ -0,0 +1,50 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIM_GPIO_H
+#define SIM_GPIO_H
+
+/* GPIO and GPIOTE models. Pins are addressed by PSEL value, pin | (port << 5).
+ *
+ * Pin level is decided by, in order: GPIOTE task channel owning the pin, level driven
+ * by the test, OUT register if pin is configured as output. Other pins are pulled up. */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef void (*sim_gpio_listener_t)(void *p_ctx, uint32_t psel, bool level);
+
+void sim_gpio_init(void);
+
+/* Listener is called on every level change of the pin. */
+void sim_gpio_listen(uint32_t psel, sim_gpio_listener_t fn, void *p_ctx);
+
+bool sim_gpio_level_get(uint32_t psel);
+
+/* Drives the pin from outside, like a peer device does. */
+void sim_gpio_drive(uint32_t psel, bool level);
+
+void sim_gpio_release(uint32_t psel);
+
+#endif // SIM_GPIO_H
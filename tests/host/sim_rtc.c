@@ -0,0 +1,209 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include "sim.h"
+#include "sim_rtc.h"
+
+#define SIM_RTC_COUNT         3
+#define SIM_RTC_FREQ          32768
+#define SIM_RTC_COMPARE_Pos   16
+
+static sim_rtc_s sim_rtcs[SIM_RTC_COUNT];
+
+/* Nanoseconds of SIM_RTC_FREQ ticks, so tick conversions do not round. */
+static uint64_t sim_rtc_period_ns(sim_rtc_s *p_rtc)
+{
+    return (uint64_t)(p_rtc->p_reg->PRESCALER + 1) * 1000000000ULL;
+}
+
+uint64_t sim_rtc_tick_ns(sim_rtc_s *p_rtc)
+{
+    return sim_rtc_period_ns(p_rtc) / SIM_RTC_FREQ;
+}
+
+/* Ticks since t0. 128 bits hold any prescaler. */
+static uint64_t sim_rtc_ticks(sim_rtc_s *p_rtc)
+{
+    if (!p_rtc->running)
+    {
+        return 0;
+    }
+    return (uint64_t)((unsigned __int128)(sim_now() - p_rtc->t0) * SIM_RTC_FREQ /
+                      sim_rtc_period_ns(p_rtc));
+}
+
+static uint32_t sim_rtc_counter(sim_rtc_s *p_rtc)
+{
+    return (uint32_t)((p_rtc->c0 + sim_rtc_ticks(p_rtc)) & RTC_COUNTER_COUNTER_Msk);
+}
+
+static void sim_rtc_compare(void *p_ctx, uint32_t arg)
+{
+    sim_rtc_s *p_rtc = p_ctx;
+    NRF_RTC_Type *p_reg = p_rtc->p_reg;
+    uint32_t n = arg % SIM_RTC_CC_COUNT;
+    uint32_t mask = 1UL << (SIM_RTC_COMPARE_Pos + n);
+
+    if (!p_rtc->armed[n] || (arg / SIM_RTC_CC_COUNT != p_rtc->gen[n]))
+    {
+        return;
+    }
+    p_rtc->armed[n] = false;
+    p_rtc->compares++;
+
+    /* Event is routed to EVENTS register only if enabled for PPI or interrupt. */
+    if (p_reg->EVTEN & mask)
+    {
+        sim_evt_raise(&p_reg->EVENTS_COMPARE[n]);
+    }
+    else if (p_reg->INTENSET & mask)
+    {
+        sim_reg_write(&p_reg->EVENTS_COMPARE[n], 1);
+    }
+}
+
+static void sim_rtc_schedule(sim_rtc_s *p_rtc, uint32_t n)
+{
+    uint32_t counter = sim_rtc_counter(p_rtc);
+    uint32_t delta = (p_rtc->p_reg->CC[n] - counter) & RTC_COUNTER_COUNTER_Msk;
+    unsigned __int128 ticks;
+    uint64_t t;
+
+    p_rtc->gen[n]++;
+    if (!p_rtc->running || !p_rtc->armed[n] || (delta < 2))
+    {
+        return;
+    }
+
+    /* First moment COUNTER shows CC. */
+    ticks = (unsigned __int128)sim_rtc_ticks(p_rtc) + delta;
+    t = p_rtc->t0 + (uint64_t)((ticks * sim_rtc_period_ns(p_rtc) + SIM_RTC_FREQ - 1) / SIM_RTC_FREQ);
+    sim_at(t, sim_rtc_compare, p_rtc, p_rtc->gen[n] * SIM_RTC_CC_COUNT + n);
+}
+
+static void sim_rtc_reschedule(sim_rtc_s *p_rtc)
+{
+    for (uint32_t n = 0; n < SIM_RTC_CC_COUNT; n++)
+    {
+        sim_rtc_schedule(p_rtc, n);
+    }
+}
+
+static void sim_rtc_task(void *p_ctx, uint32_t off)
+{
+    sim_rtc_s *p_rtc = p_ctx;
+    uint32_t counter = sim_rtc_counter(p_rtc);
+
+    if (off == offsetof(NRF_RTC_Type, TASKS_START))
+    {
+        p_rtc->running = true;
+    }
+    else if (off == offsetof(NRF_RTC_Type, TASKS_STOP))
+    {
+        p_rtc->running = false;
+    }
+    else if (off == offsetof(NRF_RTC_Type, TASKS_CLEAR))
+    {
+        counter = 0;
+    }
+    else
+    {
+        return;
+    }
+    p_rtc->c0 = counter;
+    p_rtc->t0 = sim_now();
+    sim_reg_write(&p_rtc->p_reg->COUNTER, counter);
+    sim_rtc_reschedule(p_rtc);
+}
+
+static void sim_rtc_write(void *p_ctx, uint32_t off, uint32_t old, uint32_t val)
+{
+    sim_rtc_s *p_rtc = p_ctx;
+    NRF_RTC_Type *p_reg = p_rtc->p_reg;
+    uint32_t evten = p_reg->EVTEN;
+
+    if ((off >= offsetof(NRF_RTC_Type, CC)) &&
+        (off < offsetof(NRF_RTC_Type, CC) + sizeof(p_reg->CC)))
+    {
+        uint32_t n = (off - offsetof(NRF_RTC_Type, CC)) / sizeof(p_reg->CC[0]);
+        sim_reg_write(&p_reg->CC[n], val & RTC_CC_COMPARE_Msk);
+        p_rtc->armed[n] = true;
+        sim_rtc_schedule(p_rtc, n);
+        return;
+    }
+
+    /* EVTEN, EVTENSET and EVTENCLR read back the same value. */
+    if (off == offsetof(NRF_RTC_Type, EVTENSET))
+    {
+        evten = old | val;
+    }
+    else if (off == offsetof(NRF_RTC_Type, EVTENCLR))
+    {
+        evten = old & ~val;
+    }
+    else if (off != offsetof(NRF_RTC_Type, EVTEN))
+    {
+        return;
+    }
+    sim_reg_write(&p_reg->EVTEN, evten);
+    sim_reg_write(&p_reg->EVTENSET, evten);
+    sim_reg_write(&p_reg->EVTENCLR, evten);
+}
+
+static void sim_rtc_tick(void *p_ctx)
+{
+    sim_rtc_s *p_rtc = p_ctx;
+
+    if (p_rtc->running)
+    {
+        sim_reg_write(&p_rtc->p_reg->COUNTER, sim_rtc_counter(p_rtc));
+    }
+}
+
+static const sim_periph_ops_s sim_rtc_ops = {
+    .task  = sim_rtc_task,
+    .write = sim_rtc_write,
+    .tick  = sim_rtc_tick,
+};
+
+sim_rtc_s *sim_rtc_add(NRF_RTC_Type *p_reg)
+{
+    sim_rtc_s *p_rtc = NULL;
+
+    for (uint32_t i = 0; i < SIM_RTC_COUNT; i++)
+    {
+        if ((sim_rtcs[i].p_reg == NULL) || (sim_rtcs[i].p_reg == p_reg))
+        {
+            p_rtc = &sim_rtcs[i];
+            break;
+        }
+    }
+    SIM_CHECK(p_rtc != NULL);
+
+    memset(p_rtc, 0, sizeof(*p_rtc));
+    p_rtc->p_reg = p_reg;
+    sim_periph_add((uint32_t)(uintptr_t)p_reg, &sim_rtc_ops, p_rtc);
+    return p_rtc;
+}
@@ -0,0 +1,54 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIM_RTC_H
+#define SIM_RTC_H
+
+/* RTC model. COUNTER follows simulated time at 32768 / (PRESCALER + 1) Hz. COMPARE[n] is
+ * generated once after each write of CC[n], when COUNTER reaches it, like drivers setting
+ * a new CC for every timeout expect. CC less than 2 ticks ahead of COUNTER is never
+ * reached, worst case of hardware. TICK and OVRFLW events are not modelled. */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "nodi_common.h"
+
+#define SIM_RTC_CC_COUNT      4
+
+typedef struct {
+    NRF_RTC_Type             *p_reg;
+    bool                      running;
+    uint32_t                  c0;                      // COUNTER at t0
+    uint64_t                  t0;
+    bool                      armed[SIM_RTC_CC_COUNT]; // CC written, COMPARE not generated yet
+    uint32_t                  gen[SIM_RTC_CC_COUNT];
+    uint32_t                  compares;                // Generated COMPARE events
+} sim_rtc_s;
+
+sim_rtc_s *sim_rtc_add(NRF_RTC_Type *p_reg);
+
+/* Length of COUNTER tick at current PRESCALER. */
+uint64_t sim_rtc_tick_ns(sim_rtc_s *p_rtc);
+
+#endif // SIM_RTC_H
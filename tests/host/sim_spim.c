@@ -0,0 +1,244 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include "sim.h"
+#include "sim_gpio.h"
+#include "sim_spim.h"
+
+#define SIM_SPIM_COUNT        4
+#define SIM_SPIM_ENABLE       7
+
+static sim_spim_s sim_spims[SIM_SPIM_COUNT];
+
+uint64_t sim_spim_byte_ns(uint32_t frequency)
+{
+    switch (frequency)
+    {
+    case SPIM_FREQUENCY_FREQUENCY_K125:
+        return 64000;
+    case SPIM_FREQUENCY_FREQUENCY_K250:
+        return 32000;
+    case SPIM_FREQUENCY_FREQUENCY_K500:
+        return 16000;
+    case SPIM_FREQUENCY_FREQUENCY_M1:
+        return 8000;
+    case SPIM_FREQUENCY_FREQUENCY_M2:
+        return 4000;
+    case SPIM_FREQUENCY_FREQUENCY_M4:
+        return 2000;
+    case SPIM_FREQUENCY_FREQUENCY_M8:
+        return 1000;
+    case SPIM_FREQUENCY_FREQUENCY_M16:
+        return 500;
+    case SPIM_FREQUENCY_FREQUENCY_M32:
+        return 250;
+    default:
+        SIM_CHECK(false);
+        return 0;
+    }
+}
+
+static void sim_spim_exchange(sim_spim_s *p_spim, uint32_t n)
+{
+    NRF_SPIM_Type *p_reg = p_spim->p_reg;
+    sim_spim_xfer_s *p_xfer = &p_spim->xfer;
+    uint8_t *p_rx = SIM_PTR(p_reg->RXD.PTR);
+
+    p_xfer->selected = 0;
+    p_xfer->p_dev = NULL;
+    for (sim_spi_dev_s *p_dev = p_spim->p_devs; p_dev != NULL; p_dev = p_dev->p_next)
+    {
+        if (p_dev->selected)
+        {
+            p_xfer->selected++;
+            p_xfer->p_dev = p_dev;
+        }
+    }
+    if (p_xfer->selected > 1)
+    {
+        p_spim->conflicts++;
+    }
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint8_t mosi = i < p_xfer->n_tx ? p_xfer->p_tx[i] : (uint8_t)p_reg->ORC;
+        uint8_t miso = 0xFF;
+        for (sim_spi_dev_s *p_dev = p_spim->p_devs; p_dev != NULL; p_dev = p_dev->p_next)
+        {
+            if (p_dev->selected)
+            {
+                miso &= p_dev->xfer_cb(p_dev, mosi);
+            }
+        }
+        if (i < p_xfer->n_rx)
+        {
+            p_rx[i] = miso;
+        }
+    }
+
+    p_xfer->t_end = sim_now();
+    p_spim->bytes += n;
+    sim_reg_write(&p_reg->TXD.AMOUNT, n < p_xfer->n_tx ? n : p_xfer->n_tx);
+    sim_reg_write(&p_reg->RXD.AMOUNT, n < p_xfer->n_rx ? n : p_xfer->n_rx);
+}
+
+static void sim_spim_start(sim_spim_s *p_spim);
+
+static void sim_spim_end(void *p_ctx, uint32_t gen)
+{
+    sim_spim_s *p_spim = p_ctx;
+    NRF_SPIM_Type *p_reg = p_spim->p_reg;
+    sim_spim_xfer_s *p_xfer = &p_spim->xfer;
+
+    if (!p_spim->active || (gen != p_spim->gen))
+    {
+        return;
+    }
+
+    sim_spim_exchange(p_spim, p_xfer->n_tx > p_xfer->n_rx ? p_xfer->n_tx : p_xfer->n_rx);
+    p_spim->active = false;
+    p_spim->xfers++;
+
+    /* ArrayList moves pointers by MAXCNT, next START uses the next element. */
+    if (p_reg->TXD.LIST == SPIM_TXD_LIST_LIST_ArrayList)
+    {
+        sim_reg_write(&p_reg->TXD.PTR, p_reg->TXD.PTR + p_xfer->n_tx);
+    }
+    if (p_reg->RXD.LIST == SPIM_RXD_LIST_LIST_ArrayList)
+    {
+        sim_reg_write(&p_reg->RXD.PTR, p_reg->RXD.PTR + p_xfer->n_rx);
+    }
+
+    sim_evt_raise(&p_reg->EVENTS_ENDRX);
+    sim_evt_raise(&p_reg->EVENTS_ENDTX);
+    sim_evt_raise(&p_reg->EVENTS_END);
+
+    if (p_spim->xfer_hook != NULL)
+    {
+        p_spim->xfer_hook(p_spim->p_hook_ctx, p_xfer);
+    }
+
+    if (p_reg->SHORTS & SPIM_SHORTS_END_START_Msk)
+    {
+        sim_spim_start(p_spim);
+    }
+}
+
+static void sim_spim_start(sim_spim_s *p_spim)
+{
+    NRF_SPIM_Type *p_reg = p_spim->p_reg;
+    sim_spim_xfer_s *p_xfer = &p_spim->xfer;
+    uint32_t n;
+
+    if (p_reg->ENABLE != SIM_SPIM_ENABLE)
+    {
+        return;
+    }
+    /* Driver must not start a transfer in progress. */
+    SIM_CHECK(!p_spim->active);
+
+    p_xfer->t_start = sim_now();
+    p_xfer->p_tx = SIM_PTR(p_reg->TXD.PTR);
+    p_xfer->n_tx = p_reg->TXD.MAXCNT;
+    p_xfer->n_rx = p_reg->RXD.MAXCNT;
+    n = p_xfer->n_tx > p_xfer->n_rx ? p_xfer->n_tx : p_xfer->n_rx;
+
+    p_spim->active = true;
+    p_spim->gen++;
+    sim_evt_raise(&p_reg->EVENTS_STARTED);
+    sim_at(sim_now() + n * sim_spim_byte_ns(p_reg->FREQUENCY), sim_spim_end, p_spim, p_spim->gen);
+}
+
+static void sim_spim_task(void *p_ctx, uint32_t off)
+{
+    sim_spim_s *p_spim = p_ctx;
+    NRF_SPIM_Type *p_reg = p_spim->p_reg;
+
+    if (off == offsetof(NRF_SPIM_Type, TASKS_START))
+    {
+        sim_spim_start(p_spim);
+    }
+    else if (off == offsetof(NRF_SPIM_Type, TASKS_STOP))
+    {
+        /* Transfer is cut after the byte on the bus. */
+        if (p_spim->active)
+        {
+            uint64_t byte_ns = sim_spim_byte_ns(p_reg->FREQUENCY);
+            uint32_t n = (uint32_t)((sim_now() - p_spim->xfer.t_start + byte_ns - 1) / byte_ns);
+            uint32_t n_max = p_spim->xfer.n_tx > p_spim->xfer.n_rx ? p_spim->xfer.n_tx : p_spim->xfer.n_rx;
+            p_spim->gen++;
+            p_spim->active = false;
+            sim_spim_exchange(p_spim, n < n_max ? n : n_max);
+        }
+        sim_evt_raise(&p_reg->EVENTS_STOPPED);
+    }
+}
+
+static const sim_periph_ops_s sim_spim_ops = {
+    .task = sim_spim_task,
+};
+
+static void sim_spim_cs_listener(void *p_ctx, uint32_t psel, bool level)
+{
+    sim_spi_dev_s *p_dev = p_ctx;
+
+    p_dev->selected = !level;
+    if (p_dev->cs_cb != NULL)
+    {
+        p_dev->cs_cb(p_dev, p_dev->selected);
+    }
+}
+
+sim_spim_s *sim_spim_add(NRF_SPIM_Type *p_reg)
+{
+    sim_spim_s *p_spim = NULL;
+
+    for (uint32_t i = 0; i < SIM_SPIM_COUNT; i++)
+    {
+        if ((sim_spims[i].p_reg == NULL) || (sim_spims[i].p_reg == p_reg))
+        {
+            p_spim = &sim_spims[i];
+            break;
+        }
+    }
+    SIM_CHECK(p_spim != NULL);
+
+    memset(p_spim, 0, sizeof(*p_spim));
+    p_spim->p_reg = p_reg;
+    sim_reg_write(&p_reg->PSEL.SCK, 0xFFFFFFFF);
+    sim_reg_write(&p_reg->PSEL.MOSI, 0xFFFFFFFF);
+    sim_reg_write(&p_reg->PSEL.MISO, 0xFFFFFFFF);
+    sim_reg_write(&p_reg->FREQUENCY, SPIM_FREQUENCY_FREQUENCY_K250);
+    sim_periph_add((uint32_t)(uintptr_t)p_reg, &sim_spim_ops, p_spim);
+    return p_spim;
+}
+
+void sim_spim_dev_attach(sim_spim_s *p_spim, sim_spi_dev_s *p_dev)
+{
+    p_dev->selected = !sim_gpio_level_get(p_dev->cs_psel);
+    p_dev->p_next = p_spim->p_devs;
+    p_spim->p_devs = p_dev;
+    sim_gpio_listen(p_dev->cs_psel, sim_spim_cs_listener, p_dev);
+}
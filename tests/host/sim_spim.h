@@ -0,0 +1,80 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIM_SPIM_H
+#define SIM_SPIM_H
+
+/* SPIM model. Transfer takes MAX(TXD.MAXCNT, RXD.MAXCNT) * 8 SCK periods, bytes are
+ * exchanged with attached devices selected by their CS pins when END is generated.
+ * MISO is pulled up when no device is selected. */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "nodi_common.h"
+
+typedef struct sim_spi_dev sim_spi_dev_s;
+
+/* SPI device on the bus. Callbacks are called from hardware context. */
+struct sim_spi_dev {
+    uint32_t                  cs_psel;   // CS pin, active low
+    void                    (*cs_cb)(sim_spi_dev_s *p_dev, bool selected);
+    uint8_t                 (*xfer_cb)(sim_spi_dev_s *p_dev, uint8_t mosi);
+    bool                      selected;  // Managed by model
+    sim_spi_dev_s            *p_next;    // Managed by model
+};
+
+/* Finished transfer seen on the bus. */
+typedef struct {
+    uint64_t                  t_start;
+    uint64_t                  t_end;
+    const uint8_t            *p_tx;      // TXD.PTR at START
+    uint32_t                  n_tx;
+    uint32_t                  n_rx;
+    uint32_t                  selected;  // Number of selected devices
+    sim_spi_dev_s            *p_dev;     // Selected device or NULL
+} sim_spim_xfer_s;
+
+typedef void (*sim_spim_xfer_hook_t)(void *p_ctx, const sim_spim_xfer_s *p_xfer);
+
+typedef struct {
+    NRF_SPIM_Type            *p_reg;
+    sim_spi_dev_s            *p_devs;
+    bool                      active;
+    uint32_t                  gen;
+    sim_spim_xfer_s           xfer;
+    sim_spim_xfer_hook_t      xfer_hook;
+    void                     *p_hook_ctx;
+    uint32_t                  xfers;     // Finished transfers
+    uint32_t                  conflicts; // Transfers with more than one device selected
+    uint64_t                  bytes;     // Bytes clocked on the bus
+} sim_spim_s;
+
+sim_spim_s *sim_spim_add(NRF_SPIM_Type *p_reg);
+
+void sim_spim_dev_attach(sim_spim_s *p_spim, sim_spi_dev_s *p_dev);
+
+/* Time of single byte at FREQUENCY register value. */
+uint64_t sim_spim_byte_ns(uint32_t frequency);
+
+#endif // SIM_SPIM_H
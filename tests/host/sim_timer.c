@@ -0,0 +1,241 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include "sim.h"
+#include "sim_timer.h"
+
+#define SIM_TIMER_COUNT       5
+#define SIM_TIMER_FREQ        16000000ULL
+
+static sim_timer_s sim_timers[SIM_TIMER_COUNT];
+
+static bool sim_timer_counter_mode(sim_timer_s *p_timer)
+{
+    return p_timer->p_reg->MODE != TIMER_MODE_MODE_Timer;
+}
+
+static uint32_t sim_timer_mask(sim_timer_s *p_timer)
+{
+    switch (p_timer->p_reg->BITMODE & TIMER_BITMODE_BITMODE_Msk)
+    {
+        case TIMER_BITMODE_BITMODE_08Bit:
+            return 0xFFUL;
+        case TIMER_BITMODE_BITMODE_24Bit:
+            return 0xFFFFFFUL;
+        case TIMER_BITMODE_BITMODE_32Bit:
+            return 0xFFFFFFFFUL;
+        default:
+            return 0xFFFFUL;
+    }
+}
+
+/* Nanoseconds of SIM_TIMER_FREQ ticks, so tick conversions do not round. */
+static uint64_t sim_timer_period_ns(sim_timer_s *p_timer)
+{
+    return 1000000000ULL << (p_timer->p_reg->PRESCALER & TIMER_PRESCALER_PRESCALER_Msk);
+}
+
+static uint64_t sim_timer_ticks(sim_timer_s *p_timer)
+{
+    if (!p_timer->running || sim_timer_counter_mode(p_timer))
+    {
+        return 0;
+    }
+    return (uint64_t)((unsigned __int128)(sim_now() - p_timer->t0) * SIM_TIMER_FREQ /
+                      sim_timer_period_ns(p_timer));
+}
+
+static uint32_t sim_timer_counter(sim_timer_s *p_timer)
+{
+    return (uint32_t)((p_timer->c0 + sim_timer_ticks(p_timer)) & sim_timer_mask(p_timer));
+}
+
+static void sim_timer_rebase(sim_timer_s *p_timer, uint32_t counter)
+{
+    p_timer->c0 = counter;
+    p_timer->t0 = sim_now();
+}
+
+static void sim_timer_schedule(sim_timer_s *p_timer);
+
+/* Counter equals CC[n] now. */
+static void sim_timer_match(sim_timer_s *p_timer, uint32_t n)
+{
+    NRF_TIMER_Type *p_reg = p_timer->p_reg;
+
+    p_timer->compares++;
+    sim_evt_raise(&p_reg->EVENTS_COMPARE[n]);
+    if (p_reg->SHORTS & (TIMER_SHORTS_COMPARE0_CLEAR_Msk << n))
+    {
+        sim_timer_rebase(p_timer, 0);
+    }
+    if (p_reg->SHORTS & (TIMER_SHORTS_COMPARE0_STOP_Msk << n))
+    {
+        sim_timer_rebase(p_timer, sim_timer_counter(p_timer));
+        p_timer->running = false;
+    }
+}
+
+static void sim_timer_compare(void *p_ctx, uint32_t gen)
+{
+    sim_timer_s *p_timer = p_ctx;
+    uint32_t counter = sim_timer_counter(p_timer);
+
+    if (gen != p_timer->gen)
+    {
+        return;
+    }
+    for (uint32_t n = 0; n < SIM_TIMER_CC_COUNT; n++)
+    {
+        if (p_timer->armed[n] && (p_timer->p_reg->CC[n] == counter))
+        {
+            sim_timer_match(p_timer, n);
+        }
+    }
+    sim_timer_schedule(p_timer);
+}
+
+/* The nearest CC reached by Timer mode counter is scheduled, counter is rebased to now. */
+static void sim_timer_schedule(sim_timer_s *p_timer)
+{
+    uint32_t counter = sim_timer_counter(p_timer);
+    uint32_t mask = sim_timer_mask(p_timer);
+    uint64_t delta_min = UINT64_MAX;
+
+    p_timer->gen++;
+    sim_timer_rebase(p_timer, counter);
+    if (!p_timer->running || sim_timer_counter_mode(p_timer))
+    {
+        return;
+    }
+
+    for (uint32_t n = 0; n < SIM_TIMER_CC_COUNT; n++)
+    {
+        uint64_t delta = (p_timer->p_reg->CC[n] - counter) & mask;
+        if (p_timer->armed[n] && (delta != 0) && (delta < delta_min))
+        {
+            delta_min = delta;
+        }
+    }
+    if (delta_min == UINT64_MAX)
+    {
+        return;
+    }
+    sim_at(p_timer->t0 + (uint64_t)(((unsigned __int128)delta_min * sim_timer_period_ns(p_timer) +
+                                     SIM_TIMER_FREQ - 1) / SIM_TIMER_FREQ),
+           sim_timer_compare, p_timer, p_timer->gen);
+}
+
+static void sim_timer_task(void *p_ctx, uint32_t off)
+{
+    sim_timer_s *p_timer = p_ctx;
+    NRF_TIMER_Type *p_reg = p_timer->p_reg;
+    uint32_t counter = sim_timer_counter(p_timer);
+
+    if ((off >= offsetof(NRF_TIMER_Type, TASKS_CAPTURE)) &&
+        (off < offsetof(NRF_TIMER_Type, TASKS_CAPTURE) + sizeof(p_reg->TASKS_CAPTURE)))
+    {
+        uint32_t n = (off - offsetof(NRF_TIMER_Type, TASKS_CAPTURE)) / sizeof(p_reg->TASKS_CAPTURE[0]);
+        sim_reg_write(&p_reg->CC[n], counter);
+        return;
+    }
+
+    if (off == offsetof(NRF_TIMER_Type, TASKS_START))
+    {
+        p_timer->running = true;
+    }
+    else if ((off == offsetof(NRF_TIMER_Type, TASKS_STOP)) ||
+             (off == offsetof(NRF_TIMER_Type, TASKS_SHUTDOWN)))
+    {
+        p_timer->running = false;
+    }
+    else if (off == offsetof(NRF_TIMER_Type, TASKS_CLEAR))
+    {
+        counter = 0;
+    }
+    else if ((off == offsetof(NRF_TIMER_Type, TASKS_COUNT)) && p_timer->running &&
+             sim_timer_counter_mode(p_timer))
+    {
+        counter = (counter + 1) & sim_timer_mask(p_timer);
+        sim_timer_rebase(p_timer, counter);
+        for (uint32_t n = 0; n < SIM_TIMER_CC_COUNT; n++)
+        {
+            if (p_timer->armed[n] && (p_reg->CC[n] == counter))
+            {
+                sim_timer_match(p_timer, n);
+            }
+        }
+        return;
+    }
+    else
+    {
+        return;
+    }
+    sim_timer_rebase(p_timer, counter);
+    sim_timer_schedule(p_timer);
+}
+
+static void sim_timer_write(void *p_ctx, uint32_t off, uint32_t old, uint32_t val)
+{
+    sim_timer_s *p_timer = p_ctx;
+
+    if ((off >= offsetof(NRF_TIMER_Type, CC)) &&
+        (off < offsetof(NRF_TIMER_Type, CC) + sizeof(p_timer->p_reg->CC)))
+    {
+        p_timer->armed[(off - offsetof(NRF_TIMER_Type, CC)) / sizeof(p_timer->p_reg->CC[0])] = true;
+    }
+
+    /* Counter keeps its value across CC and configuration changes. */
+    if ((off >= offsetof(NRF_TIMER_Type, SHORTS)) && (off != offsetof(NRF_TIMER_Type, INTENSET)) &&
+        (off != offsetof(NRF_TIMER_Type, INTENCLR)))
+    {
+        sim_timer_schedule(p_timer);
+    }
+}
+
+static const sim_periph_ops_s sim_timer_ops = {
+    .task  = sim_timer_task,
+    .write = sim_timer_write,
+};
+
+sim_timer_s *sim_timer_add(NRF_TIMER_Type *p_reg)
+{
+    sim_timer_s *p_timer = NULL;
+
+    for (uint32_t i = 0; i < SIM_TIMER_COUNT; i++)
+    {
+        if ((sim_timers[i].p_reg == NULL) || (sim_timers[i].p_reg == p_reg))
+        {
+            p_timer = &sim_timers[i];
+            break;
+        }
+    }
+    SIM_CHECK(p_timer != NULL);
+
+    memset(p_timer, 0, sizeof(*p_timer));
+    p_timer->p_reg = p_reg;
+    sim_periph_add((uint32_t)(uintptr_t)p_reg, &sim_timer_ops, p_timer);
+    return p_timer;
+}
@@ -0,0 +1,53 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIM_TIMER_H
+#define SIM_TIMER_H
+
+/* TIMER model. In Timer mode the counter follows simulated time at 16 MHz / 2^PRESCALER,
+ * in Counter modes it is incremented by COUNT task. COMPARE[n] is generated when counter
+ * reaches CC[n], followed by COMPAREn_CLEAR and COMPAREn_STOP shorts. Only CC registers
+ * written by driver are compared, values left by CAPTURE tasks are not, and CC equal to
+ * the counter is not reached again after a wrap, so stopped scenarios do not leave events
+ * far on the time line. */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "nodi_common.h"
+
+#define SIM_TIMER_CC_COUNT    6
+
+typedef struct {
+    NRF_TIMER_Type           *p_reg;
+    bool                      running;
+    uint32_t                  c0;                        // Counter at t0
+    uint64_t                  t0;
+    bool                      armed[SIM_TIMER_CC_COUNT]; // CC written by driver
+    uint32_t                  gen;
+    uint32_t                  compares;                  // Generated COMPARE events
+} sim_timer_s;
+
+sim_timer_s *sim_timer_add(NRF_TIMER_Type *p_reg);
+
+#endif // SIM_TIMER_H
@@ -0,0 +1,363 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include "sim.h"
+#include "sim_gpio.h"
+#include "sim_uarte.h"
+
+#define SIM_UARTE_COUNT       2
+#define SIM_UARTE_PSEL_NC     0xFFFFFFFFUL
+
+static sim_uarte_s sim_uartes[SIM_UARTE_COUNT];
+
+uint64_t sim_uarte_char_ns(sim_uarte_s *p_uarte)
+{
+    NRF_UARTE_Type *p_reg = p_uarte->p_reg;
+    uint64_t baud = ((uint64_t)p_reg->BAUDRATE * 16000000ULL + (1ULL << 31)) >> 32;
+    uint64_t bits = (p_reg->CONFIG & UARTE_CONFIG_PARITY_Msk) ? 11 : 10;
+
+    SIM_CHECK(baud != 0);
+    return (bits * 1000000000ULL + baud - 1) / baud;
+}
+
+static bool sim_uarte_enabled(sim_uarte_s *p_uarte)
+{
+    return p_uarte->p_reg->ENABLE == UARTE_ENABLE_ENABLE_Enabled;
+}
+
+/*===========================================================================*/
+/* Receiver.                                                                 */
+/*===========================================================================*/
+
+static void sim_uarte_rx_start(sim_uarte_s *p_uarte);
+
+static void sim_uarte_rx_end(sim_uarte_s *p_uarte)
+{
+    NRF_UARTE_Type *p_reg = p_uarte->p_reg;
+
+    p_uarte->rx_active = false;
+    sim_reg_write(&p_reg->RXD.AMOUNT, p_uarte->rx_cnt);
+    sim_evt_raise(&p_reg->EVENTS_ENDRX);
+    if (p_reg->SHORTS & UARTE_SHORTS_ENDRX_STARTRX_Msk)
+    {
+        sim_uarte_rx_start(p_uarte);
+    }
+}
+
+static void sim_uarte_rx_put(sim_uarte_s *p_uarte, uint8_t byte)
+{
+    p_uarte->p_rx[p_uarte->rx_cnt++] = byte;
+    p_uarte->rx_bytes++;
+    if (p_uarte->rx_cnt == p_uarte->rx_max)
+    {
+        sim_uarte_rx_end(p_uarte);
+    }
+}
+
+static void sim_uarte_fifo_drain(sim_uarte_s *p_uarte)
+{
+    while (p_uarte->rx_active && (p_uarte->fifo_n != 0))
+    {
+        uint8_t byte = p_uarte->fifo[0];
+        memmove(p_uarte->fifo, p_uarte->fifo + 1, --p_uarte->fifo_n);
+        sim_uarte_rx_put(p_uarte, byte);
+    }
+}
+
+static void sim_uarte_rx_start(sim_uarte_s *p_uarte)
+{
+    NRF_UARTE_Type *p_reg = p_uarte->p_reg;
+
+    p_uarte->rx_on = true;
+    p_uarte->rx_active = true;
+    p_uarte->p_rx = SIM_PTR(p_reg->RXD.PTR);
+    p_uarte->rx_max = p_reg->RXD.MAXCNT;
+    p_uarte->rx_cnt = 0;
+    p_uarte->rx_gen++;
+    sim_evt_raise(&p_reg->EVENTS_RXSTARTED);
+    if (p_uarte->rx_max == 0)
+    {
+        sim_uarte_rx_end(p_uarte);
+        return;
+    }
+    sim_uarte_fifo_drain(p_uarte);
+}
+
+static void sim_uarte_rx_started(void *p_ctx, uint32_t gen)
+{
+    sim_uarte_s *p_uarte = p_ctx;
+
+    if (gen == p_uarte->rx_gen)
+    {
+        sim_uarte_rx_start(p_uarte);
+    }
+}
+
+static void sim_uarte_rxto(void *p_ctx, uint32_t gen)
+{
+    sim_uarte_s *p_uarte = p_ctx;
+
+    if (gen != p_uarte->rx_gen)
+    {
+        return;
+    }
+    p_uarte->rx_on = false;
+    sim_evt_raise(&p_uarte->p_reg->EVENTS_RXTO);
+}
+
+void sim_uarte_rx_byte(sim_uarte_s *p_uarte, uint8_t byte, uint32_t errorsrc)
+{
+    NRF_UARTE_Type *p_reg = p_uarte->p_reg;
+
+    if (!sim_uarte_enabled(p_uarte) || !p_uarte->rx_on)
+    {
+        p_uarte->rx_off++;
+        return;
+    }
+
+    sim_evt_raise(&p_reg->EVENTS_RXDRDY);
+    if ((errorsrc == 0) && p_uarte->rx_active && (p_uarte->fifo_n == 0))
+    {
+        sim_uarte_rx_put(p_uarte, byte);
+    }
+    else if (p_uarte->fifo_n < SIM_UARTE_FIFO_LEN)
+    {
+        p_uarte->fifo[p_uarte->fifo_n++] = byte;
+        sim_uarte_fifo_drain(p_uarte);
+    }
+    else
+    {
+        p_uarte->overruns++;
+        errorsrc |= UARTE_ERRORSRC_OVERRUN_Msk;
+    }
+
+    if (errorsrc != 0)
+    {
+        sim_reg_write(&p_reg->ERRORSRC, p_reg->ERRORSRC | errorsrc);
+        sim_evt_raise(&p_reg->EVENTS_ERROR);
+    }
+}
+
+/*===========================================================================*/
+/* Transmitter.                                                              */
+/*===========================================================================*/
+
+static bool sim_uarte_cts_stop(sim_uarte_s *p_uarte)
+{
+    NRF_UARTE_Type *p_reg = p_uarte->p_reg;
+
+    return (p_reg->CONFIG & UARTE_CONFIG_HWFC_Msk) && (p_reg->PSEL.CTS != SIM_UARTE_PSEL_NC) &&
+           sim_gpio_level_get(p_reg->PSEL.CTS);
+}
+
+static void sim_uarte_tx_next(void *p_ctx, uint32_t gen)
+{
+    sim_uarte_s *p_uarte = p_ctx;
+    NRF_UARTE_Type *p_reg = p_uarte->p_reg;
+
+    if (!p_uarte->tx_active || (gen != p_uarte->tx_gen))
+    {
+        return;
+    }
+
+    /* Character on the line is finished. */
+    if (p_uarte->tx_cnt != 0)
+    {
+        if (p_uarte->tx_hook != NULL)
+        {
+            p_uarte->tx_hook(p_uarte->p_hook_ctx, p_uarte->p_tx[p_uarte->tx_cnt - 1]);
+        }
+        sim_evt_raise(&p_reg->EVENTS_TXDRDY);
+    }
+
+    if (p_uarte->tx_cnt == p_uarte->tx_max)
+    {
+        p_uarte->tx_active = false;
+        sim_reg_write(&p_reg->TXD.AMOUNT, p_uarte->tx_cnt);
+        sim_evt_raise(&p_reg->EVENTS_ENDTX);
+        return;
+    }
+
+    /* Next character waits for CTS, its edge continues. */
+    if (sim_uarte_cts_stop(p_uarte))
+    {
+        return;
+    }
+    p_uarte->tx_cnt++;
+    sim_at(sim_now() + sim_uarte_char_ns(p_uarte), sim_uarte_tx_next, p_uarte, p_uarte->tx_gen);
+}
+
+static void sim_uarte_cts_listener(void *p_ctx, uint32_t psel, bool level)
+{
+    sim_uarte_s *p_uarte = p_ctx;
+    NRF_UARTE_Type *p_reg = p_uarte->p_reg;
+
+    if (!sim_uarte_enabled(p_uarte) || (p_reg->PSEL.CTS != psel) ||
+        !(p_reg->CONFIG & UARTE_CONFIG_HWFC_Msk))
+    {
+        return;
+    }
+    sim_evt_raise(level ? &p_reg->EVENTS_NCTS : &p_reg->EVENTS_CTS);
+    if (!level && p_uarte->tx_active)
+    {
+        p_uarte->tx_gen++;
+        sim_uarte_tx_next(p_uarte, p_uarte->tx_gen);
+    }
+}
+
+/*===========================================================================*/
+/* Registers.                                                                */
+/*===========================================================================*/
+
+static void sim_uarte_task(void *p_ctx, uint32_t off)
+{
+    sim_uarte_s *p_uarte = p_ctx;
+    NRF_UARTE_Type *p_reg = p_uarte->p_reg;
+
+    if (!sim_uarte_enabled(p_uarte))
+    {
+        return;
+    }
+
+    if (off == offsetof(NRF_UARTE_Type, TASKS_STARTRX))
+    {
+        /* Driver must not start a buffer in progress. */
+        SIM_CHECK(!p_uarte->rx_active);
+        if (p_uarte->startrx_ns == 0)
+        {
+            sim_uarte_rx_start(p_uarte);
+            return;
+        }
+        p_uarte->rx_on = true;
+        p_uarte->rx_gen++;
+        sim_at(sim_now() + p_uarte->startrx_ns, sim_uarte_rx_started, p_uarte, p_uarte->rx_gen);
+    }
+    else if (off == offsetof(NRF_UARTE_Type, TASKS_STOPRX))
+    {
+        if (!p_uarte->rx_on)
+        {
+            return;
+        }
+        if (p_uarte->rx_active)
+        {
+            /* Short does not restart reception stopped by task. */
+            p_uarte->rx_active = false;
+            sim_reg_write(&p_reg->RXD.AMOUNT, p_uarte->rx_cnt);
+            sim_evt_raise(&p_reg->EVENTS_ENDRX);
+        }
+        p_uarte->rx_gen++;
+        sim_at(sim_now() + sim_uarte_char_ns(p_uarte), sim_uarte_rxto, p_uarte, p_uarte->rx_gen);
+    }
+    else if (off == offsetof(NRF_UARTE_Type, TASKS_FLUSHRX))
+    {
+        uint8_t *p_rx = SIM_PTR(p_reg->RXD.PTR);
+        uint32_t n = p_uarte->fifo_n < p_reg->RXD.MAXCNT ? p_uarte->fifo_n : p_reg->RXD.MAXCNT;
+
+        SIM_CHECK(!p_uarte->rx_active);
+        memcpy(p_rx, p_uarte->fifo, n);
+        memmove(p_uarte->fifo, p_uarte->fifo + n, p_uarte->fifo_n - n);
+        p_uarte->fifo_n -= n;
+        sim_reg_write(&p_reg->RXD.AMOUNT, n);
+        sim_evt_raise(&p_reg->EVENTS_ENDRX);
+    }
+    else if (off == offsetof(NRF_UARTE_Type, TASKS_STARTTX))
+    {
+        SIM_CHECK(!p_uarte->tx_active);
+        p_uarte->tx_active = true;
+        p_uarte->p_tx = SIM_PTR(p_reg->TXD.PTR);
+        p_uarte->tx_max = p_reg->TXD.MAXCNT;
+        p_uarte->tx_cnt = 0;
+        p_uarte->tx_gen++;
+        sim_evt_raise(&p_reg->EVENTS_TXSTARTED);
+        sim_uarte_tx_next(p_uarte, p_uarte->tx_gen);
+    }
+    else if (off == offsetof(NRF_UARTE_Type, TASKS_STOPTX))
+    {
+        if (p_uarte->tx_active)
+        {
+            p_uarte->tx_active = false;
+            p_uarte->tx_gen++;
+            sim_reg_write(&p_reg->TXD.AMOUNT, p_uarte->tx_cnt);
+            sim_evt_raise(&p_reg->EVENTS_ENDTX);
+        }
+        sim_evt_raise(&p_reg->EVENTS_TXSTOPPED);
+    }
+}
+
+static void sim_uarte_write(void *p_ctx, uint32_t off, uint32_t old, uint32_t val)
+{
+    sim_uarte_s *p_uarte = p_ctx;
+    NRF_UARTE_Type *p_reg = p_uarte->p_reg;
+
+    if (off == offsetof(NRF_UARTE_Type, ERRORSRC))
+    {
+        sim_reg_write(&p_reg->ERRORSRC, old & ~val);
+    }
+    else if ((off == offsetof(NRF_UARTE_Type, PSEL.CTS)) && (val != SIM_UARTE_PSEL_NC) &&
+             !p_uarte->cts_listen)
+    {
+        p_uarte->cts_listen = true;
+        sim_gpio_listen(val, sim_uarte_cts_listener, p_uarte);
+    }
+    else if ((off == offsetof(NRF_UARTE_Type, ENABLE)) && (val != UARTE_ENABLE_ENABLE_Enabled))
+    {
+        p_uarte->rx_on = false;
+        p_uarte->rx_active = false;
+        p_uarte->tx_active = false;
+        p_uarte->fifo_n = 0;
+        p_uarte->rx_gen++;
+        p_uarte->tx_gen++;
+    }
+}
+
+static const sim_periph_ops_s sim_uarte_ops = {
+    .task  = sim_uarte_task,
+    .write = sim_uarte_write,
+};
+
+sim_uarte_s *sim_uarte_add(NRF_UARTE_Type *p_reg)
+{
+    sim_uarte_s *p_uarte = NULL;
+
+    for (uint32_t i = 0; i < SIM_UARTE_COUNT; i++)
+    {
+        if ((sim_uartes[i].p_reg == NULL) || (sim_uartes[i].p_reg == p_reg))
+        {
+            p_uarte = &sim_uartes[i];
+            break;
+        }
+    }
+    SIM_CHECK(p_uarte != NULL);
+
+    memset(p_uarte, 0, sizeof(*p_uarte));
+    p_uarte->p_reg = p_reg;
+    sim_reg_write(&p_reg->PSEL.RTS, SIM_UARTE_PSEL_NC);
+    sim_reg_write(&p_reg->PSEL.TXD, SIM_UARTE_PSEL_NC);
+    sim_reg_write(&p_reg->PSEL.CTS, SIM_UARTE_PSEL_NC);
+    sim_reg_write(&p_reg->PSEL.RXD, SIM_UARTE_PSEL_NC);
+    sim_reg_write(&p_reg->BAUDRATE, UARTE_BAUDRATE_BAUDRATE_Baud9600);
+    sim_periph_add((uint32_t)(uintptr_t)p_reg, &sim_uarte_ops, p_uarte);
+    return p_uarte;
+}
@@ -0,0 +1,89 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIM_UARTE_H
+#define SIM_UARTE_H
+
+/* UARTE model. Character time follows BAUDRATE and CONFIG.PARITY.
+ *
+ * Receiver: bytes given by the test are stored by EasyDMA while RX buffer is active,
+ * otherwise in 4-byte FIFO, where the next one is an overrun error. ENDRX_STARTRX short
+ * starts the next buffer with RXD.PTR and RXD.MAXCNT current at ENDRX, FIFO content goes
+ * to it first. Buffer started by STARTRX task is latched after startrx_ns, receiver
+ * startup time set by test, bytes received meanwhile wait in FIFO. STOPRX ends the buffer
+ * in progress and generates RXTO one character later, FLUSHRX moves FIFO to RX buffer at
+ * once. ERRORSRC is write one to clear.
+ *
+ * Transmitter sends bytes one character apart. With CONFIG.HWFC and CTS pin connected it
+ * pauses while CTS is high and generates CTS and NCTS events on its edges. RTS is not
+ * driven. */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "nodi_common.h"
+
+#define SIM_UARTE_FIFO_LEN    4
+
+typedef struct sim_uarte sim_uarte_s;
+
+typedef void (*sim_uarte_tx_hook_t)(void *p_ctx, uint8_t byte);
+
+struct sim_uarte {
+    NRF_UARTE_Type           *p_reg;
+
+    /* Receiver. */
+    bool                      rx_on;       // Started, RXTO not generated yet
+    bool                      rx_active;   // RX buffer latched
+    uint8_t                  *p_rx;
+    uint32_t                  rx_max;
+    uint32_t                  rx_cnt;
+    uint8_t                   fifo[SIM_UARTE_FIFO_LEN];
+    uint32_t                  fifo_n;
+    uint32_t                  rx_gen;
+    uint64_t                  startrx_ns;  // STARTRX task to RXSTARTED, 0 by default
+
+    /* Transmitter. */
+    bool                      tx_active;
+    const uint8_t            *p_tx;
+    uint32_t                  tx_max;
+    uint32_t                  tx_cnt;
+    uint32_t                  tx_gen;
+    bool                      cts_listen;
+    sim_uarte_tx_hook_t       tx_hook;
+    void                     *p_hook_ctx;
+
+    uint64_t                  rx_bytes;    // Bytes stored by EasyDMA
+    uint32_t                  overruns;    // Bytes lost on full FIFO
+    uint32_t                  rx_off;      // Bytes lost with receiver stopped
+};
+
+sim_uarte_s *sim_uarte_add(NRF_UARTE_Type *p_reg);
+
+/* Time of one character at current BAUDRATE and CONFIG. */
+uint64_t sim_uarte_char_ns(sim_uarte_s *p_uarte);
+
+/* Character fully received now. errorsrc is ERRORSRC bits detected with it or 0. */
+void sim_uarte_rx_byte(sim_uarte_s *p_uarte, uint8_t byte, uint32_t errorsrc);
+
+#endif // SIM_UARTE_H
@@ -0,0 +1,192 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+#include "sim.h"
+#include "sim_w25q.h"
+
+#define SIM_W25Q_CMD_WREN     0x06
+#define SIM_W25Q_CMD_RDSR     0x05
+#define SIM_W25Q_CMD_READ     0x03
+#define SIM_W25Q_CMD_PP       0x02
+#define SIM_W25Q_CMD_SE       0x20
+
+#define SIM_W25Q_SR_WIP       0x01
+#define SIM_W25Q_SR_WEL       0x02
+
+#define SIM_W25Q_ADDR_LEN     3
+
+static bool sim_w25q_busy(sim_w25q_s *p_flash)
+{
+    return sim_now() < p_flash->busy_until;
+}
+
+static bool sim_w25q_cmd_addressed(uint8_t cmd)
+{
+    return (cmd == SIM_W25Q_CMD_READ) || (cmd == SIM_W25Q_CMD_PP) || (cmd == SIM_W25Q_CMD_SE);
+}
+
+/* Command takes effect when CS goes high. */
+static void sim_w25q_frame_end(sim_w25q_s *p_flash)
+{
+    sim_w25q_frame_s *p_frame = &p_flash->frame;
+    uint32_t base;
+
+    if (p_flash->pos == 0)
+    {
+        return;
+    }
+    p_frame->t = sim_now();
+    if (p_flash->frames_n < SIM_W25Q_FRAMES_MAX)
+    {
+        p_flash->frames[p_flash->frames_n++] = *p_frame;
+    }
+    if (p_frame->busy)
+    {
+        if (p_frame->cmd != SIM_W25Q_CMD_RDSR)
+        {
+            p_flash->ignored++;
+        }
+        return;
+    }
+
+    switch (p_frame->cmd)
+    {
+    case SIM_W25Q_CMD_WREN:
+        p_flash->wel = true;
+        break;
+    case SIM_W25Q_CMD_PP:
+        if (!p_flash->wel || (p_flash->pos < 1 + SIM_W25Q_ADDR_LEN))
+        {
+            p_flash->ignored++;
+            break;
+        }
+        if ((p_frame->addr % SIM_W25Q_PAGE) + p_frame->n > SIM_W25Q_PAGE)
+        {
+            p_flash->page_wraps++;
+        }
+        /* Programming only clears bits. */
+        base = p_frame->addr & ~(SIM_W25Q_PAGE - 1);
+        for (uint32_t i = 0; i < SIM_W25Q_PAGE; i++)
+        {
+            p_flash->mem[base + i] &= p_flash->page[i];
+        }
+        p_flash->wel = false;
+        p_flash->busy_until = sim_now() + p_flash->t_pp_ns;
+        break;
+    case SIM_W25Q_CMD_SE:
+        if (!p_flash->wel || (p_flash->pos != 1 + SIM_W25Q_ADDR_LEN))
+        {
+            p_flash->ignored++;
+            break;
+        }
+        memset(&p_flash->mem[p_frame->addr & ~(SIM_W25Q_SECTOR - 1)], 0xFF, SIM_W25Q_SECTOR);
+        p_flash->wel = false;
+        p_flash->busy_until = sim_now() + p_flash->t_se_ns;
+        break;
+    default:
+        break;
+    }
+}
+
+static void sim_w25q_cs(sim_spi_dev_s *p_dev, bool selected)
+{
+    sim_w25q_s *p_flash = (sim_w25q_s *)p_dev;
+
+    if (!selected)
+    {
+        sim_w25q_frame_end(p_flash);
+        return;
+    }
+    p_flash->pos = 0;
+    memset(&p_flash->frame, 0, sizeof(p_flash->frame));
+    memset(p_flash->page, 0xFF, sizeof(p_flash->page));
+    p_flash->frame.busy = sim_w25q_busy(p_flash);
+}
+
+static uint8_t sim_w25q_xfer(sim_spi_dev_s *p_dev, uint8_t mosi)
+{
+    sim_w25q_s *p_flash = (sim_w25q_s *)p_dev;
+    sim_w25q_frame_s *p_frame = &p_flash->frame;
+    uint32_t pos = p_flash->pos++;
+    uint8_t miso = 0xFF;
+
+    if (pos == 0)
+    {
+        p_frame->cmd = mosi;
+        return miso;
+    }
+
+    if (p_frame->cmd == SIM_W25Q_CMD_RDSR)
+    {
+        /* Status is output continuously and follows WIP. */
+        p_frame->n++;
+        miso = (sim_w25q_busy(p_flash) ? SIM_W25Q_SR_WIP : 0) | (p_flash->wel ? SIM_W25Q_SR_WEL : 0);
+        if (miso & SIM_W25Q_SR_WIP)
+        {
+            p_flash->busy_polls += (p_frame->n == 1);
+        }
+        return miso;
+    }
+
+    if (p_frame->busy || !sim_w25q_cmd_addressed(p_frame->cmd))
+    {
+        return miso;
+    }
+
+    if (pos <= SIM_W25Q_ADDR_LEN)
+    {
+        p_frame->addr = ((p_frame->addr << 8) | mosi) % SIM_W25Q_SIZE;
+        return miso;
+    }
+
+    if (p_frame->cmd == SIM_W25Q_CMD_READ)
+    {
+        miso = p_flash->mem[(p_frame->addr + p_frame->n) % SIM_W25Q_SIZE];
+    }
+    else if (p_frame->cmd == SIM_W25Q_CMD_PP)
+    {
+        /* Address counter wraps to the start of the page. */
+        p_flash->page[(p_frame->addr + p_frame->n) % SIM_W25Q_PAGE] = mosi;
+    }
+    p_frame->n++;
+    return miso;
+}
+
+void sim_w25q_attach(sim_w25q_s *p_flash, sim_spim_s *p_spim, uint32_t cs_psel)
+{
+    memset(&p_flash->dev, 0, sizeof(p_flash->dev));
+    p_flash->dev.cs_psel = cs_psel;
+    p_flash->dev.cs_cb = sim_w25q_cs;
+    p_flash->dev.xfer_cb = sim_w25q_xfer;
+    p_flash->busy_until = 0;
+    p_flash->wel = false;
+    p_flash->pos = 0;
+    p_flash->frames_n = 0;
+    p_flash->page_wraps = 0;
+    p_flash->ignored = 0;
+    p_flash->busy_polls = 0;
+    memset(p_flash->mem, 0xFF, sizeof(p_flash->mem));
+    sim_spim_dev_attach(p_spim, &p_flash->dev);
+}
@@ -0,0 +1,77 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIM_W25Q_H
+#define SIM_W25Q_H
+
+/* W25Q serial NOR flash on simulated SPI bus. Supports WREN, RDSR, READ, PP and SE.
+ *
+ * Page program latches data in a page buffer with address wrapping inside the 256-byte
+ * page, like the real part does, and programs it when CS goes high. Program and erase
+ * keep WIP set for t_pp_ns / t_se_ns after CS goes high. Commands other than RDSR sent
+ * while busy, and PP or SE sent without WEL, are ignored and counted. */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sim_spim.h"
+
+#define SIM_W25Q_SIZE         (1024 * 1024)
+#define SIM_W25Q_PAGE         256
+#define SIM_W25Q_SECTOR       4096
+
+#define SIM_W25Q_FRAMES_MAX   4096
+
+/* CS frame seen by the flash. */
+typedef struct {
+    uint64_t                  t;        // CS high
+    uint8_t                   cmd;
+    uint32_t                  addr;
+    uint32_t                  n;        // Bytes after command and address
+    bool                      busy;     // Flash was busy when frame started
+} sim_w25q_frame_s;
+
+typedef struct {
+    sim_spi_dev_s             dev;
+    uint8_t                   mem[SIM_W25Q_SIZE];
+    uint64_t                  t_pp_ns;
+    uint64_t                  t_se_ns;
+    uint64_t                  busy_until;
+    bool                      wel;
+
+    /* Frame in progress. */
+    uint32_t                  pos;
+    sim_w25q_frame_s          frame;
+    uint8_t                   page[SIM_W25Q_PAGE];
+
+    sim_w25q_frame_s          frames[SIM_W25Q_FRAMES_MAX];
+    uint32_t                  frames_n;
+    uint32_t                  page_wraps;     // PP frames wrapping inside the page
+    uint32_t                  ignored;        // Commands ignored while busy or without WEL
+    uint32_t                  busy_polls;     // RDSR frames returning WIP
+} sim_w25q_s;
+
+/* Attaches erased flash to the bus. Timings are set by the test. */
+void sim_w25q_attach(sim_w25q_s *p_flash, sim_spim_s *p_spim, uint32_t cs_psel);
+
+#endif // SIM_W25Q_H
@@ -0,0 +1,325 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/* SPI NOR driver against simulated W25Q flash sharing SPIM queue, with status polls
+ * timed by simulated RTC. Checks page splitting of programs, read cache and status poll
+ * rescheduling, then reports sustained program throughput and read latency. */
+
+#include <stdio.h>
+#include <string.h>
+#include "nodi_spi_nor.h"
+#include "sim.h"
+#include "sim_gpio.h"
+#include "sim_rtc.h"
+#include "sim_spim.h"
+#include "sim_w25q.h"
+
+#define TEST_CS_PIN           4
+#define TEST_RTC_CC           1
+#define TEST_PROGRAM_US       500
+#define TEST_ERASE_US         40000
+#define TEST_T_PP_US          800
+#define TEST_T_SE_US          45000
+#define TEST_BULK_LEN         (64 * 1024)
+
+static const nodi_spim_config_s test_spim_cfg = {
+    .sck_pin   = NODI_GPIO_PIN(NODI_GPIO_P0, 1),
+    .mosi_pin  = NODI_GPIO_PIN(NODI_GPIO_P0, 2),
+    .miso_pin  = NODI_GPIO_PIN(NODI_GPIO_P0, 3),
+    .frequency = NODI_SPIM_FREQ_8M,
+    .mode      = NODI_SPIM_MODE_0,
+    .bit_order = NODI_SPIM_BIT_ORDER_MSB_FIRST,
+    .orc       = 0xFF,
+};
+
+static const nodi_spim_dev_s test_flash_dev = {
+    .cs_pin    = NODI_GPIO_PIN(NODI_GPIO_P0, TEST_CS_PIN),
+    .frequency = NODI_SPIM_FREQ_8M,
+    .mode      = NODI_SPIM_MODE_0,
+    .bit_order = NODI_SPIM_BIT_ORDER_MSB_FIRST,
+    .orc       = 0xFF,
+};
+
+static void test_rtc_cb(nodi_rtc_drv_t *p_rtc_drv, nodi_rtc_cb_evt_t evt);
+static void test_op_cb(nodi_spi_nor_t *p_nor);
+
+static const nodi_rtc_config_s test_rtc_cfg = {
+    .evt_cb    = test_rtc_cb,
+    .prescaler = 0,
+};
+
+static const nodi_spi_nor_config_s test_nor_cfg = {
+    .p_spim_drv = &NODI_SPIM0,
+    .p_dev      = &test_flash_dev,
+    .op_cb      = test_op_cb,
+    .p_rtc_drv  = &NODI_RTC0,
+    .rtc_cc     = TEST_RTC_CC,
+    .program_us = TEST_PROGRAM_US,
+    .erase_us   = TEST_ERASE_US,
+};
+
+static sim_w25q_s test_flash;
+static sim_rtc_s *p_test_rtc;
+static nodi_spi_nor_t test_nor;
+
+static uint32_t test_op_done;
+static uint64_t test_op_t;
+
+static uint8_t test_data[TEST_BULK_LEN];
+static uint8_t test_rd[TEST_BULK_LEN];
+
+static void test_rtc_cb(nodi_rtc_drv_t *p_rtc_drv, nodi_rtc_cb_evt_t evt)
+{
+    SIM_CHECK(evt == NODI_RTC_DRV_CB_EVT_COMP0 + TEST_RTC_CC);
+    nodi_spi_nor_rtc_handle(&test_nor);
+}
+
+static void test_op_cb(nodi_spi_nor_t *p_nor)
+{
+    SIM_CHECK(p_nor == &test_nor);
+    SIM_CHECK(p_nor->state == NODI_SPI_NOR_STATE_READY);
+    test_op_done++;
+    test_op_t = sim_now();
+}
+
+static void test_setup(void)
+{
+    sim_spim_s *p_bus;
+
+    sim_init();
+    p_bus = sim_spim_add(NRF_SPIM0);
+    p_test_rtc = sim_rtc_add(NRF_RTC0);
+
+    /* Application configures GPIO, CS is inactive before it becomes output. */
+    nodi_gpio_set(test_flash_dev.cs_pin.p_port, test_flash_dev.cs_pin.pin);
+    nodi_gpio_config(test_flash_dev.cs_pin.p_port, test_flash_dev.cs_pin.pin, NODI_GPIO_CFG_SPI_CS);
+
+    sim_w25q_attach(&test_flash, p_bus, TEST_CS_PIN);
+    test_flash.t_pp_ns = SIM_US(TEST_T_PP_US);
+    test_flash.t_se_ns = SIM_US(TEST_T_SE_US);
+
+    nodi_spim_prepare();
+    NODI_SPIM0.config = &test_spim_cfg;
+    nodi_spim_init(&NODI_SPIM0);
+
+    nodi_rtc_prepare();
+    NODI_RTC0.config = &test_rtc_cfg;
+    nodi_rtc_init(&NODI_RTC0);
+    nodi_rtc_start(&NODI_RTC0);
+
+    nodi_spi_nor_init(&test_nor, &test_nor_cfg);
+    test_op_done = 0;
+}
+
+/* Runs until the operation completes and the bus is idle. */
+static void test_op_wait(uint32_t done)
+{
+    sim_run(SIM_FOREVER);
+    SIM_CHECK(test_op_done == done);
+    SIM_CHECK(test_nor.state == NODI_SPI_NOR_STATE_READY);
+    SIM_CHECK(nodi_spim_queue_busy_check(&NODI_SPIM0) == 0);
+    SIM_CHECK(test_flash.ignored == 0);
+    SIM_CHECK(test_flash.page_wraps == 0);
+}
+
+static void test_pattern(uint8_t *p_buf, uint32_t len, uint32_t seed)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        p_buf[i] = (uint8_t)((i * 7) ^ (i >> 8) ^ seed);
+    }
+}
+
+/* Expected interval of RTC timed poll, counted from CS high of the previous frame. */
+static void test_poll_delay_check(uint64_t delay, uint32_t us)
+{
+    uint64_t tick_ns = sim_rtc_tick_ns(p_test_rtc);
+    uint64_t ticks = (uint64_t)us * 32768 / 1000000;
+
+    ticks = ticks < 2 ? 2 : ticks;
+    /* CC is set within current tick and status frame takes a few bytes. */
+    SIM_CHECK(delay + tick_ns >= ticks * tick_ns);
+    SIM_CHECK(delay <= ticks * tick_ns + tick_ns + SIM_US(10));
+}
+
+/* Unaligned program is split at page boundaries, every page needs WREN and waits for WIP
+ * by polls rescheduled at program_us / 4. */
+static void test_program_split(void)
+{
+    static const uint32_t lens[] = { 16, 256, 256, 256, 216 };
+    const uint32_t addr = 0x1F0;
+    const uint32_t len = 1000;
+    uint32_t pages = 0;
+    uint32_t polls = 0;
+
+    test_setup();
+    nodi_spi_nor_sector_erase(&test_nor, addr);
+    test_op_wait(1);
+    test_flash.frames_n = 0;
+    test_flash.busy_polls = 0;
+
+    test_pattern(test_data, len, 0x5A);
+    nodi_spi_nor_program(&test_nor, addr, test_data, len);
+    test_op_wait(2);
+
+    SIM_CHECK(memcmp(&test_flash.mem[addr], test_data, len) == 0);
+    SIM_CHECK(test_flash.mem[addr - 1] == 0xFF);
+    SIM_CHECK(test_flash.mem[addr + len] == 0xFF);
+
+    for (uint32_t i = 0; i < test_flash.frames_n; i++)
+    {
+        const sim_w25q_frame_s *p_frame = &test_flash.frames[i];
+        if (p_frame->cmd != 0x02)
+        {
+            continue;
+        }
+        SIM_CHECK(pages < sizeof(lens) / sizeof(lens[0]));
+        SIM_CHECK(p_frame->n == lens[pages]);
+        SIM_CHECK((p_frame->addr % SIM_W25Q_PAGE) + p_frame->n <= SIM_W25Q_PAGE);
+        SIM_CHECK((i > 0) && (test_flash.frames[i - 1].cmd == 0x06));
+        pages++;
+
+        /* First poll after program_us, then every program_us / 4 while busy. */
+        SIM_CHECK(test_flash.frames[i + 1].cmd == 0x05);
+        test_poll_delay_check(test_flash.frames[i + 1].t - p_frame->t, TEST_PROGRAM_US);
+        for (uint32_t j = i + 2; (j < test_flash.frames_n) && (test_flash.frames[j].cmd == 0x05); j++)
+        {
+            test_poll_delay_check(test_flash.frames[j].t - test_flash.frames[j - 1].t,
+                                  TEST_PROGRAM_US / 4);
+            SIM_CHECK(test_flash.frames[j - 1].t < p_frame->t + test_flash.t_pp_ns);
+            polls++;
+        }
+    }
+    SIM_CHECK(pages == sizeof(lens) / sizeof(lens[0]));
+    SIM_CHECK(polls > 0);
+    SIM_CHECK(polls == test_flash.busy_polls);
+    SIM_CHECK(nodi_spi_nor_stats_get(&test_nor)->status_polls == test_flash.busy_polls + 1);
+    SIM_CHECK(nodi_spi_nor_stats_get(&test_nor)->pages_programmed == pages);
+}
+
+static uint64_t test_read_miss_ns;
+
+/* Short reads load the cache and following reads inside it complete at once. */
+static void test_read_cache(void)
+{
+    const nodi_spi_nor_stats_s *p_stats;
+    const uint32_t addr = 0x3000;
+    static uint8_t buf[16];
+    uint64_t t;
+
+    test_setup();
+    p_stats = nodi_spi_nor_stats_get(&test_nor);
+    test_pattern(&test_flash.mem[addr], SIM_W25Q_SECTOR, 0xC3);
+
+    t = sim_now();
+    nodi_spi_nor_read(&test_nor, addr, buf, sizeof(buf));
+    SIM_CHECK(test_op_done == 0);
+    test_op_wait(1);
+    test_read_miss_ns = test_op_t - t;
+    SIM_CHECK(memcmp(buf, &test_flash.mem[addr], sizeof(buf)) == 0);
+    SIM_CHECK(test_flash.frames_n == 1);
+    SIM_CHECK(test_flash.frames[0].cmd == 0x03);
+    SIM_CHECK(test_flash.frames[0].n == NODI_SPI_NOR_CACHE_SIZE);
+    SIM_CHECK((p_stats->cache_misses == 1) && (p_stats->cache_hits == 0));
+
+    /* Sequential reads inside the cache call op_cb before returning. */
+    nodi_spi_nor_read(&test_nor, addr + 16, buf, sizeof(buf));
+    SIM_CHECK(test_op_done == 2);
+    SIM_CHECK(memcmp(buf, &test_flash.mem[addr + 16], sizeof(buf)) == 0);
+    nodi_spi_nor_read(&test_nor, addr + NODI_SPI_NOR_CACHE_SIZE - 8, buf, 8);
+    SIM_CHECK(test_op_done == 3);
+    SIM_CHECK(memcmp(buf, &test_flash.mem[addr + NODI_SPI_NOR_CACHE_SIZE - 8], 8) == 0);
+    SIM_CHECK(p_stats->cache_hits == 2);
+    SIM_CHECK(test_flash.frames_n == 1);
+
+    /* Read crossing the end of the cache reloads it. */
+    nodi_spi_nor_read(&test_nor, addr + NODI_SPI_NOR_CACHE_SIZE - 4, buf, 8);
+    test_op_wait(4);
+    SIM_CHECK(memcmp(buf, &test_flash.mem[addr + NODI_SPI_NOR_CACHE_SIZE - 4], 8) == 0);
+    SIM_CHECK((p_stats->cache_misses == 2) && (p_stats->cache_hits == 2));
+    SIM_CHECK(test_flash.frames_n == 2);
+
+    /* Long read bypasses the cache in frames of NODI_SPI_NOR_FRAME_MAX. */
+    nodi_spi_nor_read(&test_nor, addr + 100, test_rd, 1200);
+    test_op_wait(5);
+    SIM_CHECK(memcmp(test_rd, &test_flash.mem[addr + 100], 1200) == 0);
+    SIM_CHECK(test_flash.frames_n == 5);
+    SIM_CHECK(test_flash.frames[2].n == NODI_SPI_NOR_FRAME_MAX);
+    SIM_CHECK(test_flash.frames[3].n == NODI_SPI_NOR_FRAME_MAX);
+    SIM_CHECK(test_flash.frames[4].n == 1200 - 2 * NODI_SPI_NOR_FRAME_MAX);
+    SIM_CHECK(test_flash.frames[4].addr == addr + 100 + 2 * NODI_SPI_NOR_FRAME_MAX);
+    SIM_CHECK(p_stats->cache_misses == 2);
+    nodi_spi_nor_read(&test_nor, addr + NODI_SPI_NOR_CACHE_SIZE, buf, 4);
+    SIM_CHECK(test_op_done == 6);
+
+    /* Program invalidates the cache. */
+    memset(buf, 0x00, sizeof(buf));
+    nodi_spi_nor_program(&test_nor, addr + NODI_SPI_NOR_CACHE_SIZE, buf, 4);
+    test_op_wait(7);
+    nodi_spi_nor_read(&test_nor, addr + NODI_SPI_NOR_CACHE_SIZE, buf, 4);
+    SIM_CHECK(test_op_done == 7);
+    test_op_wait(8);
+    SIM_CHECK(memcmp(buf, "\0\0\0\0", 4) == 0);
+    SIM_CHECK((p_stats->cache_misses == 3) && (p_stats->cache_hits == 3));
+}
+
+static uint64_t test_bulk_ns;
+
+/* Sustained program of many pages with random interrupt latency, read back by driver. */
+static void test_bulk(void)
+{
+    uint64_t t;
+
+    test_setup();
+    sim_irq_latency_max_ns = 2000;
+    for (uint32_t addr = 0; addr < TEST_BULK_LEN; addr += SIM_W25Q_SECTOR)
+    {
+        nodi_spi_nor_sector_erase(&test_nor, addr);
+        test_op_wait(addr / SIM_W25Q_SECTOR + 1);
+    }
+    test_op_done = 0;
+
+    test_pattern(test_data, TEST_BULK_LEN, 0x11);
+    t = sim_now();
+    nodi_spi_nor_program(&test_nor, 0, test_data, TEST_BULK_LEN);
+    test_op_wait(1);
+    test_bulk_ns = test_op_t - t;
+    SIM_CHECK(nodi_spi_nor_stats_get(&test_nor)->pages_programmed == TEST_BULK_LEN / SIM_W25Q_PAGE);
+
+    nodi_spi_nor_read(&test_nor, 0, test_rd, TEST_BULK_LEN);
+    test_op_wait(2);
+    SIM_CHECK(memcmp(test_rd, test_data, TEST_BULK_LEN) == 0);
+    SIM_CHECK(memcmp(test_flash.mem, test_data, TEST_BULK_LEN) == 0);
+}
+
+int main(void)
+{
+    test_program_split();
+    test_read_cache();
+    test_bulk();
+    printf("spi_nor: program %u B at %.3f MB/s (tPP %u us), read miss latency %.1f us, "
+           "cache hit 0 us\n", TEST_BULK_LEN, (double)TEST_BULK_LEN * 1000.0 / (double)test_bulk_ns,
+           TEST_T_PP_US, (double)test_read_miss_ns / 1000.0);
+    return 0;
+}
@@ -0,0 +1,248 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/* Latency of urgent lane behind a long normal lane transaction. Urgent transaction is
+ * pushed during every chunk of the normal one. Preemptible transaction lets it in at the
+ * next chunk boundary, other transaction only at its end. */
+
+#include <stdio.h>
+#include <string.h>
+#include "nodi_spim.h"
+#include "sim.h"
+#include "sim_gpio.h"
+#include "sim_spim.h"
+
+#define TEST_CS_A_PIN         4
+#define TEST_CS_B_PIN         5
+#define TEST_LONG_LEN         (20 * NODI_SPIM_MAXCNT + 100)
+#define TEST_LONG_CHUNKS      ((TEST_LONG_LEN + NODI_SPIM_MAXCNT - 1) / NODI_SPIM_MAXCNT)
+#define TEST_URGENT_LEN       4
+#define TEST_LATENCY_NS       2000
+
+static const nodi_gpio_pin_t test_cs_a = NODI_GPIO_PIN(NODI_GPIO_P0, TEST_CS_A_PIN);
+static const nodi_gpio_pin_t test_cs_b = NODI_GPIO_PIN(NODI_GPIO_P0, TEST_CS_B_PIN);
+
+static const nodi_spim_config_s test_spim_cfg = {
+    .sck_pin   = NODI_GPIO_PIN(NODI_GPIO_P0, 1),
+    .mosi_pin  = NODI_GPIO_PIN(NODI_GPIO_P0, 2),
+    .miso_pin  = NODI_GPIO_PIN(NODI_GPIO_P0, 3),
+    .frequency = NODI_SPIM_FREQ_8M,
+    .mode      = NODI_SPIM_MODE_0,
+    .bit_order = NODI_SPIM_BIT_ORDER_MSB_FIRST,
+    .orc       = 0xFF,
+};
+
+typedef struct {
+    sim_spi_dev_s             dev;
+    uint8_t                   mosi[TEST_LONG_LEN + TEST_LONG_CHUNKS * TEST_URGENT_LEN];
+    uint32_t                  mosi_n;
+    uint32_t                  frames;
+} test_dev_s;
+
+static test_dev_s test_dev_a;
+static test_dev_s test_dev_b;
+static sim_spim_s *p_test_bus;
+
+static nodi_spim_xfer_desc_t test_long;
+static uint8_t test_long_tx[TEST_LONG_LEN];
+static nodi_spim_xfer_desc_t test_urgent[TEST_LONG_CHUNKS];
+static uint8_t test_urgent_tx[TEST_LONG_CHUNKS][TEST_URGENT_LEN];
+
+static uint32_t test_pushed;
+static uint64_t test_push_t[TEST_LONG_CHUNKS];
+static uint32_t test_started;
+static uint64_t test_start_t[TEST_LONG_CHUNKS];
+static uint32_t test_long_chunks;
+static uint64_t test_long_end_t;
+static uint32_t test_done;
+
+static uint8_t test_dev_xfer(sim_spi_dev_s *p_dev, uint8_t mosi)
+{
+    test_dev_s *p_test_dev = (test_dev_s *)p_dev;
+
+    SIM_CHECK(p_test_dev->mosi_n < sizeof(p_test_dev->mosi));
+    p_test_dev->mosi[p_test_dev->mosi_n++] = mosi;
+    return mosi;
+}
+
+static void test_dev_cs(sim_spi_dev_s *p_dev, bool selected)
+{
+    ((test_dev_s *)p_dev)->frames += selected;
+}
+
+static void test_urgent_push(void *p_ctx, uint32_t arg)
+{
+    test_push_t[arg] = sim_now();
+    test_pushed++;
+    nodi_spim_queue_push(&NODI_SPIM0, &test_urgent[arg]);
+}
+
+/* Every chunk of long transaction gets urgent push at random moment of the next one. */
+static void test_chunk_hook(void *p_ctx, const sim_spim_xfer_s *p_xfer)
+{
+    uint32_t n = p_xfer->n_tx > p_xfer->n_rx ? p_xfer->n_tx : p_xfer->n_rx;
+    uint64_t chunk_ns = NODI_SPIM_MAXCNT * sim_spim_byte_ns(NODI_SPIM_FREQ_8M);
+
+    SIM_CHECK(p_xfer->selected == 1);
+    if (p_xfer->p_dev == &test_dev_b.dev)
+    {
+        SIM_CHECK(n == TEST_URGENT_LEN);
+        test_start_t[test_started++] = p_xfer->t_start;
+        return;
+    }
+
+    test_long_chunks++;
+    if (test_long_chunks == TEST_LONG_CHUNKS)
+    {
+        test_long_end_t = p_xfer->t_end;
+    }
+    else if (test_long_chunks < TEST_LONG_CHUNKS - 1)
+    {
+        sim_at(sim_now() + sim_rand() % chunk_ns, test_urgent_push, NULL, test_long_chunks - 1);
+    }
+}
+
+static void test_xfer_cb(nodi_spim_drv_t *p_spim_drv, nodi_spim_xfer_desc_t *p_desc)
+{
+    test_done++;
+}
+
+static void test_setup(bool preemptible)
+{
+    static const nodi_gpio_pin_t *cs_pins[] = { &test_cs_a, &test_cs_b };
+
+    sim_init();
+    sim_seed(preemptible ? 0x13 : 0x31);
+    sim_irq_latency_max_ns = TEST_LATENCY_NS;
+    p_test_bus = sim_spim_add(NRF_SPIM0);
+    p_test_bus->xfer_hook = test_chunk_hook;
+
+    /* Application configures GPIO, CS is inactive before it becomes output. */
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        nodi_gpio_set(cs_pins[i]->p_port, cs_pins[i]->pin);
+        nodi_gpio_config(cs_pins[i]->p_port, cs_pins[i]->pin, NODI_GPIO_CFG_SPI_CS);
+    }
+
+    memset(&test_dev_a, 0, sizeof(test_dev_a));
+    memset(&test_dev_b, 0, sizeof(test_dev_b));
+    test_dev_a.dev = (sim_spi_dev_s){ .cs_psel = TEST_CS_A_PIN, .cs_cb = test_dev_cs,
+                                      .xfer_cb = test_dev_xfer };
+    test_dev_b.dev = (sim_spi_dev_s){ .cs_psel = TEST_CS_B_PIN, .cs_cb = test_dev_cs,
+                                      .xfer_cb = test_dev_xfer };
+    sim_spim_dev_attach(p_test_bus, &test_dev_a.dev);
+    sim_spim_dev_attach(p_test_bus, &test_dev_b.dev);
+
+    nodi_spim_prepare();
+    NODI_SPIM0.config = &test_spim_cfg;
+    nodi_spim_init(&NODI_SPIM0);
+
+    memset(&test_long, 0, sizeof(test_long));
+    for (uint32_t i = 0; i < TEST_LONG_LEN; i++)
+    {
+        test_long_tx[i] = (uint8_t)(i ^ (i >> 8));
+    }
+    test_long.p_txbuf = test_long_tx;
+    test_long.n_tx = TEST_LONG_LEN;
+    test_long.p_cs_pin = &test_cs_a;
+    test_long.lane = NODI_SPIM_LANE_NORMAL;
+    test_long.preemptible = preemptible;
+    test_long.xfer_cb = test_xfer_cb;
+
+    memset(test_urgent, 0, sizeof(test_urgent));
+    for (uint32_t i = 0; i < TEST_LONG_CHUNKS; i++)
+    {
+        memset(test_urgent_tx[i], 0xA0 + i, TEST_URGENT_LEN);
+        test_urgent[i].p_txbuf = test_urgent_tx[i];
+        test_urgent[i].n_tx = TEST_URGENT_LEN;
+        test_urgent[i].p_cs_pin = &test_cs_b;
+        test_urgent[i].lane = NODI_SPIM_LANE_URGENT;
+        test_urgent[i].xfer_cb = test_xfer_cb;
+    }
+
+    test_pushed = 0;
+    test_started = 0;
+    test_long_chunks = 0;
+    test_long_end_t = 0;
+    test_done = 0;
+}
+
+/* Returns the worst wait of urgent transaction from push to its start. */
+static uint64_t test_run(bool preemptible)
+{
+    uint64_t chunk_ns = NODI_SPIM_MAXCNT * sim_spim_byte_ns(NODI_SPIM_FREQ_8M);
+    uint64_t wait_max = 0;
+
+    test_setup(preemptible);
+    nodi_spim_queue_push(&NODI_SPIM0, &test_long);
+    sim_run(SIM_FOREVER);
+
+    SIM_CHECK(test_pushed == TEST_LONG_CHUNKS - 2);
+    SIM_CHECK(test_started == test_pushed);
+    SIM_CHECK(test_done == test_pushed + 1);
+    SIM_CHECK(test_long_chunks == TEST_LONG_CHUNKS);
+    SIM_CHECK(nodi_spim_queue_busy_check(&NODI_SPIM0) == 0);
+    SIM_CHECK(p_test_bus->conflicts == 0);
+
+    /* Long transaction is intact whether it was preempted or not. */
+    SIM_CHECK(test_dev_a.mosi_n == TEST_LONG_LEN);
+    SIM_CHECK(memcmp(test_dev_a.mosi, test_long_tx, TEST_LONG_LEN) == 0);
+    SIM_CHECK(test_dev_b.frames == test_pushed);
+
+    for (uint32_t i = 0; i < test_pushed; i++)
+    {
+        uint64_t wait = test_start_t[i] - test_push_t[i];
+        SIM_CHECK(test_start_t[i] >= test_push_t[i]);
+        SIM_CHECK(memcmp(&test_dev_b.mosi[i * TEST_URGENT_LEN], test_urgent_tx[i], TEST_URGENT_LEN) == 0);
+        if (preemptible)
+        {
+            /* Rest of chunk in progress plus interrupt latency. */
+            SIM_CHECK(wait <= chunk_ns + TEST_LATENCY_NS);
+            SIM_CHECK(test_start_t[i] < test_long_end_t);
+        }
+        else
+        {
+            /* Waits for the end of transaction, then urgent ones go back to back. */
+            SIM_CHECK(test_start_t[i] >= test_long_end_t);
+            SIM_CHECK(test_start_t[i] <= test_long_end_t + TEST_LATENCY_NS +
+                      i * (TEST_URGENT_LEN * sim_spim_byte_ns(NODI_SPIM_FREQ_8M) + TEST_LATENCY_NS));
+        }
+        wait_max = wait > wait_max ? wait : wait_max;
+    }
+
+    /* Preempted transaction releases CS at every urgent one. */
+    SIM_CHECK(test_dev_a.frames == (preemptible ? test_pushed + 1 : 1));
+    return wait_max;
+}
+
+int main(void)
+{
+    uint64_t wait_preempt = test_run(true);
+    uint64_t wait_hold = test_run(false);
+
+    printf("spim_lanes: urgent wait max %.1f us preemptible, %.1f us not preemptible, "
+           "%u chunks of %u us\n", (double)wait_preempt / 1000.0, (double)wait_hold / 1000.0,
+           TEST_LONG_CHUNKS, (uint32_t)(NODI_SPIM_MAXCNT * sim_spim_byte_ns(NODI_SPIM_FREQ_8M) / 1000));
+    return 0;
+}
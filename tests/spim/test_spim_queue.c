@@ -0,0 +1,397 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/* Queue ordering and callback delivery of nodi_spim_queue_push and the END handler,
+ * run against simulated SPIM and devices on simulated CS pins. */
+
+#include <stdio.h>
+#include <string.h>
+#include "nodi_spim.h"
+#include "sim.h"
+#include "sim_gpio.h"
+#include "sim_spim.h"
+
+#define TEST_CS_A_PIN         4
+#define TEST_CS_B_PIN         5
+#define TEST_DESC_MAX         200
+#define TEST_BUF_LEN          700
+#define TEST_DEV_FRAMES_MAX   256
+
+typedef struct {
+    sim_spi_dev_s             dev;
+    uint8_t                   mosi[TEST_DESC_MAX * TEST_BUF_LEN];
+    uint32_t                  mosi_n;
+    uint32_t                  frames;
+    uint32_t                  frame_len[TEST_DEV_FRAMES_MAX];
+} test_dev_s;
+
+static const nodi_gpio_pin_t test_cs_a = NODI_GPIO_PIN(NODI_GPIO_P0, TEST_CS_A_PIN);
+static const nodi_gpio_pin_t test_cs_b = NODI_GPIO_PIN(NODI_GPIO_P0, TEST_CS_B_PIN);
+
+static const nodi_spim_config_s test_spim_cfg = {
+    .sck_pin   = NODI_GPIO_PIN(NODI_GPIO_P0, 1),
+    .mosi_pin  = NODI_GPIO_PIN(NODI_GPIO_P0, 2),
+    .miso_pin  = NODI_GPIO_PIN(NODI_GPIO_P0, 3),
+    .frequency = NODI_SPIM_FREQ_8M,
+    .mode      = NODI_SPIM_MODE_0,
+    .bit_order = NODI_SPIM_BIT_ORDER_MSB_FIRST,
+    .orc       = 0xFF,
+};
+
+static const nodi_spim_dev_s test_bus_a = {
+    .cs_pin    = NODI_GPIO_PIN(NODI_GPIO_P0, TEST_CS_A_PIN),
+    .frequency = NODI_SPIM_FREQ_8M,
+    .mode      = NODI_SPIM_MODE_0,
+    .bit_order = NODI_SPIM_BIT_ORDER_MSB_FIRST,
+    .orc       = 0xFF,
+};
+
+static const nodi_spim_dev_s test_bus_b = {
+    .cs_pin    = NODI_GPIO_PIN(NODI_GPIO_P0, TEST_CS_B_PIN),
+    .frequency = NODI_SPIM_FREQ_1M,
+    .mode      = NODI_SPIM_MODE_3,
+    .bit_order = NODI_SPIM_BIT_ORDER_MSB_FIRST,
+    .orc       = 0x00,
+};
+
+static test_dev_s test_dev_a;
+static test_dev_s test_dev_b;
+static sim_spim_s *p_test_bus;
+
+static nodi_spim_xfer_desc_t test_descs[TEST_DESC_MAX];
+static uint8_t test_tx[TEST_DESC_MAX][TEST_BUF_LEN];
+static uint8_t test_rx[TEST_DESC_MAX][TEST_BUF_LEN];
+
+static uint32_t test_done[TEST_DESC_MAX * 4];
+static uint64_t test_done_t[TEST_DESC_MAX * 4];
+static uint32_t test_done_n;
+
+static uint64_t test_chunk_end[TEST_DESC_MAX * 8];
+static uint32_t test_chunk_n;
+
+static uint8_t test_dev_xfer(sim_spi_dev_s *p_dev, uint8_t mosi)
+{
+    test_dev_s *p_test_dev = (test_dev_s *)p_dev;
+
+    SIM_CHECK(p_test_dev->mosi_n < sizeof(p_test_dev->mosi));
+    p_test_dev->mosi[p_test_dev->mosi_n++] = mosi;
+    p_test_dev->frame_len[p_test_dev->frames - 1]++;
+    return (uint8_t)~mosi;
+}
+
+static void test_dev_cs(sim_spi_dev_s *p_dev, bool selected)
+{
+    test_dev_s *p_test_dev = (test_dev_s *)p_dev;
+
+    if (selected)
+    {
+        SIM_CHECK(p_test_dev->frames < TEST_DEV_FRAMES_MAX);
+        p_test_dev->frame_len[p_test_dev->frames++] = 0;
+    }
+}
+
+static void test_chunk_hook(void *p_ctx, const sim_spim_xfer_s *p_xfer)
+{
+    uint32_t n = p_xfer->n_tx > p_xfer->n_rx ? p_xfer->n_tx : p_xfer->n_rx;
+
+    SIM_CHECK(n <= NODI_SPIM_MAXCNT);
+    SIM_CHECK(p_xfer->selected <= 1);
+    test_chunk_end[test_chunk_n++] = p_xfer->t_end;
+}
+
+static void test_xfer_cb(nodi_spim_drv_t *p_spim_drv, nodi_spim_xfer_desc_t *p_desc)
+{
+    /* Delivered from interrupt routine, once, after the last byte of the transaction. */
+    SIM_CHECK(sim_in_isr());
+    SIM_CHECK(p_spim_drv == &NODI_SPIM0);
+    test_done[test_done_n] = (uint32_t)(uintptr_t)p_desc->p_context;
+    test_done_t[test_done_n] = sim_now();
+    test_done_n++;
+}
+
+static void test_setup(void)
+{
+    static const nodi_gpio_pin_t *cs_pins[] = { &test_cs_a, &test_cs_b };
+
+    sim_init();
+    p_test_bus = sim_spim_add(NRF_SPIM0);
+    p_test_bus->xfer_hook = test_chunk_hook;
+
+    /* Application configures GPIO, CS is inactive before it becomes output. */
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        nodi_gpio_set(cs_pins[i]->p_port, cs_pins[i]->pin);
+        nodi_gpio_config(cs_pins[i]->p_port, cs_pins[i]->pin, NODI_GPIO_CFG_SPI_CS);
+    }
+
+    memset(&test_dev_a, 0, sizeof(test_dev_a));
+    memset(&test_dev_b, 0, sizeof(test_dev_b));
+    test_dev_a.dev = (sim_spi_dev_s){ .cs_psel = TEST_CS_A_PIN, .cs_cb = test_dev_cs,
+                                      .xfer_cb = test_dev_xfer };
+    test_dev_b.dev = (sim_spi_dev_s){ .cs_psel = TEST_CS_B_PIN, .cs_cb = test_dev_cs,
+                                      .xfer_cb = test_dev_xfer };
+    sim_spim_dev_attach(p_test_bus, &test_dev_a.dev);
+    sim_spim_dev_attach(p_test_bus, &test_dev_b.dev);
+
+    nodi_spim_prepare();
+    NODI_SPIM0.config = &test_spim_cfg;
+    nodi_spim_init(&NODI_SPIM0);
+
+    memset(test_descs, 0, sizeof(test_descs));
+    test_done_n = 0;
+    test_chunk_n = 0;
+}
+
+static nodi_spim_xfer_desc_t *test_desc_get(uint32_t id, uint32_t len, uint8_t lane,
+                                            const nodi_gpio_pin_t *p_cs_pin)
+{
+    nodi_spim_xfer_desc_t *p_desc = &test_descs[id];
+
+    for (uint32_t i = 0; i < len; i++)
+    {
+        test_tx[id][i] = (uint8_t)(id * 31 + i);
+    }
+    memset(test_rx[id], 0, len);
+
+    p_desc->p_txbuf = test_tx[id];
+    p_desc->p_rxbuf = test_rx[id];
+    p_desc->n_tx = len;
+    p_desc->n_rx = len;
+    p_desc->p_cs_pin = p_cs_pin;
+    p_desc->lane = lane;
+    p_desc->xfer_cb = test_xfer_cb;
+    p_desc->p_context = (void *)(uintptr_t)id;
+    return p_desc;
+}
+
+static void test_rx_check(uint32_t id)
+{
+    nodi_spim_xfer_desc_t *p_desc = &test_descs[id];
+
+    for (uint32_t i = 0; i < p_desc->n_rx; i++)
+    {
+        SIM_CHECK((test_rx[id][i] ^ test_tx[id][i]) == 0xFF);
+    }
+}
+
+static void test_idle_check(void)
+{
+    SIM_CHECK(nodi_spim_queue_busy_check(&NODI_SPIM0) == 0);
+    SIM_CHECK(NODI_SPIM0.spim_state == NODI_SPIM_DRV_STATE_READY);
+    SIM_CHECK(!(NRF_SPIM0->INTENSET & SPIM_INTENSET_END_Msk));
+    SIM_CHECK(sim_gpio_level_get(TEST_CS_A_PIN) && sim_gpio_level_get(TEST_CS_B_PIN));
+    SIM_CHECK(p_test_bus->conflicts == 0);
+}
+
+/* Transactions of one lane are served in push order, each split into chunks. */
+static void test_fifo_order(void)
+{
+    static const uint32_t lens[] = { 1, 255, 256, 600, 17 };
+    const uint32_t count = sizeof(lens) / sizeof(lens[0]);
+    uint32_t chunks = 0;
+    uint32_t mosi_n = 0;
+
+    test_setup();
+    for (uint32_t id = 0; id < count; id++)
+    {
+        nodi_spim_queue_push(&NODI_SPIM0, test_desc_get(id, lens[id], NODI_SPIM_LANE_NORMAL, &test_cs_a));
+        chunks += (lens[id] + NODI_SPIM_MAXCNT - 1) / NODI_SPIM_MAXCNT;
+    }
+    SIM_CHECK(nodi_spim_queue_busy_check(&NODI_SPIM0) == 1);
+    sim_run(SIM_FOREVER);
+
+    SIM_CHECK(test_done_n == count);
+    SIM_CHECK(test_chunk_n == chunks);
+    SIM_CHECK(test_dev_a.frames == count);
+    SIM_CHECK(test_dev_b.frames == 0);
+    for (uint32_t id = 0; id < count; id++)
+    {
+        SIM_CHECK(test_done[id] == id);
+        SIM_CHECK(test_dev_a.frame_len[id] == lens[id]);
+        SIM_CHECK(memcmp(&test_dev_a.mosi[mosi_n], test_tx[id], lens[id]) == 0);
+        test_rx_check(id);
+        mosi_n += lens[id];
+    }
+
+    /* Callback follows the last chunk of its transaction without waiting for others. */
+    chunks = 0;
+    for (uint32_t id = 0; id < count; id++)
+    {
+        chunks += (lens[id] + NODI_SPIM_MAXCNT - 1) / NODI_SPIM_MAXCNT;
+        SIM_CHECK(test_done_t[id] == test_chunk_end[chunks - 1]);
+    }
+    test_idle_check();
+}
+
+static uint32_t test_repush_left;
+
+static void test_repush_cb(nodi_spim_drv_t *p_spim_drv, nodi_spim_xfer_desc_t *p_desc)
+{
+    test_xfer_cb(p_spim_drv, p_desc);
+    if (test_repush_left > 0)
+    {
+        test_repush_left--;
+        nodi_spim_queue_push(p_spim_drv, p_desc);
+    }
+}
+
+/* Descriptor belongs to the application in its callback and can be pushed again. */
+static void test_callback_repush(void)
+{
+    nodi_spim_xfer_desc_t *p_desc;
+
+    test_setup();
+    test_repush_left = 9;
+    p_desc = test_desc_get(0, 300, NODI_SPIM_LANE_NORMAL, &test_cs_a);
+    p_desc->xfer_cb = test_repush_cb;
+    nodi_spim_queue_push(&NODI_SPIM0, p_desc);
+    sim_run(SIM_FOREVER);
+
+    SIM_CHECK(test_done_n == 10);
+    SIM_CHECK(test_chunk_n == 20);
+    SIM_CHECK(test_dev_a.frames == 10);
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        SIM_CHECK(test_done[i] == 0);
+        SIM_CHECK(test_dev_a.frame_len[i] == 300);
+    }
+    test_idle_check();
+}
+
+static void test_push_event(void *p_ctx, uint32_t arg)
+{
+    nodi_spim_queue_push(&NODI_SPIM0, &test_descs[arg]);
+}
+
+/* Urgent lane goes first once the transaction on the bus is over. */
+static void test_lanes_order(void)
+{
+    static const uint32_t expected[] = { 0, 2, 4, 1, 3 };
+
+    test_setup();
+    nodi_spim_queue_push(&NODI_SPIM0, test_desc_get(0, 200, NODI_SPIM_LANE_NORMAL, &test_cs_a));
+    test_desc_get(1, 10, NODI_SPIM_LANE_NORMAL, &test_cs_a);
+    test_desc_get(2, 10, NODI_SPIM_LANE_URGENT, &test_cs_b);
+    test_desc_get(3, 10, NODI_SPIM_LANE_NORMAL, &test_cs_a);
+    test_desc_get(4, 10, NODI_SPIM_LANE_URGENT, &test_cs_b);
+    for (uint32_t id = 1; id < 5; id++)
+    {
+        sim_at(SIM_US(10 + id), test_push_event, NULL, id);
+    }
+    sim_run(SIM_FOREVER);
+
+    SIM_CHECK(test_done_n == 5);
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        SIM_CHECK(test_done[i] == expected[i]);
+        test_rx_check(expected[i]);
+    }
+    SIM_CHECK(test_dev_a.frames == 3);
+    SIM_CHECK(test_dev_b.frames == 2);
+    test_idle_check();
+}
+
+/* Frame held by CS keeps other devices off the bus. Bus settings follow the device. */
+static void test_cs_hold_frame(void)
+{
+    nodi_spim_xfer_desc_t *p_desc;
+    uint64_t t_b;
+
+    test_setup();
+    p_desc = test_desc_get(0, 4, NODI_SPIM_LANE_NORMAL, NULL);
+    p_desc->cs_hold = true;
+    nodi_spim_bus_push(&NODI_SPIM0, &test_bus_a, p_desc);
+    test_desc_get(1, 500, NODI_SPIM_LANE_NORMAL, NULL);
+    test_desc_get(2, 8, NODI_SPIM_LANE_URGENT, NULL);
+    test_descs[2].p_dev = &test_bus_b;
+    test_descs[2].p_cs_pin = &test_bus_b.cs_pin;
+    test_descs[1].p_dev = &test_bus_a;
+    test_descs[1].p_cs_pin = &test_bus_a.cs_pin;
+    sim_at(SIM_US(1), test_push_event, NULL, 2);
+    sim_at(SIM_US(2), test_push_event, NULL, 1);
+    sim_run(SIM_FOREVER);
+
+    SIM_CHECK(test_done_n == 3);
+    SIM_CHECK(test_done[0] == 0);
+    SIM_CHECK(test_done[1] == 1);
+    SIM_CHECK(test_done[2] == 2);
+    SIM_CHECK(test_dev_a.frames == 1);
+    SIM_CHECK(test_dev_a.frame_len[0] == 504);
+    SIM_CHECK(test_dev_b.frames == 1);
+    SIM_CHECK(NRF_SPIM0->FREQUENCY == NODI_SPIM_FREQ_1M);
+    SIM_CHECK(NRF_SPIM0->ORC == 0x00);
+
+    /* 8 bytes at 1 MHz. */
+    t_b = test_done_t[2] - test_done_t[1];
+    SIM_CHECK(t_b == 8 * sim_spim_byte_ns(NODI_SPIM_FREQ_1M));
+    test_idle_check();
+}
+
+/* Random pushes with random interrupt latency. Every descriptor is delivered once, in
+ * push order within its lane, and its data is intact. */
+static void test_random_pushes(void)
+{
+    uint32_t last[NODI_SPIM_LANE_COUNT] = { 0, 0 };
+    bool seen[TEST_DESC_MAX] = { false };
+    uint64_t t = 0;
+
+    test_setup();
+    sim_seed(0x5EED);
+    sim_irq_latency_max_ns = 3000;
+    for (uint32_t id = 0; id < TEST_DESC_MAX; id++)
+    {
+        uint8_t lane = (sim_rand() % 4 == 0) ? NODI_SPIM_LANE_URGENT : NODI_SPIM_LANE_NORMAL;
+        const nodi_gpio_pin_t *p_cs = (sim_rand() & 1) ? &test_cs_a : &test_cs_b;
+        test_desc_get(id, 1 + sim_rand() % (TEST_BUF_LEN - 1), lane, p_cs);
+        test_descs[id].cs_hold = false;
+        t += sim_rand() % SIM_US(300);
+        sim_at(t, test_push_event, NULL, id);
+    }
+    sim_run(SIM_FOREVER);
+
+    SIM_CHECK(test_done_n == TEST_DESC_MAX);
+    for (uint32_t i = 0; i < TEST_DESC_MAX; i++)
+    {
+        uint32_t id = test_done[i];
+        uint8_t lane = test_descs[id].lane;
+        SIM_CHECK(!seen[id]);
+        SIM_CHECK((last[lane] == 0) || (id > last[lane] - 1));
+        seen[id] = true;
+        last[lane] = id + 1;
+        test_rx_check(id);
+    }
+    SIM_CHECK(test_dev_a.frames + test_dev_b.frames == TEST_DESC_MAX);
+    test_idle_check();
+}
+
+int main(void)
+{
+    test_fifo_order();
+    test_callback_repush();
+    test_lanes_order();
+    test_cs_hold_frame();
+    test_random_pushes();
+    printf("spim_queue: %u random transactions, %u chunks\n", TEST_DESC_MAX, test_chunk_n);
+    return 0;
+}
@@ -0,0 +1,206 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/* Flow control setup of UARTE driver against simulated UARTE registers. With flow control
+ * RTS and CTS pins are connected, CONFIG.HWFC is set, CTS and NCTS interrupts reach the
+ * callback and transmission waits for CTS. Without it the pins stay disconnected and
+ * the CTS pin is ignored. */
+
+#include <stdio.h>
+#include <string.h>
+#include "nodi_uarte.h"
+#include "sim.h"
+#include "sim_gpio.h"
+#include "sim_uarte.h"
+
+#define TEST_RTS_PIN          5
+#define TEST_CTS_PIN          7
+#define TEST_PSEL_NC          0xFFFFFFFFUL
+#define TEST_TX_LEN           10
+#define TEST_NCTS_CYCLES      3
+#define TEST_CHAR_NS          SIM_US(10)
+#define TEST_CTS_EVENTS       (UARTE_INTENSET_CTS_Msk | UARTE_INTENSET_NCTS_Msk)
+
+static void test_cts_cb(nodi_uarte_drv_t *p_uarte_drv, bool cts);
+static void test_tx_end_cb(nodi_uarte_drv_t *p_uarte_drv);
+
+static const nodi_uarte_config_s test_cfg_hwfc = {
+    .tx_end_cb = test_tx_end_cb,
+    .rx_pin    = NODI_GPIO_PIN(NODI_GPIO_P0, 8),
+    .tx_pin    = NODI_GPIO_PIN(NODI_GPIO_P0, 6),
+    .rts_pin   = NODI_GPIO_PIN(NODI_GPIO_P0, TEST_RTS_PIN),
+    .cts_pin   = NODI_GPIO_PIN(NODI_GPIO_P0, TEST_CTS_PIN),
+    .hwfc      = NODI_UARTE_HWFC_ENABLED,
+    .cts_cb    = test_cts_cb,
+    .parity    = UARTE_CONFIG_PARITY_Included << UARTE_CONFIG_PARITY_Pos,
+    .baudrate  = NODI_UARTE_BAUD_1M,
+};
+
+static const nodi_uarte_config_s test_cfg_no_hwfc = {
+    .tx_end_cb = test_tx_end_cb,
+    .rx_pin    = NODI_GPIO_PIN(NODI_GPIO_P0, 8),
+    .tx_pin    = NODI_GPIO_PIN(NODI_GPIO_P0, 6),
+    .rts_pin   = NODI_GPIO_PIN(NODI_GPIO_P0, TEST_RTS_PIN),
+    .cts_pin   = NODI_GPIO_PIN(NODI_GPIO_P0, TEST_CTS_PIN),
+    .hwfc      = NODI_UARTE_HWFC_DISABLED,
+    .cts_cb    = test_cts_cb,
+    .parity    = UARTE_CONFIG_PARITY_Excluded,
+    .baudrate  = NODI_UARTE_BAUD_1M,
+};
+
+static uint8_t test_tx[TEST_TX_LEN] = "0123456789";
+static uint8_t test_line[TEST_TX_LEN];
+static uint32_t test_line_n;
+static uint32_t test_cts_n;
+static bool test_cts_last;
+static uint32_t test_tx_end_n;
+static sim_uarte_s *p_test_uarte;
+
+static void test_cts_cb(nodi_uarte_drv_t *p_uarte_drv, bool cts)
+{
+    SIM_CHECK(p_uarte_drv == &NODI_UARTE0);
+    test_cts_n++;
+    test_cts_last = cts;
+}
+
+static void test_tx_end_cb(nodi_uarte_drv_t *p_uarte_drv)
+{
+    test_tx_end_n++;
+}
+
+static void test_tx_hook(void *p_ctx, uint8_t byte)
+{
+    SIM_CHECK(test_line_n < TEST_TX_LEN);
+    test_line[test_line_n++] = byte;
+}
+
+static void test_setup(const nodi_uarte_config_s *p_cfg)
+{
+    sim_init();
+    p_test_uarte = sim_uarte_add(NRF_UARTE0);
+    p_test_uarte->tx_hook = test_tx_hook;
+
+    nodi_uarte_prepare();
+    NODI_UARTE0.config = p_cfg;
+    nodi_uarte_init(&NODI_UARTE0);
+
+    memset(test_line, 0, sizeof(test_line));
+    test_line_n = 0;
+    test_cts_n = 0;
+    test_cts_last = false;
+    test_tx_end_n = 0;
+}
+
+static void test_cts_release(void *p_ctx, uint32_t arg)
+{
+    sim_gpio_drive(TEST_CTS_PIN, false);
+}
+
+static void test_hwfc_enabled(void)
+{
+    NRF_UARTE_Type *p_reg = NRF_UARTE0;
+
+    test_setup(&test_cfg_hwfc);
+    SIM_CHECK(p_reg->PSEL.RTS == TEST_RTS_PIN);
+    SIM_CHECK(p_reg->PSEL.CTS == TEST_CTS_PIN);
+    SIM_CHECK((p_reg->CONFIG & UARTE_CONFIG_HWFC_Msk) == UARTE_CONFIG_HWFC_Msk);
+    SIM_CHECK((p_reg->CONFIG & UARTE_CONFIG_PARITY_Msk) == UARTE_CONFIG_PARITY_Msk);
+    SIM_CHECK((p_reg->INTENSET & TEST_CTS_EVENTS) == TEST_CTS_EVENTS);
+    SIM_CHECK(p_reg->ENABLE == UARTE_ENABLE_ENABLE_Enabled);
+
+    /* Peer is not ready, nothing leaves until CTS goes low. */
+    sim_gpio_drive(TEST_CTS_PIN, true);
+    nodi_uarte_send_start(&NODI_UARTE0, TEST_TX_LEN, test_tx);
+    sim_at(SIM_MS(1), test_cts_release, NULL, 0);
+    sim_run(SIM_MS(1) - 1);
+    SIM_CHECK(test_line_n == 0);
+    SIM_CHECK(test_tx_end_n == 0);
+    SIM_CHECK(nodi_uarte_send_busy_check(&NODI_UARTE0) == 1);
+
+    sim_run(SIM_FOREVER);
+    SIM_CHECK(test_cts_n == 1);
+    SIM_CHECK(test_cts_last);
+    SIM_CHECK(NODI_UARTE0.cts);
+    SIM_CHECK(test_line_n == TEST_TX_LEN);
+    SIM_CHECK(memcmp(test_line, test_tx, TEST_TX_LEN) == 0);
+    SIM_CHECK(test_tx_end_n == 1);
+    SIM_CHECK(nodi_uarte_send_busy_check(&NODI_UARTE0) == 0);
+
+    /* Every NCTS is counted and reported. */
+    for (uint32_t i = 1; i <= TEST_NCTS_CYCLES; i++)
+    {
+        sim_gpio_drive(TEST_CTS_PIN, true);
+        sim_run(SIM_FOREVER);
+        SIM_CHECK(!test_cts_last);
+        SIM_CHECK(nodi_uarte_ncts_count_get(&NODI_UARTE0) == i);
+
+        sim_gpio_drive(TEST_CTS_PIN, false);
+        sim_run(SIM_FOREVER);
+        SIM_CHECK(test_cts_last);
+    }
+    SIM_CHECK(test_cts_n == 1 + 2 * TEST_NCTS_CYCLES);
+
+    nodi_uarte_deinit(&NODI_UARTE0);
+    SIM_CHECK(p_reg->INTENSET == 0);
+    sim_gpio_release(TEST_CTS_PIN);
+}
+
+static void test_hwfc_disabled(void)
+{
+    NRF_UARTE_Type *p_reg = NRF_UARTE0;
+
+    test_setup(&test_cfg_no_hwfc);
+    SIM_CHECK(p_reg->PSEL.RTS == TEST_PSEL_NC);
+    SIM_CHECK(p_reg->PSEL.CTS == TEST_PSEL_NC);
+    SIM_CHECK((p_reg->CONFIG & UARTE_CONFIG_HWFC_Msk) == 0);
+    SIM_CHECK((p_reg->CONFIG & UARTE_CONFIG_PARITY_Msk) == 0);
+    SIM_CHECK((p_reg->INTENSET & TEST_CTS_EVENTS) == 0);
+
+    /* Level of the would-be CTS pin does not hold transmission. */
+    sim_gpio_drive(TEST_CTS_PIN, true);
+    nodi_uarte_send_start(&NODI_UARTE0, TEST_TX_LEN, test_tx);
+    sim_run(SIM_FOREVER);
+    SIM_CHECK(sim_now() <= (TEST_TX_LEN + 1) * TEST_CHAR_NS);
+    SIM_CHECK(test_line_n == TEST_TX_LEN);
+    SIM_CHECK(test_tx_end_n == 1);
+
+    sim_gpio_drive(TEST_CTS_PIN, false);
+    sim_run(SIM_FOREVER);
+    sim_gpio_drive(TEST_CTS_PIN, true);
+    sim_run(SIM_FOREVER);
+    SIM_CHECK(test_cts_n == 0);
+    SIM_CHECK(nodi_uarte_ncts_count_get(&NODI_UARTE0) == 0);
+
+    nodi_uarte_deinit(&NODI_UARTE0);
+    sim_gpio_release(TEST_CTS_PIN);
+}
+
+int main(void)
+{
+    test_hwfc_enabled();
+    test_hwfc_disabled();
+    printf("uarte_hwfc: RTS/CTS connected and %u NCTS counted with flow control, "
+           "disconnected without\n", TEST_NCTS_CYCLES);
+    return 0;
+}
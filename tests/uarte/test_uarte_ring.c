@@ -0,0 +1,237 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/* Continuous receive ring of UARTE driver against simulated UARTE fed with a byte every
+ * character time. Block counters start just below 2^32 to cross their wrap. Checks that
+ * no byte is lost while application keeps up, even with interrupt latency close to block
+ * time, and that a full ring drops whole blocks and counts them in lost. */
+
+#include <stdio.h>
+#include <string.h>
+#include "nodi_uarte.h"
+#include "sim.h"
+#include "sim_uarte.h"
+
+#define TEST_BLOCK_LEN        32
+#define TEST_BLOCK_COUNT      8
+#define TEST_BLOCKS           600
+#define TEST_TAIL_LEN         7
+#define TEST_CNT_START        0xFFFFFFF0UL
+#define TEST_CHAR_NS          SIM_US(10)
+#define TEST_BLOCK_NS         (TEST_BLOCK_LEN * TEST_CHAR_NS)
+#define TEST_SEQ_MOD          251
+
+typedef struct {
+    const char               *p_name;
+    uint32_t                  irq_latency_ns;  // Interrupt latency, 0..max
+    uint64_t                  drain_max_ns;    // Application looks at ring every 0..max ns
+    uint32_t                  stall_every;     // Every n-th drain is late, 0 for never
+    uint64_t                  stall_ns;        // Extra delay of late drain
+} test_scenario_s;
+
+static const nodi_uarte_config_s test_uarte_cfg = {
+    .rx_pin   = NODI_GPIO_PIN(NODI_GPIO_P0, 8),
+    .tx_pin   = NODI_GPIO_PIN(NODI_GPIO_P0, 6),
+    .rts_pin  = NODI_GPIO_PIN(NODI_GPIO_P0, 5),
+    .cts_pin  = NODI_GPIO_PIN(NODI_GPIO_P0, 7),
+    .hwfc     = NODI_UARTE_HWFC_DISABLED,
+    .parity   = UARTE_CONFIG_PARITY_Excluded,
+    .baudrate = NODI_UARTE_BAUD_1M,
+};
+
+static uint8_t test_mem[TEST_BLOCK_COUNT * TEST_BLOCK_LEN];
+static uint16_t test_amounts[TEST_BLOCK_COUNT];
+static nodi_uarte_rx_ring_s test_ring;
+static sim_uarte_s *p_test_uarte;
+static const test_scenario_s *p_test_sc;
+
+static uint32_t test_sent;
+static uint32_t test_total;
+static uint32_t test_got;
+static uint32_t test_blocks;
+static uint32_t test_gaps;
+static uint32_t test_stalls;
+static uint32_t test_drains;
+static uint32_t test_last_len;
+static uint8_t test_next;
+static bool test_stopped;
+
+/* Takes every completed block, its bytes have to continue the sequence. */
+static void test_drain_all(void)
+{
+    const uint8_t *p_data;
+
+    while (test_ring.rd != test_ring.wr)
+    {
+        uint32_t n = nodi_uarte_rx_ring_get(&NODI_UARTE0, &p_data);
+
+        SIM_CHECK(n <= TEST_BLOCK_LEN);
+        if ((n != 0) && (p_data[0] != test_next))
+        {
+            test_gaps++;
+            test_next = p_data[0];
+        }
+        for (uint32_t i = 0; i < n; i++)
+        {
+            SIM_CHECK(p_data[i] == test_next);
+            test_next = (test_next + 1) % TEST_SEQ_MOD;
+        }
+        test_got += n;
+        test_blocks++;
+        test_last_len = n;
+        nodi_uarte_rx_ring_release(&NODI_UARTE0);
+    }
+}
+
+static void test_drain(void *p_ctx, uint32_t arg)
+{
+    uint64_t delay = sim_rand() % p_test_sc->drain_max_ns;
+
+    test_drain_all();
+    if (test_stopped)
+    {
+        return;
+    }
+
+    test_drains++;
+    if ((p_test_sc->stall_every != 0) && (test_drains % p_test_sc->stall_every == 0) &&
+        (test_sent + (p_test_sc->stall_ns / TEST_CHAR_NS) < test_total))
+    {
+        test_stalls++;
+        delay += p_test_sc->stall_ns;
+    }
+    sim_at(sim_now() + delay, test_drain, NULL, 0);
+}
+
+static void test_stop(void *p_ctx, uint32_t arg)
+{
+    test_stopped = true;
+    nodi_uarte_rx_ring_stop(&NODI_UARTE0);
+}
+
+static void test_feed(void *p_ctx, uint32_t arg)
+{
+    sim_uarte_rx_byte(p_test_uarte, test_sent % TEST_SEQ_MOD, 0);
+    test_sent++;
+    if (test_sent < test_total)
+    {
+        sim_at(sim_now() + TEST_CHAR_NS, test_feed, NULL, 0);
+    }
+    else
+    {
+        /* Tail is a partial block. Stop after line is idle for a block time, so the
+         * previous ENDRX is handled before STOPRX ends the tail. */
+        sim_at(sim_now() + TEST_BLOCK_NS, test_stop, NULL, 0);
+    }
+}
+
+static void test_run(const test_scenario_s *p_sc, uint32_t seed)
+{
+    p_test_sc = p_sc;
+    sim_init();
+    sim_seed(seed);
+    sim_irq_latency_max_ns = p_sc->irq_latency_ns;
+    p_test_uarte = sim_uarte_add(NRF_UARTE0);
+
+    nodi_uarte_prepare();
+    NODI_UARTE0.config = &test_uarte_cfg;
+    nodi_uarte_init(&NODI_UARTE0);
+    SIM_CHECK(sim_uarte_char_ns(p_test_uarte) == TEST_CHAR_NS);
+
+    test_sent = 0;
+    test_total = TEST_BLOCKS * TEST_BLOCK_LEN + TEST_TAIL_LEN;
+    test_got = 0;
+    test_blocks = 0;
+    test_gaps = 0;
+    test_stalls = 0;
+    test_drains = 0;
+    test_last_len = 0;
+    test_next = 0;
+    test_stopped = false;
+
+    test_ring = (nodi_uarte_rx_ring_s){
+        .p_mem       = test_mem,
+        .p_amounts   = test_amounts,
+        .block_len   = TEST_BLOCK_LEN,
+        .block_count = TEST_BLOCK_COUNT,
+    };
+    nodi_uarte_rx_ring_start(&NODI_UARTE0, &test_ring);
+
+    /* Interrupt routine has not run yet, counters continue from here. */
+    test_ring.wr = TEST_CNT_START;
+    test_ring.rd = TEST_CNT_START;
+
+    sim_at(TEST_CHAR_NS, test_feed, NULL, 0);
+    sim_at(TEST_CHAR_NS, test_drain, NULL, 0);
+    sim_run(SIM_FOREVER);
+    test_drain_all();
+
+    SIM_CHECK(test_sent == test_total);
+    SIM_CHECK(test_got + test_ring.lost == test_sent);
+    SIM_CHECK(test_ring.wr < TEST_CNT_START);
+    SIM_CHECK(test_last_len == TEST_TAIL_LEN);
+    SIM_CHECK(p_test_uarte->overruns == 0);
+    SIM_CHECK(p_test_uarte->rx_off == 0);
+    SIM_CHECK(NODI_UARTE0.uarte_rx_state == NODI_UARTE_DRV_STATE_READY);
+    SIM_CHECK(nodi_uarte_rx_ring_get(&NODI_UARTE0, &(const uint8_t *){ NULL }) == 0);
+
+    if (p_sc->stall_every == 0)
+    {
+        SIM_CHECK(test_ring.lost == 0);
+        SIM_CHECK(test_gaps == 0);
+        SIM_CHECK(test_blocks == TEST_BLOCKS + 1);
+    }
+    else
+    {
+        /* Full ring drops whole blocks, one run of them per stall. */
+        SIM_CHECK(test_stalls != 0);
+        SIM_CHECK(test_gaps == test_stalls);
+        SIM_CHECK(test_ring.lost % TEST_BLOCK_LEN == 0);
+    }
+}
+
+int main(void)
+{
+    static const test_scenario_s scenarios[] = {
+        { "steady",  SIM_US(5),                        SIM_US(600), 0,  0 },
+        { "latency", TEST_BLOCK_NS - SIM_US(40),       SIM_US(600), 0,  0 },
+        { "drop",    SIM_US(20),                       SIM_US(600), 40, SIM_MS(5) },
+    };
+    uint32_t lost = 0;
+    uint32_t stalls = 0;
+
+    for (uint32_t sc = 0; sc < sizeof(scenarios) / sizeof(scenarios[0]); sc++)
+    {
+        for (uint32_t seed = 1; seed <= 10; seed++)
+        {
+            test_run(&scenarios[sc], seed * 7919 + sc);
+            lost += test_ring.lost;
+            stalls += test_stalls;
+        }
+    }
+    printf("uarte_ring: %u blocks across counter wrap, %u B dropped in %u stalls, "
+           "interrupt latency up to %.0f us\n", TEST_BLOCKS + 1, lost, stalls,
+           (double)scenarios[1].irq_latency_ns / 1000.0);
+    return 0;
+}
@@ -0,0 +1,204 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Karol Lasonczyk (kl-cruz - https://github.com/kl-cruz)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/* Sleep mode of UARTE driver against simulated UARTE, TIMERs and GPIO SENSE. Packets
+ * wake receiver through PORT event, idle line ends every packet and receiver goes back
+ * to sleep by itself, stopped between packets. Checks wake latency reported from TIMER
+ * capture and that a callback starting another receive ends sleep mode. */
+
+#include <stdio.h>
+#include <string.h>
+#include "nodi_uarte.h"
+#include "sim.h"
+#include "sim_gpio.h"
+#include "sim_timer.h"
+#include "sim_uarte.h"
+
+#define TEST_RX_PIN           8
+#define TEST_BUF_LEN          64
+#define TEST_PACKETS          20
+#define TEST_PACKET_MAX       48
+#define TEST_CHAR_NS          SIM_US(10)
+#define TEST_STARTUP_NS       SIM_US(5)
+#define TEST_TIMEOUT_CHARS    4
+
+static void test_rx_end_cb(nodi_uarte_drv_t *p_uarte_drv);
+
+static const nodi_uarte_idle_config_s test_idle_cfg = {
+    .p_count_timer_reg = NRF_TIMER1,
+    .p_idle_timer_reg  = NRF_TIMER2,
+    .ppi_ch_count      = 0,
+    .ppi_ch_restart    = 1,
+    .ppi_ch_timeout    = 2,
+    .timeout_chars     = TEST_TIMEOUT_CHARS,
+};
+
+static const nodi_uarte_wake_config_s test_wake_cfg = {
+    .p_timer_reg    = NRF_TIMER3,
+    .ppi_ch_wake    = 3,
+    .ppi_ch_started = 4,
+    .ppi_group      = 0,
+};
+
+static const nodi_uarte_config_s test_uarte_cfg = {
+    .rx_end_cb  = test_rx_end_cb,
+    .rx_pin     = NODI_GPIO_PIN(NODI_GPIO_P0, TEST_RX_PIN),
+    .tx_pin     = NODI_GPIO_PIN(NODI_GPIO_P0, 6),
+    .hwfc       = NODI_UARTE_HWFC_DISABLED,
+    .p_wake_cfg = &test_wake_cfg,
+    .parity     = UARTE_CONFIG_PARITY_Excluded,
+    .baudrate   = NODI_UARTE_BAUD_1M,
+    .p_idle_cfg = &test_idle_cfg,
+};
+
+static uint8_t test_buf[TEST_BUF_LEN];
+static uint8_t test_next_buf[TEST_BUF_LEN];
+static uint32_t test_len[TEST_PACKETS];
+static uint32_t test_got[TEST_PACKETS];
+static uint32_t test_packet;
+static uint32_t test_done;
+static bool test_leave;
+static sim_uarte_s *p_test_uarte;
+
+static uint8_t test_byte(uint32_t packet, uint32_t i)
+{
+    return (uint8_t)(packet * 31 + i);
+}
+
+static bool test_sense_armed(void)
+{
+    return ((NRF_P0->PIN_CNF[TEST_RX_PIN] & GPIO_PIN_CNF_SENSE_Msk) >> GPIO_PIN_CNF_SENSE_Pos) ==
+           GPIO_PIN_CNF_SENSE_Low;
+}
+
+static void test_rx_end_cb(nodi_uarte_drv_t *p_uarte_drv)
+{
+    uint32_t n = nodi_uarte_rx_amount_get(p_uarte_drv);
+
+    SIM_CHECK(test_done < TEST_PACKETS);
+    SIM_CHECK(n == test_len[test_done]);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        SIM_CHECK(test_buf[i] == test_byte(test_done, i));
+    }
+    test_got[test_done++] = n;
+
+    if (test_leave)
+    {
+        nodi_uarte_receive_idle_start(p_uarte_drv, TEST_BUF_LEN, test_next_buf);
+    }
+}
+
+/* Start bit pulls RX low, line is released after the last character. */
+static void test_line(void *p_ctx, uint32_t level)
+{
+    if (level)
+    {
+        sim_gpio_release(TEST_RX_PIN);
+    }
+    else
+    {
+        sim_gpio_drive(TEST_RX_PIN, false);
+    }
+}
+
+static void test_char(void *p_ctx, uint32_t i)
+{
+    sim_uarte_rx_byte(p_test_uarte, test_byte(test_packet, i), 0);
+}
+
+static void test_packet_send(uint32_t packet)
+{
+    uint64_t t = sim_now();
+
+    test_packet = packet;
+    sim_at(t, test_line, NULL, 0);
+    for (uint32_t i = 0; i < test_len[packet]; i++)
+    {
+        sim_at(t + (i + 1) * TEST_CHAR_NS, test_char, NULL, i);
+    }
+    sim_at(t + test_len[packet] * TEST_CHAR_NS + TEST_CHAR_NS / 2, test_line, NULL, 1);
+}
+
+static void test_setup(void)
+{
+    sim_init();
+    sim_seed(11);
+    sim_irq_latency_max_ns = SIM_US(3);
+    p_test_uarte = sim_uarte_add(NRF_UARTE0);
+    p_test_uarte->startrx_ns = TEST_STARTUP_NS;
+    sim_timer_add(NRF_TIMER1);
+    sim_timer_add(NRF_TIMER2);
+    sim_timer_add(NRF_TIMER3);
+
+    nodi_uarte_prepare();
+    NODI_UARTE0.config = &test_uarte_cfg;
+    nodi_uarte_init(&NODI_UARTE0);
+
+    memset(test_got, 0, sizeof(test_got));
+    test_done = 0;
+    test_leave = false;
+    for (uint32_t i = 0; i < TEST_PACKETS; i++)
+    {
+        test_len[i] = 1 + sim_rand() % TEST_PACKET_MAX;
+    }
+}
+
+static void test_sleep_cycles(void)
+{
+    test_setup();
+    nodi_uarte_sleep(&NODI_UARTE0, TEST_BUF_LEN, test_buf);
+
+    for (uint32_t packet = 0; packet < TEST_PACKETS; packet++)
+    {
+        /* Receiver is stopped and waits for the edge. */
+        SIM_CHECK(!p_test_uarte->rx_on);
+        SIM_CHECK(NODI_UARTE0.wake_armed);
+        SIM_CHECK(test_sense_armed());
+
+        test_leave = (packet == TEST_PACKETS - 1);
+        test_packet_send(packet);
+        sim_run(SIM_FOREVER);
+
+        SIM_CHECK(test_done == packet + 1);
+        SIM_CHECK(NODI_UARTE0.wake_count == packet + 1);
+        SIM_CHECK(nodi_uarte_wake_latency_get(&NODI_UARTE0) == TEST_STARTUP_NS);
+    }
+
+    /* The last callback started receive without sleep. */
+    SIM_CHECK(!NODI_UARTE0.wake_armed);
+    SIM_CHECK(!test_sense_armed());
+    SIM_CHECK(p_test_uarte->rx_on);
+    SIM_CHECK(NODI_UARTE0.uarte_rx_state == NODI_UARTE_DRV_STATE_BUSY);
+    SIM_CHECK(p_test_uarte->overruns == 0);
+    SIM_CHECK(p_test_uarte->rx_off == 0);
+}
+
+int main(void)
+{
+    test_sleep_cycles();
+    printf("uarte_sleep: %u packets woke receiver, rearmed after idle line, wake latency "
+           "%.1f us\n", TEST_PACKETS, (double)nodi_uarte_wake_latency_get(&NODI_UARTE0) / 1000.0);
+    return 0;
+}